@@ -0,0 +1,62 @@
+#include "input_script.h"
+
+#include "../../src/util/log.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+static auto parse_button(const std::string& name, GbButton& button) -> bool {
+    if (name == "up") { button = GbButton::Up; }
+    else if (name == "down") { button = GbButton::Down; }
+    else if (name == "left") { button = GbButton::Left; }
+    else if (name == "right") { button = GbButton::Right; }
+    else if (name == "a") { button = GbButton::A; }
+    else if (name == "b") { button = GbButton::B; }
+    else if (name == "select") { button = GbButton::Select; }
+    else if (name == "start") { button = GbButton::Start; }
+    else { return false; }
+
+    return true;
+}
+
+auto read_input_script(const std::string& filename) -> std::vector<InputEvent> {
+    std::ifstream file(filename);
+    if (!file) { fatal_error("Unable to open input script %s", filename.c_str()); }
+
+    std::vector<InputEvent> events;
+    std::string line;
+    uint line_number = 0;
+
+    while (std::getline(file, line)) {
+        line_number++;
+
+        line = line.substr(0, line.find('#'));
+        std::istringstream words(line);
+
+        std::string frame, action, button_name;
+        if (!(words >> frame)) { continue; }
+
+        InputEvent event;
+        char* frame_end;
+        event.frame = std::strtoull(frame.c_str(), &frame_end, 10);
+
+        bool valid = *frame_end == '\0'
+            && (words >> action >> button_name)
+            && (action == "press" || action == "release")
+            && parse_button(button_name, event.button);
+
+        if (!valid) {
+            fatal_error("%s:%u: expected '<frame> press|release <button>'", filename.c_str(), line_number);
+        }
+
+        event.pressed = action == "press";
+        events.push_back(event);
+    }
+
+    std::stable_sort(events.begin(), events.end(),
+                     [](const InputEvent& a, const InputEvent& b) { return a.frame < b.frame; });
+
+    return events;
+}
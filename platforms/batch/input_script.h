@@ -0,0 +1,25 @@
+#pragma once
+
+#include "../../src/input.h"
+#include "../../src/definitions.h"
+
+#include <string>
+#include <vector>
+
+struct InputEvent {
+    u64 frame;
+    GbButton button;
+    bool pressed;
+};
+
+/*
+ * Reads a list of button presses to play into a game, one per line:
+ *
+ *     # frame  action   button
+ *     120      press    start
+ *     126      release  start
+ *
+ * where the button is one of up, down, left, right, a, b, select or start.
+ * Events come back in frame order.
+ */
+auto read_input_script(const std::string& filename) -> std::vector<InputEvent>;
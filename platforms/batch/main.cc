@@ -0,0 +1,221 @@
+#include "../../src/gameboy_prelude.h"
+#include "../cli/cli.h"
+#include "input_script.h"
+#include "thread_pool.h"
+
+#include <chrono>
+#include <thread>
+
+using batch_clock = std::chrono::steady_clock;
+
+struct Instance {
+    std::string rom_name;
+    rom_t rom;
+    std::string script_name;
+    const std::vector<InputEvent>* script;
+
+    /* Filled in once it has run */
+    std::string result;
+    std::string fault;
+    u64 frames = 0;
+    double seconds = 0;
+};
+
+struct BatchOptions {
+    Options options;
+    std::vector<std::string> rom_files;
+    std::vector<std::string> script_files;
+    std::vector<std::string> until;
+    u64 frame_limit = 18000;
+    uint threads = 0;
+};
+
+static auto base_name(const std::string& path) -> std::string {
+    return path.substr(path.find_last_of('/') + 1);
+}
+
+static auto parse_count(const std::string& flag, const std::string& prefix) -> u64 {
+    char* end;
+    u64 count = std::strtoull(flag.c_str() + prefix.size(), &end, 10);
+    if (*end != '\0' || count == 0) { fatal_error("Invalid count: %s", flag.c_str()); }
+    return count;
+}
+
+static auto get_batch_options(int argc, char* argv[]) -> BatchOptions {
+    BatchOptions batch;
+    std::vector<std::string> args(argv + 1, argv + argc);
+
+    for (const std::string& arg : args) {
+        if (arg.rfind("--", 0) != 0) { batch.rom_files.push_back(arg); }
+        else if (arg.rfind("--input-script=", 0) == 0) {
+            batch.script_files.push_back(arg.substr(std::string("--input-script=").size()));
+        }
+        else if (arg.rfind("--until=", 0) == 0) {
+            batch.until.push_back(arg.substr(std::string("--until=").size()));
+        }
+        else if (arg.rfind("--frames=", 0) == 0) { batch.frame_limit = parse_count(arg, "--frames="); }
+        else if (arg.rfind("--threads=", 0) == 0) {
+            batch.threads = static_cast<uint>(parse_count(arg, "--threads="));
+        }
+        else if (!parse_option_flag(batch.options, arg)) {
+            fatal_error("Unknown flag: %s", arg.c_str());
+        }
+    }
+
+    if (batch.rom_files.empty()) {
+        fatal_error("usage: gbemu-batch <rom_file>... [--input-script=<file>]... [--until=<text>]... "
+                    "[--frames=<n>] [--threads=<n>] [emulator flags]");
+    }
+
+    /* Anything which would reach outside its own instance: the debugger reads
+     * from stdin, and the rest would share stdout or a file */
+    Options& options = batch.options;
+    if (options.debugger || options.trace || options.print_serial || !options.audio_dump_path.empty()) {
+        fatal_error("--debug, --trace, --print-serial and --audio-dump aren't supported by gbemu-batch");
+    }
+
+    /* Nothing plays the audio, and the serial output is checked for --until */
+    options.disable_audio = true;
+    options.capture_serial = true;
+    options.disable_logs = true;
+
+    if (batch.threads == 0) { batch.threads = std::max(std::thread::hardware_concurrency(), 1u); }
+
+    return batch;
+}
+
+static void run_instance(Instance& instance, const BatchOptions& batch) {
+    /* Each instance has its own options, so that nothing is shared between
+     * them but the ROM */
+    Options options = batch.options;
+    Gameboy gameboy(instance.rom, options);
+
+    const std::vector<InputEvent>& events = *instance.script;
+    size_t next_event = 0;
+    u64 checked_frame = ~0ull;
+
+    auto matched_text = [&]() -> const std::string* {
+        const std::string& serial = gameboy.get_serial_output();
+        for (const std::string& text : batch.until) {
+            if (serial.find(text) != std::string::npos) { return &text; }
+        }
+        return nullptr;
+    };
+
+    auto should_close = [&]() {
+        u64 frame = gameboy.get_frame_count();
+        if (frame == checked_frame) { return false; }
+        checked_frame = frame;
+
+        while (next_event < events.size() && events[next_event].frame <= frame) {
+            const InputEvent& event = events[next_event++];
+            if (event.pressed) {
+                gameboy.button_pressed(event.button);
+            } else {
+                gameboy.button_released(event.button);
+            }
+        }
+
+        return matched_text() != nullptr || frame >= batch.frame_limit;
+    };
+
+    auto start = batch_clock::now();
+    RunResult result = gameboy.run(should_close, [](const FrameBuffer& buffer, bool changed) {});
+
+    instance.seconds = std::chrono::duration<double>(batch_clock::now() - start).count();
+    instance.frames = gameboy.get_frame_count();
+
+    /* A test ROM may well print its result and then loop forever */
+    const std::string* matched = matched_text();
+
+    if (result == RunResult::Fault) {
+        instance.result = "fault";
+        instance.fault = gameboy.get_fault();
+    } else if (matched != nullptr) {
+        instance.result = *matched;
+    } else if (result == RunResult::InfiniteLoop) {
+        instance.result = "infinite loop";
+    } else {
+        instance.result = "frame limit";
+    }
+}
+
+/* Returns whether any instance faulted */
+static auto report(const std::vector<Instance>& instances, const BatchOptions& batch, double seconds) -> bool {
+    const double real_frame_rate = static_cast<double>(CLOCK_RATE) / CLOCKS_PER_FRAME;
+
+    printf("%-32s %-20s %-16s %10s %9s %10s\n", "rom", "script", "result", "frames", "seconds", "frames/s");
+
+    u64 total_frames = 0;
+    bool any_faulted = false;
+    for (const Instance& instance : instances) {
+        printf("%-32s %-20s %-16s %10llu %9.2f %10.0f\n",
+               instance.rom_name.c_str(), instance.script_name.c_str(), instance.result.c_str(),
+               static_cast<unsigned long long>(instance.frames), instance.seconds,
+               instance.seconds > 0 ? static_cast<double>(instance.frames) / instance.seconds : 0);
+
+        if (!instance.fault.empty()) {
+            printf("    %s\n", instance.fault.c_str());
+            any_faulted = true;
+        }
+
+        total_frames += instance.frames;
+    }
+
+    double frames_per_second = static_cast<double>(total_frames) / seconds;
+    printf("\n%zu instances on %u threads: %llu frames in %.2fs, %.0f frames/s (%.1fx real time)\n",
+           instances.size(), batch.threads, static_cast<unsigned long long>(total_frames), seconds,
+           frames_per_second, frames_per_second / real_frame_rate);
+
+    return any_faulted;
+}
+
+/* Runs many instances of the emulator at once, one per ROM and input script */
+int main(int argc, char* argv[]) {
+    BatchOptions batch = get_batch_options(argc, argv);
+
+    std::vector<rom_t> roms;
+    for (const std::string& file : batch.rom_files) {
+        roms.push_back(std::make_shared<const std::vector<u8>>(read_file(file)));
+    }
+
+    std::vector<std::vector<InputEvent>> scripts;
+    for (const std::string& file : batch.script_files) {
+        scripts.push_back(read_input_script(file));
+    }
+
+    /* Without any scripts, each ROM runs once with no input */
+    static const std::vector<InputEvent> no_input;
+
+    std::vector<Instance> instances;
+    auto add_instance = [&](size_t rom, const std::string& script_name, const std::vector<InputEvent>* script) {
+        Instance instance;
+        instance.rom_name = base_name(batch.rom_files[rom]);
+        instance.rom = roms[rom];
+        instance.script_name = script_name;
+        instance.script = script;
+        instances.push_back(instance);
+    };
+
+    for (size_t i = 0; i < roms.size(); i++) {
+        if (scripts.empty()) { add_instance(i, "-", &no_input); }
+
+        for (size_t j = 0; j < scripts.size(); j++) {
+            add_instance(i, base_name(batch.script_files[j]), &scripts[j]);
+        }
+    }
+
+    std::vector<job_t> jobs;
+    for (Instance& instance : instances) {
+        jobs.push_back([&instance, &batch]() { run_instance(instance, batch); });
+    }
+
+    ThreadPool pool(batch.threads);
+
+    auto start = batch_clock::now();
+    pool.run(std::move(jobs));
+    double seconds = std::chrono::duration<double>(batch_clock::now() - start).count();
+
+    bool any_faulted = report(instances, batch, seconds);
+    return any_faulted ? 1 : 0;
+}
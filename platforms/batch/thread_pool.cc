@@ -0,0 +1,85 @@
+#include "thread_pool.h"
+
+#include "../../src/util/log.h"
+
+#include <algorithm>
+#include <thread>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+static void pin_to_core(std::thread& thread, uint core) {
+#if defined(__linux__)
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(core, &cpus);
+
+    if (pthread_setaffinity_np(thread.native_handle(), sizeof(cpus), &cpus) != 0) {
+        log_warn("Unable to pin a thread to core %u", core);
+    }
+#else
+    unused(thread, core);
+#endif
+}
+
+ThreadPool::ThreadPool(uint inThreadCount) {
+    for (uint i = 0; i < inThreadCount; i++) {
+        queues.push_back(std::make_unique<Queue>());
+    }
+}
+
+void ThreadPool::run(std::vector<job_t> jobs) {
+    for (size_t i = 0; i < jobs.size(); i++) {
+        queues[i % queues.size()]->jobs.push_back(std::move(jobs[i]));
+    }
+
+    uint cores = std::max(std::thread::hardware_concurrency(), 1u);
+
+    std::vector<std::thread> threads;
+    for (uint i = 0; i < thread_count(); i++) {
+        threads.emplace_back(&ThreadPool::work, this, i);
+        pin_to_core(threads.back(), i % cores);
+    }
+
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+void ThreadPool::work(uint index) {
+    job_t job;
+
+    /* No jobs are added once the threads have started, so when there is
+     * nothing left to take or steal, the batch is done */
+    while (take(index, job) || steal(index, job)) {
+        job();
+    }
+}
+
+auto ThreadPool::take(uint index, job_t& job) -> bool {
+    Queue& queue = *queues[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+
+    if (queue.jobs.empty()) { return false; }
+
+    job = std::move(queue.jobs.front());
+    queue.jobs.pop_front();
+    return true;
+}
+
+auto ThreadPool::steal(uint thief, job_t& job) -> bool {
+    for (uint i = 1; i < thread_count(); i++) {
+        Queue& queue = *queues[(thief + i) % thread_count()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+
+        if (queue.jobs.empty()) { continue; }
+
+        job = std::move(queue.jobs.back());
+        queue.jobs.pop_back();
+        return true;
+    }
+
+    return false;
+}
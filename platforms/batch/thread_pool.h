@@ -0,0 +1,42 @@
+#pragma once
+
+#include "../../src/definitions.h"
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using job_t = std::function<void()>;
+
+/*
+ * Runs a batch of jobs on a thread per core, each pinned to its own core
+ * where the host allows it.
+ *
+ * Jobs are dealt out to the threads up front. Each thread works from the
+ * front of its own queue and, once that is empty, steals from the back of
+ * the others', so a few long jobs don't leave the rest of the cores idle.
+ */
+class ThreadPool {
+public:
+    ThreadPool(uint inThreadCount);
+
+    /* Returns once every job has finished */
+    void run(std::vector<job_t> jobs);
+
+    auto thread_count() const -> uint { return static_cast<uint>(queues.size()); }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<job_t> jobs;
+    };
+
+    void work(uint index);
+
+    auto take(uint index, job_t& job) -> bool;
+    auto steal(uint thief, job_t& job) -> bool;
+
+    std::vector<std::unique_ptr<Queue>> queues;
+};
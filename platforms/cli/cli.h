@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../../src/options.h"
+#include "../../src/util/files.h"
 #include <vector>
 
 struct CliOptions {
@@ -8,6 +9,68 @@ struct CliOptions {
     std::string filename;
 };
 
+/* Applies one of the flags which configure the emulator. Returns false if
+ * `flag` isn't one of them */
+auto parse_option_flag(Options& options, const std::string& flag) -> bool;
+auto parse_option_flag(Options& options, const std::string& flag) -> bool {
+    if (flag == "--debug") { options.debugger = true; }
+    else if (flag == "--trace") { options.trace = true; }
+    else if (flag == "--silent") { options.disable_logs = true; }
+    else if (flag == "--headless") { options.headless = true; }
+    else if (flag == "--whole-framebuffer") { options.show_full_framebuffer = true; }
+    else if (flag == "--exit-on-infinite-jr") { options.exit_on_infinite_jr = true; }
+    else if (flag == "--print-serial") { options.print_serial = true; }
+    else if (flag == "--cached-interpreter") { options.cpu_engine = CPUEngine::CachedInterpreter; }
+    else if (flag == "--jit") { options.cpu_engine = CPUEngine::JIT; }
+    else if (flag.rfind("--trace-file=", 0) == 0) {
+        options.trace_path = flag.substr(std::string("--trace-file=").size());
+    }
+    else if (flag == "--skip-idle-loops") { options.skip_idle_loops = true; }
+    else if (flag.rfind("--frame-skip=", 0) == 0) {
+        int frame_skip = std::atoi(flag.substr(std::string("--frame-skip=").size()).c_str());
+        if (frame_skip < 1) { fatal_error("Invalid frame skip: %s", flag.c_str()); }
+        options.frame_skip = static_cast<uint>(frame_skip);
+    }
+    else if (flag == "--no-render") { options.disable_rendering = true; }
+    else if (flag == "--render-thread") { options.render_thread = true; }
+    else if (flag == "--no-audio") { options.disable_audio = true; }
+    else if (flag.rfind("--audio-dump=", 0) == 0) {
+        options.audio_dump_path = flag.substr(std::string("--audio-dump=").size());
+    }
+    else if (flag.rfind("--rewind=", 0) == 0) {
+        int megabytes = std::atoi(flag.substr(std::string("--rewind=").size()).c_str());
+        if (megabytes < 1) { fatal_error("Invalid rewind buffer size: %s", flag.c_str()); }
+        options.rewind_buffer_size = static_cast<size_t>(megabytes) * 1024 * 1024;
+    }
+    else if (flag.rfind("--rewind-interval=", 0) == 0) {
+        int interval = std::atoi(flag.substr(std::string("--rewind-interval=").size()).c_str());
+        if (interval < 1) { fatal_error("Invalid rewind interval: %s", flag.c_str()); }
+        options.rewind_interval = static_cast<uint>(interval);
+    }
+    else if (flag.rfind("--run-ahead=", 0) == 0) {
+        int frames = std::atoi(flag.substr(std::string("--run-ahead=").size()).c_str());
+        if (frames < 0) { fatal_error("Invalid run-ahead: %s", flag.c_str()); }
+        options.run_ahead_frames = static_cast<uint>(frames);
+    }
+    else if (flag == "--jit-validate") {
+        options.cpu_engine = CPUEngine::JIT;
+        options.jit_validate = true;
+    }
+    else { return false; }
+
+    return true;
+}
+
+/* A frontend can't do without the files it was given, so it gives up if one
+ * can't be read */
+auto read_file(const std::string& filename) -> std::vector<u8>;
+auto read_file(const std::string& filename) -> std::vector<u8> {
+    std::string error;
+    std::vector<u8> data = read_bytes(filename, error);
+    if (!error.empty()) { fatal_error("%s", error.c_str()); }
+    return data;
+}
+
 CliOptions get_cli_options(int argc, char* argv[]);
 CliOptions get_cli_options(int argc, char* argv[]) {
     if (argc < 2) {
@@ -20,14 +83,9 @@ CliOptions get_cli_options(int argc, char* argv[]) {
     std::vector<std::string> flags(argv + 2, argv + argc);
 
     for (std::string& flag : flags) {
-        if (flag == "--debug") { cliOptions.options.debugger = true; }
-        else if (flag == "--trace") { cliOptions.options.trace = true; }
-        else if (flag == "--silent") { cliOptions.options.disable_logs = true; }
-        else if (flag == "--headless") { cliOptions.options.headless = true; }
-        else if (flag == "--whole-framebuffer") { cliOptions.options.show_full_framebuffer = true; }
-        else if (flag == "--exit-on-infinite-jr") { cliOptions.options.exit_on_infinite_jr = true; }
-        else if (flag == "--print-serial") { cliOptions.options.print_serial = true; }
-        else { fatal_error("Unknown flag: %s", flag.c_str()); }
+        if (!parse_option_flag(cliOptions.options, flag)) {
+            fatal_error("Unknown flag: %s", flag.c_str());
+        }
     }
 
     return cliOptions;
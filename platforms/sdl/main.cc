@@ -3,6 +3,7 @@
 
 #include <SDL.h>
 
+#include <algorithm>
 #include <fstream>
 #include <iterator>
 #include <optional>
@@ -15,6 +16,7 @@ static uint height = GAMEBOY_HEIGHT * pixel_size;
 static SDL_Window* window;
 static SDL_Renderer* renderer;
 static SDL_Texture* gb_screen_texture;
+static SDL_AudioDeviceID audio_device = 0;
 
 static std::unique_ptr<Gameboy> gameboy;
 
@@ -22,6 +24,11 @@ static CliOptions cliOptions;
 
 static bool should_exit = false;
 
+/* Set by the hotkeys, and acted on between ticks, as the machine can't be
+ * replaced in the middle of drawing a frame */
+static bool save_state_requested = false;
+static bool load_state_requested = false;
+
 static std::optional<GbButton> get_gb_button(int keyCode) {
     switch (keyCode) {
         case SDLK_UP: return GbButton::Up;
@@ -35,47 +42,12 @@ static std::optional<GbButton> get_gb_button(int keyCode) {
         case SDLK_b: gameboy->debug_toggle_background(); return {};
         case SDLK_s: gameboy->debug_toggle_sprites(); return {};
         case SDLK_w: gameboy->debug_toggle_window(); return {};
+        case SDLK_F5: save_state_requested = true; return {};
+        case SDLK_F7: load_state_requested = true; return {};
         default: return {};
     }
 }
 
-static uint32_t get_real_color(Color color) {
-    uint8_t r;
-    uint8_t g;
-    uint8_t b;
-
-    switch (color) {
-        case Color::White: r = g = b = 255; break;
-        case Color::LightGray: r = g = b = 170; break;
-        case Color::DarkGray: r = g = b = 85; break;
-        case Color::Black: r = g = b = 0; break;
-    }
-
-    return (r << 16) | (g << 8) | (b << 0);
-}
-
-static void set_pixel(uint32_t* pixels, uint x, uint y, uint32_t pixel_argb) {
-    pixels[width * y + x] = pixel_argb;
-}
-
-static void set_large_pixel(uint32_t* pixels, uint x, uint y, uint32_t pixel_argb) {
-    for (uint w = 0; w < pixel_size; w++) {
-        for (uint h = 0; h < pixel_size; h++) {
-            set_pixel(pixels, x * pixel_size + w, y * pixel_size + h, pixel_argb);
-        }
-    }
-}
-
-static void set_pixels(uint32_t* pixels, const FrameBuffer& buffer) {
-    for (uint y = 0; y < GAMEBOY_HEIGHT; y++) {
-        for (uint x = 0; x < GAMEBOY_WIDTH; x++) {
-            Color color = buffer.get_pixel(x, y);
-            uint32_t pixel_argb = get_real_color(color);
-            set_large_pixel(pixels, x, y, pixel_argb);
-        }
-    }
-}
-
 static std::string get_save_filename() {
     return cliOptions.filename + ".sav";
 }
@@ -102,12 +74,38 @@ static std::vector<u8> load_state() {
     if (!file_exists(filename)) {
         return {};
     } else {
-        auto save_data = read_bytes(filename);
+        auto save_data = read_file(filename);
         log_info("Read %d KB from %s", save_data.size() / 1024, filename.c_str());
         return save_data;
     }
 }
 
+static std::string get_state_filename() {
+    return cliOptions.filename + ".state";
+}
+
+static void write_state_file() {
+    std::vector<u8> state;
+    gameboy->save_state(state);
+
+    auto filename = get_state_filename();
+    std::ofstream output_file(filename, std::ios::binary);
+    std::copy(state.begin(), state.end(), std::ostreambuf_iterator<char>(output_file));
+    log_info("Saved state to %s", filename.c_str());
+}
+
+static void read_state_file() {
+    auto filename = get_state_filename();
+    if (!file_exists(filename)) {
+        log_warn("No saved state in %s", filename.c_str());
+        return;
+    }
+
+    if (gameboy->load_state(read_file(filename))) {
+        log_info("Loaded state from %s", filename.c_str());
+    }
+}
+
 static void process_events() {
     SDL_Event event;
 
@@ -115,12 +113,14 @@ static void process_events() {
         switch (event.type) {
             case SDL_KEYDOWN:
                 if (event.key.repeat == true) { break; }
+                if (event.key.keysym.sym == SDLK_r) { gameboy->set_rewinding(true); break; }
                 if (auto button_pressed = get_gb_button(event.key.keysym.sym); button_pressed) {
                     gameboy->button_pressed(*button_pressed);
                 }
                 break;
             case SDL_KEYUP:
                 if (event.key.repeat == true) { break; }
+                if (event.key.keysym.sym == SDLK_r) { gameboy->set_rewinding(false); break; }
                 if (auto button_released = get_gb_button(event.key.keysym.sym); button_released) {
                     gameboy->button_released(*button_released);
                 }
@@ -137,31 +137,68 @@ static void process_events() {
     }
 }
 
-static void draw(const FrameBuffer& buffer) {
+static void draw(const FrameBuffer& buffer, bool changed) {
     process_events();
 
     SDL_RenderClear(renderer);
 
-    void* pixels_ptr;
-    int pitch;
-    SDL_LockTexture(gb_screen_texture, nullptr, &pixels_ptr, &pitch);
+    /* The texture still holds an unchanged frame */
+    if (changed) {
+        void* pixels_ptr;
+        int pitch;
+        SDL_LockTexture(gb_screen_texture, nullptr, &pixels_ptr, &pitch);
 
-    uint32_t* pixels = static_cast<uint32_t*>(pixels_ptr);
-    set_pixels(pixels, buffer);
-    SDL_UnlockTexture(gb_screen_texture);
+        convert_to_argb8888(buffer, DMG_COLORS_ARGB8888, pixels_ptr, static_cast<uint>(pitch));
+        SDL_UnlockTexture(gb_screen_texture);
+    }
 
     SDL_RenderCopy(renderer, gb_screen_texture, nullptr, nullptr);
     SDL_RenderPresent(renderer);
 }
 
 static bool is_closed() {
+    if (save_state_requested) { write_state_file(); save_state_requested = false; }
+    if (load_state_requested) { read_state_file(); load_state_requested = false; }
+
     return should_exit;
 }
 
+/* Called on SDL's audio thread whenever the device wants more samples */
+static void play_audio(void* userdata, Uint8* stream, int length) {
+    auto* buffer = static_cast<AudioBuffer*>(userdata);
+    auto* frames = reinterpret_cast<AudioFrame*>(stream);
+    size_t wanted = static_cast<size_t>(length) / sizeof(AudioFrame);
+
+    size_t copied = read_audio(*buffer, frames, wanted);
+
+    /* If emulation has fallen behind, hold the last sample rather than
+     * dropping to silence, which would click */
+    AudioFrame last = copied > 0 ? frames[copied - 1] : AudioFrame{0, 0};
+    std::fill(frames + copied, frames + wanted, last);
+}
+
+static void open_audio() {
+    SDL_AudioSpec spec = {};
+    spec.freq = AUDIO_SAMPLE_RATE;
+    spec.format = AUDIO_S16SYS;
+    spec.channels = 2;
+    spec.samples = 1024;
+    spec.callback = play_audio;
+    spec.userdata = &gameboy->get_audio_output();
+
+    audio_device = SDL_OpenAudioDevice(nullptr, 0, &spec, nullptr, 0);
+    if (audio_device == 0) {
+        log_warn("Failed to open an audio device: %s", SDL_GetError());
+        return;
+    }
+
+    SDL_PauseAudioDevice(audio_device, 0);
+}
+
 int main(int argc, char* argv[]) {
     cliOptions = get_cli_options(argc, argv);
 
-    SDL_Init(SDL_INIT_VIDEO);
+    SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO);
 
     window = SDL_CreateWindow(
         "gbemu",
@@ -182,23 +219,26 @@ int main(int argc, char* argv[]) {
         renderer,
         SDL_PIXELFORMAT_ARGB8888,
         SDL_TEXTUREACCESS_STREAMING,
-        width, height
+        GAMEBOY_WIDTH, GAMEBOY_HEIGHT
     );
 
-    auto rom_data = read_bytes(cliOptions.filename);
+    auto rom_data = read_file(cliOptions.filename);
     log_info("Read %d KB from %s", rom_data.size() / 1024, cliOptions.filename.c_str());
 
     auto save_data = load_state();
     log_info("");
 
     gameboy = std::make_unique<Gameboy>(rom_data, cliOptions.options, save_data);
-    gameboy->run(&is_closed, &draw);
+    if (!cliOptions.options.disable_audio) { open_audio(); }
+
+    RunResult result = gameboy->run(&is_closed, &draw);
 
+    if (audio_device != 0) { SDL_CloseAudioDevice(audio_device); }
     save_state();
     SDL_DestroyTexture(gb_screen_texture);
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
     SDL_Quit();
 
-    return 0;
+    return result == RunResult::Fault ? 1 : 0;
 }
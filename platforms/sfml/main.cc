@@ -96,7 +96,7 @@ static std::vector<u8> load_state() {
     if (!file_exists(filename)) {
         return {};
     } else {
-        auto save_data = read_bytes(filename);
+        auto save_data = read_file(filename);
         log_info("Read %d KB from %s", save_data.size() / 1024, filename.c_str());
         return save_data;
     }
@@ -131,14 +131,17 @@ static void process_events() {
     }
 }
 
-static void draw(const FrameBuffer& buffer) {
+static void draw(const FrameBuffer& buffer, bool changed) {
     process_events();
 
     window->clear(sf::Color::White);
 
-    set_pixels(buffer);
-    texture.loadFromImage(image);
-    sprite.setTexture(texture, true);
+    /* The texture still holds an unchanged frame */
+    if (changed) {
+        set_pixels(buffer);
+        texture.loadFromImage(image);
+        sprite.setTexture(texture, true);
+    }
 
     window->draw(sprite);
 
@@ -159,7 +162,7 @@ int main(int argc, char* argv[]) {
     window->setKeyRepeatEnabled(false);
     window->display();
 
-    auto rom_data = read_bytes(cliOptions.filename);
+    auto rom_data = read_file(cliOptions.filename);
     log_info("Read %d KB from %s", rom_data.size() / 1024, cliOptions.filename.c_str());
 
     auto save_data = load_state();
@@ -2,17 +2,24 @@
 #include "../cli/cli.h"
 
 static std::unique_ptr<Gameboy> gameboy;
+static std::unique_ptr<HeadlessAudioSink> audio_sink;
 
-static void draw(const FrameBuffer& buffer) {
+static void draw(const FrameBuffer& buffer, bool changed) {
 }
 
 static bool is_closed() {
+    audio_sink->drain();
     return false;
 }
 
 int main(int argc, char* argv[]) {
     CliOptions cliOptions = get_cli_options(argc, argv);
-    auto rom_data = read_bytes(cliOptions.filename);
+    auto rom_data = read_file(cliOptions.filename);
     gameboy = std::make_unique<Gameboy>(rom_data, cliOptions.options);
-    gameboy->run(&is_closed, &draw);
+    audio_sink = std::make_unique<HeadlessAudioSink>(gameboy->get_audio_output(), cliOptions.options.audio_dump_path);
+    if (!audio_sink->is_open()) {
+        fatal_error("Could not open %s for writing", cliOptions.options.audio_dump_path.c_str());
+    }
+    RunResult result = gameboy->run(&is_closed, &draw);
+    return result == RunResult::Fault ? 1 : 0;
 }
@@ -0,0 +1,51 @@
+#include "../../src/cpu/trace.h"
+#include "../../src/cpu/opcode_names.h"
+#include "../../src/util/log.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+/* Prints a binary trace written with --trace in the emulator's text trace format */
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        fatal_error("usage: gbemu-trace <trace_file> [--registers]");
+    }
+
+    bool show_registers = argc > 2 && std::string(argv[2]) == "--registers";
+
+    FILE* file = fopen(argv[1], "rb");
+    if (file == nullptr) {
+        fatal_error("Unable to open trace file %s", argv[1]);
+    }
+
+    char magic[sizeof(trace_magic)] = {};
+    if (fread(magic, sizeof(magic), 1, file) != 1 || memcmp(magic, trace_magic, sizeof(magic)) != 0) {
+        fatal_error("%s is not a gbemu trace", argv[1]);
+    }
+
+    std::vector<TraceRecord> records(4096);
+    size_t count;
+
+    while ((count = fread(records.data(), sizeof(TraceRecord), records.size(), file)) > 0) {
+        for (size_t i = 0; i < count; i++) {
+            const TraceRecord& record = records[i];
+
+            if (record.prefixed) {
+                printf("0x%04X: %s (CB 0x%x)", record.pc, opcode_cb_names[record.opcode].c_str(), record.opcode);
+            } else {
+                printf("0x%04X: %s (0x%x)", record.pc, opcode_names[record.opcode].c_str(), record.opcode);
+            }
+
+            if (show_registers) {
+                printf("  AF=%04X BC=%04X DE=%04X HL=%04X SP=%04X cycle=%llu", record.af, record.bc,
+                       record.de, record.hl, record.sp, static_cast<unsigned long long>(record.cycle));
+            }
+
+            printf("\n");
+        }
+    }
+
+    fclose(file);
+    return 0;
+}
@@ -5,11 +5,10 @@
 
 class Address {
 public:
-    Address(u16 location);
-    explicit Address(const RegisterPair& from);
-    explicit Address(const WordRegister& from);
+    Address(u16 location) : addr(location) {}
+    explicit Address(const WordRegister& from) : addr(from.value()) {}
 
-    auto value() const -> u16;
+    auto value() const -> u16 { return addr; }
 
     auto in_range(Address low, Address high) const -> bool;
 
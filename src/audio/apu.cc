@@ -0,0 +1,301 @@
+#include "apu.h"
+
+#include "../gameboy.h"
+#include "../util/bitwise.h"
+
+#include <algorithm>
+
+/* Bits which always read back as 1, for NR10-NR52 */
+static const std::array<u8, 0x17> read_masks = {
+    0x80, 0x3F, 0x00, 0xFF, 0xBF, /* NR10-NR14 */
+    0xFF, 0x3F, 0x00, 0xFF, 0xBF, /* NR20-NR24 */
+    0x7F, 0xFF, 0x9F, 0xFF, 0xBF, /* NR30-NR34 */
+    0xFF, 0xFF, 0x00, 0x00, 0xBF, /* NR40-NR44 */
+    0x00, 0x00, 0x70,             /* NR50-NR52 */
+};
+
+/* The loudest a speaker gets is four channels at level 15, at 8 times
+ * volume; this takes that to nearly the top of a 16-bit sample */
+static const float sample_scale = 64.0f;
+
+static const u16 NR50 = 0xFF24;
+static const u16 NR51 = 0xFF25;
+static const u16 NR52 = 0xFF26;
+static const u16 WAVE_RAM = 0xFF30;
+
+APU::APU(Gameboy& inGb, Options& inOptions) :
+    gb(inGb),
+    options(inOptions),
+    square_1(true),
+    square_2(false),
+    left_buffer(CLOCK_RATE, AUDIO_SAMPLE_RATE),
+    right_buffer(CLOCK_RATE, AUDIO_SAMPLE_RATE)
+{
+}
+
+auto APU::read(u16 address) const -> u8 {
+    uint index = address - 0xFF10;
+
+    if (address >= WAVE_RAM) { return registers[index]; }
+
+    if (address == NR52) {
+        u8 status = read_masks[index];
+        status = bitwise::set_bit_to(status, 7, powered);
+        status = bitwise::set_bit_to(status, 0, square_1.enabled());
+        status = bitwise::set_bit_to(status, 1, square_2.enabled());
+        status = bitwise::set_bit_to(status, 2, wave.enabled());
+        status = bitwise::set_bit_to(status, 3, noise.enabled());
+        return status;
+    }
+
+    return registers[index] | read_masks[index];
+}
+
+void APU::write(u16 address, u8 value) {
+    uint index = address - 0xFF10;
+
+    if (address == NR52) {
+        bool power = bitwise::check_bit(value, 7);
+        if (power && !powered) { power_on(); }
+        if (!power && powered) { power_off(); }
+        return;
+    }
+
+    /* Only wave RAM can be written while the APU is off */
+    if (!powered && address < WAVE_RAM) { return; }
+
+    catch_up();
+    registers[index] = value;
+
+    u64 now = gb.scheduler.now();
+
+    if (address >= WAVE_RAM) { wave.write_wave_ram(address - WAVE_RAM, value); }
+    else if (address <= 0xFF14) { square_1.write(address - 0xFF10, value, now); }
+    else if (address <= 0xFF19) { square_2.write(address - 0xFF15, value, now); }
+    else if (address <= 0xFF1E) { wave.write(address - 0xFF1A, value, now); }
+    else if (address <= 0xFF23) { noise.write(address - 0xFF1F, value, now); }
+
+    update_levels(now);
+}
+
+void APU::handle_frame_sequencer_event(u64 deadline) {
+    catch_up();
+
+    /* Lengths at 256Hz, the sweep at 128Hz and envelopes at 64Hz */
+    if (frame_sequencer_step % 2 == 0) {
+        square_1.clock_length();
+        square_2.clock_length();
+        wave.clock_length();
+        noise.clock_length();
+    }
+
+    if (frame_sequencer_step == 2 || frame_sequencer_step == 6) {
+        square_1.clock_sweep();
+    }
+
+    if (frame_sequencer_step == 7) {
+        square_1.clock_envelope();
+        square_2.clock_envelope();
+        noise.clock_envelope();
+    }
+
+    frame_sequencer_step = (frame_sequencer_step + 1) % 8;
+
+    u64 now = gb.scheduler.now();
+    update_levels(now);
+    flush_samples(now);
+
+    gb.scheduler.schedule(Event::FrameSequencer, deadline + FRAME_SEQUENCER_PERIOD);
+}
+
+void APU::save_state(APUState& state) {
+    catch_up();
+
+    state.powered = powered;
+    state.frame_sequencer_step = frame_sequencer_step;
+
+    state.square_1 = square_1;
+    state.square_2 = square_2;
+    state.wave = wave;
+    state.noise = noise;
+
+    state.registers = registers;
+}
+
+void APU::load_state(const APUState& state) {
+    powered = state.powered;
+    frame_sequencer_step = state.frame_sequencer_step;
+
+    square_1 = state.square_1;
+    square_2 = state.square_2;
+    wave = state.wave;
+    noise = state.noise;
+
+    registers = state.registers;
+
+    resume_output(gb.scheduler.now());
+}
+
+void APU::set_output_enabled(bool enabled) {
+    if (enabled == output_enabled) { return; }
+
+    u64 now = gb.scheduler.now();
+
+    if (!enabled) {
+        catch_up();
+        flush_samples(now);
+    }
+
+    output_enabled = enabled;
+
+    if (enabled) { resume_output(now); }
+}
+
+void APU::resume_output(u64 time) {
+    if (!synthesising()) { return; }
+
+    /* A state from another time is unrelated to what was playing, so start
+     * again from silence rather than jumping to it */
+    if (time != left_buffer.frame_start_time()) {
+        levels = {};
+        left_level = 0.0f;
+        right_level = 0.0f;
+
+        left_buffer.reset(time);
+        right_buffer.reset(time);
+    }
+
+    update_levels(time);
+}
+
+void APU::catch_up() {
+    if (!powered) { return; }
+
+    u64 now = gb.scheduler.now();
+
+    /* The mix is linear, so each channel can be run up to now on its own */
+    run_channel(square_1, 0, now);
+    run_channel(square_2, 1, now);
+    run_channel(wave, 2, now);
+    run_channel(noise, 3, now);
+}
+
+template <typename ChannelType>
+void APU::run_channel(ChannelType& channel, uint index, u64 time) {
+    /* A channel which can't be heard only needs to keep its place */
+    if (!synthesising() || !channel.audible()) {
+        channel.skip_to(time);
+        return;
+    }
+
+    while (channel.next_step <= time) {
+        u64 step_time = channel.next_step;
+        channel.step();
+        set_level(index, channel.amplitude(), step_time);
+    }
+}
+
+void APU::update_levels(u64 time) {
+    if (!synthesising()) { return; }
+
+    set_level(0, square_1.audible() ? square_1.amplitude() : 0, time);
+    set_level(1, square_2.audible() ? square_2.amplitude() : 0, time);
+    set_level(2, wave.audible() ? wave.amplitude() : 0, time);
+    set_level(3, noise.audible() ? noise.amplitude() : 0, time);
+
+    /* The panning or master volume may have changed */
+    update_mix(time);
+}
+
+void APU::set_level(uint index, uint level, u64 time) {
+    if (levels[index] == level) { return; }
+
+    levels[index] = level;
+    update_mix(time);
+}
+
+void APU::update_mix(u64 time) {
+    u8 panning = registers[NR51 - 0xFF10];
+    u8 volume = registers[NR50 - 0xFF10];
+
+    uint left = 0;
+    uint right = 0;
+
+    for (uint channel = 0; channel < 4; channel++) {
+        if (bitwise::check_bit(panning, static_cast<u8>(channel + 4))) { left += levels[channel]; }
+        if (bitwise::check_bit(panning, static_cast<u8>(channel))) { right += levels[channel]; }
+    }
+
+    float new_left = static_cast<float>(left * (((volume >> 4) & 0x7) + 1)) * sample_scale;
+    float new_right = static_cast<float>(right * ((volume & 0x7) + 1)) * sample_scale;
+
+    if (new_left != left_level) {
+        left_buffer.add_delta(time, new_left - left_level);
+        left_level = new_left;
+    }
+
+    if (new_right != right_level) {
+        right_buffer.add_delta(time, new_right - right_level);
+        right_level = new_right;
+    }
+}
+
+void APU::flush_samples(u64 time) {
+    if (!synthesising()) { return; }
+
+    left_buffer.end_frame(time);
+    right_buffer.end_frame(time);
+
+    /* Frames are interleaved pairs of samples */
+    std::array<AudioFrame, 256> frames;
+    s16* interleaved = &frames[0].left;
+
+    while (left_buffer.samples_available() > 0) {
+        uint count = std::min(left_buffer.samples_available(), static_cast<uint>(frames.size()));
+        left_buffer.read_samples(interleaved, count, 2);
+        right_buffer.read_samples(interleaved + 1, count, 2);
+
+        /* Nothing is playing the samples fast enough, so drop them */
+        for (uint i = 0; i < count; i++) {
+            if (!samples.push(frames[i])) { break; }
+        }
+    }
+}
+
+void APU::power_on() {
+    u64 now = gb.scheduler.now();
+
+    powered = true;
+    frame_sequencer_step = 0;
+
+    /* The buffers are left alone while the output is off, so that it can
+     * carry on from where it stopped */
+    if (synthesising()) {
+        left_buffer.reset(now);
+        right_buffer.reset(now);
+    }
+
+    gb.scheduler.schedule(Event::FrameSequencer, now + FRAME_SEQUENCER_PERIOD);
+}
+
+void APU::power_off() {
+    catch_up();
+
+    u64 now = gb.scheduler.now();
+
+    /* Every register but NR52 (and wave RAM) is cleared */
+    for (u16 address = 0xFF10; address < NR52; address++) {
+        write(address, 0);
+    }
+
+    square_1.disable();
+    square_2.disable();
+    wave.disable();
+    noise.disable();
+
+    update_levels(now);
+    flush_samples(now);
+
+    powered = false;
+    gb.scheduler.cancel(Event::FrameSequencer);
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "audio_buffer.h"
+#include "band_limited_buffer.h"
+#include "channels.h"
+
+#include "../definitions.h"
+#include "../options.h"
+
+#include <array>
+
+class Gameboy;
+
+/* Everything needed to restore the APU (see save_state.h). The samples which
+ * haven't been played yet aren't included */
+struct APUState {
+    bool powered;
+    uint frame_sequencer_step;
+
+    SquareChannel square_1;
+    SquareChannel square_2;
+    WaveChannel wave;
+    NoiseChannel noise;
+
+    std::array<u8, 0x30> registers;
+};
+
+/*
+ * The audio processing unit (0xFF10-0xFF3F).
+ *
+ * Like the PPU, the APU is never ticked. Its channels are only run when
+ * something could change what they play - a register write, or a step of the
+ * frame sequencer, which is an event - and then only from one change in their
+ * output to the next. The changes are turned into samples by band-limited
+ * synthesis, and the samples handed to the frontend on every frame sequencer
+ * step, through a buffer which another thread can read from.
+ */
+class APU {
+public:
+    APU(Gameboy& inGb, Options& inOptions);
+
+    auto read(u16 address) const -> u8;
+    void write(u16 address, u8 value);
+
+    /* Clocks the channels' lengths, envelopes and sweep */
+    void handle_frame_sequencer_event(u64 deadline);
+
+    /* Samples waiting to be played */
+    auto output() -> AudioBuffer& { return samples; }
+
+    /* Stops producing samples, e.g. while emulating frames which will be
+     * thrown away, finishing those due so far. Only the timing is kept */
+    void set_output_enabled(bool enabled);
+
+    /* Saving runs the channels up to now first, so that a loaded state
+     * doesn't produce samples from before it was loaded */
+    void save_state(APUState& state);
+    void load_state(const APUState& state);
+
+private:
+    /* Runs the channels up to the current time */
+    void catch_up();
+
+    template <typename ChannelType>
+    void run_channel(ChannelType& channel, uint index, u64 time);
+
+    /* Something other than the waveform moving on may have changed what the
+     * channels are playing, e.g. a register write or an envelope step */
+    void update_levels(u64 time);
+    void set_level(uint index, uint level, u64 time);
+    void update_mix(u64 time);
+
+    /* Finishes the samples up to `time` and hands them over */
+    void flush_samples(u64 time);
+
+    auto synthesising() const -> bool { return output_enabled && !options.disable_audio; }
+
+    /* Picks the output up again at `time`: from where it left off if that's
+     * when it was last flushed, or else from silence */
+    void resume_output(u64 time);
+
+    void power_on();
+    void power_off();
+
+    Gameboy& gb;
+    Options& options;
+
+    bool powered = false;
+    uint frame_sequencer_step = 0;
+
+    bool output_enabled = true;
+
+    SquareChannel square_1;
+    SquareChannel square_2;
+    WaveChannel wave;
+    NoiseChannel noise;
+
+    /* The registers as written, for reading back */
+    std::array<u8, 0x30> registers = {};
+
+    /* Each channel's output, and their mix at each speaker */
+    std::array<uint, 4> levels = {};
+    float left_level = 0.0f;
+    float right_level = 0.0f;
+
+    BandLimitedBuffer left_buffer;
+    BandLimitedBuffer right_buffer;
+
+    AudioBuffer samples;
+};
+
+const uint FRAME_SEQUENCER_PERIOD = CLOCK_RATE / 512;
@@ -0,0 +1,21 @@
+#include "audio_buffer.h"
+
+#include <algorithm>
+
+auto read_audio(AudioBuffer& buffer, AudioFrame* out, size_t count) -> size_t {
+    size_t copied = 0;
+
+    /* The frames may wrap around the end of the buffer's storage */
+    while (copied < count) {
+        const AudioFrame* first;
+        size_t available = buffer.peek(first);
+        if (available == 0) { break; }
+
+        size_t run = std::min(available, count - copied);
+        std::copy(first, first + run, out + copied);
+        buffer.consume(run);
+        copied += run;
+    }
+
+    return copied;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "../definitions.h"
+#include "../util/ring_buffer.h"
+
+#include <cstddef>
+
+const uint AUDIO_SAMPLE_RATE = 44100;
+
+/* One sample for each speaker, laid out as interleaved 16-bit stereo */
+struct AudioFrame {
+    s16 left;
+    s16 right;
+};
+
+/* Samples on their way from the APU to whatever plays them, which is usually
+ * on another thread. Holds a little under 200ms of audio */
+using AudioBuffer = RingBuffer<AudioFrame, 8192>;
+
+/* Takes up to `count` frames out of the buffer, returning how many there were */
+auto read_audio(AudioBuffer& buffer, AudioFrame* out, size_t count) -> size_t;
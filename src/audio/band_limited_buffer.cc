@@ -0,0 +1,114 @@
+#include "band_limited_buffer.h"
+
+#include <algorithm>
+#include <cmath>
+
+/* Each step is spread over this many samples, which is also how far behind
+ * the steps (by half) the samples lag */
+static const uint kernel_width = 16;
+
+/* Steps are placed to within 1/32 of a sample */
+static const uint phase_bits = 5;
+static const uint phase_count = 1 << phase_bits;
+
+/* Far more samples than a frame produces */
+static const uint buffer_size = 4096;
+
+/* The high-pass filter's decay per sample at 44.1kHz */
+static const float high_pass_charge = 0.996f;
+
+using Kernel = std::array<std::array<float, kernel_width>, phase_count>;
+
+/* A windowed sinc for each position a step can have between two samples,
+ * cutting off a little below the Nyquist frequency. Each phase's taps sum to
+ * 1, so that a step has exactly its height once the samples are integrated */
+static auto make_kernel() -> Kernel {
+    const double pi = 3.14159265358979323846;
+    const double cutoff = 0.45; /* Fraction of the sample rate */
+
+    Kernel kernel;
+
+    for (uint phase = 0; phase < phase_count; phase++) {
+        double centre = kernel_width / 2.0 - 1.0 + static_cast<double>(phase) / phase_count;
+        double total = 0.0;
+
+        for (uint i = 0; i < kernel_width; i++) {
+            double x = i - centre;
+            double sinc = x == 0.0 ? 1.0 : std::sin(2.0 * pi * cutoff * x) / (2.0 * pi * cutoff * x);
+
+            /* Blackman window over the width of the kernel */
+            double w = (x + kernel_width / 2.0) / kernel_width;
+            double window = 0.42 - 0.5 * std::cos(2.0 * pi * w) + 0.08 * std::cos(4.0 * pi * w);
+
+            kernel[phase][i] = static_cast<float>(sinc * window);
+            total += sinc * window;
+        }
+
+        for (float& tap : kernel[phase]) { tap = static_cast<float>(tap / total); }
+    }
+
+    return kernel;
+}
+
+static const Kernel kernel = make_kernel();
+
+BandLimitedBuffer::BandLimitedBuffer(uint inClockRate, uint inSampleRate) :
+    samples_per_cycle((static_cast<u64>(inSampleRate) << 32) / inClockRate),
+    deltas(buffer_size, 0.0f)
+{
+}
+
+auto BandLimitedBuffer::sample_position(u64 time) const -> u64 {
+    return (static_cast<u64>(available) << 32) + frame_start_fraction + (time - frame_start) * samples_per_cycle;
+}
+
+void BandLimitedBuffer::add_delta(u64 time, float delta) {
+    u64 position = sample_position(time);
+    uint index = static_cast<uint>(position >> 32);
+    uint phase = static_cast<uint>(position >> (32 - phase_bits)) & (phase_count - 1);
+
+    /* Only possible if a frame is left unfinished for far too long */
+    if (index + kernel_width > buffer_size) { return; }
+
+    const auto& taps = kernel[phase];
+    for (uint i = 0; i < kernel_width; i++) {
+        deltas[index + i] += delta * taps[i];
+    }
+}
+
+void BandLimitedBuffer::end_frame(u64 time) {
+    u64 position = sample_position(time);
+
+    available = std::min(static_cast<uint>(position >> 32), buffer_size - kernel_width);
+    frame_start_fraction = position & 0xFFFFFFFF;
+    frame_start = time;
+}
+
+void BandLimitedBuffer::reset(u64 time) {
+    std::fill(deltas.begin(), deltas.end(), 0.0f);
+    available = 0;
+    frame_start = time;
+    frame_start_fraction = 0;
+    sum = 0.0f;
+}
+
+void BandLimitedBuffer::read_samples(s16* out, uint count, uint stride) {
+    count = std::min(count, available);
+
+    for (uint i = 0; i < count; i++) {
+        sum += deltas[i];
+
+        float sample = sum - capacitor;
+        capacitor = sum - sample * high_pass_charge;
+
+        sample = std::max(-32768.0f, std::min(32767.0f, sample));
+        out[i * stride] = static_cast<s16>(sample);
+    }
+
+    /* Keep the unfinished samples, which later steps are still added to */
+    uint end = available + kernel_width;
+    std::copy(deltas.begin() + count, deltas.begin() + end, deltas.begin());
+    std::fill(deltas.begin() + (end - count), deltas.begin() + end, 0.0f);
+
+    available -= count;
+}
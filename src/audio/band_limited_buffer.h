@@ -0,0 +1,65 @@
+#pragma once
+
+#include "../definitions.h"
+
+#include <array>
+#include <vector>
+
+/*
+ * Turns a signal made of steps (a channel's output only changes when its
+ * waveform moves on) into samples, without the aliasing that sampling it
+ * directly would cause.
+ *
+ * Each step is added as a band-limited impulse at its exact position between
+ * two samples, and the samples are integrated when they are read, so the
+ * cost is per change in the signal rather than per cycle or per sample.
+ * Samples are only final once no later step can touch them, so they are
+ * made available a frame at a time with end_frame().
+ */
+class BandLimitedBuffer {
+public:
+    BandLimitedBuffer(uint inClockRate, uint inSampleRate);
+
+    /* Steps the output by `delta` at `time` (in clock cycles), which must be
+     * no earlier than the start of the current frame */
+    void add_delta(u64 time, float delta);
+
+    /* Finishes the frame at `time`, making the samples before it readable */
+    void end_frame(u64 time);
+
+    /* Drops everything, starting a new frame at `time` */
+    void reset(u64 time);
+
+    auto samples_available() const -> uint { return available; }
+
+    /* When the current frame started, i.e. the time the last end_frame() or
+     * reset() was called with */
+    auto frame_start_time() const -> u64 { return frame_start; }
+
+    /* Takes `count` finished samples, writing them `stride` apart in `out` */
+    void read_samples(s16* out, uint count, uint stride);
+
+private:
+    /* Where `time` falls, in samples from the start of the buffer, as a
+     * 32.32 fixed-point number */
+    auto sample_position(u64 time) const -> u64;
+
+    /* Samples per clock cycle, as a 32.32 fixed-point number */
+    const u64 samples_per_cycle;
+
+    /* The start of the current frame, and how far into the first unfinished
+     * sample it fell */
+    u64 frame_start = 0;
+    u64 frame_start_fraction = 0;
+
+    /* Finished samples at the start of `deltas` */
+    uint available = 0;
+
+    /* The differences between consecutive samples, which are summed when read */
+    std::vector<float> deltas;
+    float sum = 0.0f;
+
+    /* High-pass filter state, which removes the DC offset the way the
+     * capacitor on the real hardware's output does */
+    float capacitor = 0.0f;
+};
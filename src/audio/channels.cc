@@ -0,0 +1,229 @@
+#include "channels.h"
+
+#include "../util/bitwise.h"
+
+/* Which of the eight steps of each duty cycle are high */
+static const std::array<std::array<u8, 8>, 4> duty_patterns = {{
+    {0, 0, 0, 0, 0, 0, 0, 1}, /* 12.5% */
+    {1, 0, 0, 0, 0, 0, 0, 1}, /* 25% */
+    {1, 0, 0, 0, 0, 1, 1, 1}, /* 50% */
+    {0, 1, 1, 1, 1, 1, 1, 0}, /* 75% */
+}};
+
+/* NR43's shifts of 14 and 15 stop the noise channel's clock altogether. A
+ * period longer than anything plays for stands in for that */
+static const uint stopped_period = 1u << 30;
+
+auto LengthCounter::clock() -> bool {
+    if (!enabled || remaining == 0) { return false; }
+
+    remaining--;
+    return remaining == 0;
+}
+
+void Envelope::trigger() {
+    current_volume = register_value >> 4;
+    timer = period();
+}
+
+void Envelope::clock() {
+    if (period() == 0) { return; }
+
+    if (timer > 0) { timer--; }
+    if (timer != 0) { return; }
+
+    timer = period();
+
+    bool increasing = bitwise::check_bit(register_value, 3);
+    if (increasing && current_volume < 15) { current_volume++; }
+    if (!increasing && current_volume > 0) { current_volume--; }
+}
+
+auto Channel::skip_periods(u64 time, uint period) -> u64 {
+    if (next_step > time) { return 0; }
+
+    u64 periods = (time - next_step) / period + 1;
+    next_step += periods * period;
+    return periods;
+}
+
+void SquareChannel::write(uint reg, u8 value, u64 now) {
+    switch (reg) {
+        case 0:
+            sweep_register = value;
+            break;
+
+        case 1:
+            duty = value >> 6;
+            length.load(value & 0x3F);
+            break;
+
+        case 2:
+            envelope.write(value);
+            if (!envelope.dac_enabled()) { active = false; }
+            break;
+
+        case 3:
+            frequency = (frequency & 0x700) | value;
+            break;
+
+        case 4:
+            frequency = (frequency & 0xFF) | ((value & 0x7) << 8);
+            length.set_enabled(bitwise::check_bit(value, 6));
+            if (bitwise::check_bit(value, 7)) { trigger(now); }
+            break;
+    }
+}
+
+void SquareChannel::trigger(u64 now) {
+    active = envelope.dac_enabled();
+    length.trigger();
+    envelope.trigger();
+    restart_timer(now, period());
+
+    if (!has_sweep) { return; }
+
+    uint sweep_period = (sweep_register >> 4) & 0x7;
+    uint sweep_shift = sweep_register & 0x7;
+
+    shadow_frequency = frequency;
+    sweep_timer = sweep_period != 0 ? sweep_period : 8;
+    sweep_enabled = sweep_period != 0 || sweep_shift != 0;
+
+    /* The overflow check happens straight away */
+    if (sweep_shift != 0) { sweep_frequency(); }
+}
+
+void SquareChannel::clock_sweep() {
+    if (!has_sweep) { return; }
+
+    if (sweep_timer > 0) { sweep_timer--; }
+    if (sweep_timer != 0) { return; }
+
+    uint sweep_period = (sweep_register >> 4) & 0x7;
+    uint sweep_shift = sweep_register & 0x7;
+
+    sweep_timer = sweep_period != 0 ? sweep_period : 8;
+    if (!sweep_enabled || sweep_period == 0) { return; }
+
+    uint new_frequency = sweep_frequency();
+    if (new_frequency <= 2047 && sweep_shift != 0) {
+        shadow_frequency = new_frequency;
+        frequency = new_frequency;
+
+        /* ...and again with the new frequency */
+        sweep_frequency();
+    }
+}
+
+auto SquareChannel::sweep_frequency() -> uint {
+    uint delta = shadow_frequency >> (sweep_register & 0x7);
+    bool negate = bitwise::check_bit(sweep_register, 3);
+
+    uint new_frequency = negate ? shadow_frequency - delta : shadow_frequency + delta;
+    if (new_frequency > 2047) { active = false; }
+
+    return new_frequency;
+}
+
+auto SquareChannel::amplitude() const -> uint {
+    return duty_patterns[duty][duty_position] ? envelope.volume() : 0;
+}
+
+void WaveChannel::write(uint reg, u8 value, u64 now) {
+    switch (reg) {
+        case 0:
+            dac_on = bitwise::check_bit(value, 7);
+            if (!dac_on) { active = false; }
+            break;
+
+        case 1:
+            length.load(value);
+            break;
+
+        case 2: {
+            /* Mute, 100%, 50% and 25% */
+            static const uint shifts[4] = {4, 0, 1, 2};
+            volume_shift = shifts[(value >> 5) & 0x3];
+            break;
+        }
+
+        case 3:
+            frequency = (frequency & 0x700) | value;
+            break;
+
+        case 4:
+            frequency = (frequency & 0xFF) | ((value & 0x7) << 8);
+            length.set_enabled(bitwise::check_bit(value, 6));
+
+            if (bitwise::check_bit(value, 7)) {
+                active = dac_on;
+                length.trigger();
+                position = 0;
+                restart_timer(now, period());
+            }
+            break;
+    }
+}
+
+auto WaveChannel::amplitude() const -> uint {
+    u8 samples = wave_ram[position / 2];
+
+    /* The high nibble is played first */
+    uint sample = (position & 1) ? (samples & 0xF) : (samples >> 4);
+    return sample >> volume_shift;
+}
+
+void NoiseChannel::write(uint reg, u8 value, u64 now) {
+    switch (reg) {
+        case 1:
+            length.load(value & 0x3F);
+            break;
+
+        case 2:
+            envelope.write(value);
+            if (!envelope.dac_enabled()) { active = false; }
+            break;
+
+        case 3:
+            polynomial = value;
+            break;
+
+        case 4:
+            length.set_enabled(bitwise::check_bit(value, 6));
+
+            if (bitwise::check_bit(value, 7)) {
+                active = envelope.dac_enabled();
+                length.trigger();
+                envelope.trigger();
+                lfsr = 0x7FFF;
+                restart_timer(now, period());
+            }
+            break;
+    }
+}
+
+void NoiseChannel::step() {
+    u16 feedback = (lfsr ^ (lfsr >> 1)) & 1;
+    lfsr = static_cast<u16>((lfsr >> 1) | (feedback << 14));
+
+    /* In 7-bit mode the feedback also goes into bit 6 */
+    if (bitwise::check_bit(polynomial, 3)) {
+        lfsr = static_cast<u16>((lfsr & ~0x40) | (feedback << 6));
+    }
+
+    next_step += period();
+}
+
+auto NoiseChannel::period() const -> uint {
+    uint divisor_code = polynomial & 0x7;
+    uint shift = polynomial >> 4;
+    if (shift >= 14) { return stopped_period; }
+
+    uint divisor = divisor_code == 0 ? 8 : divisor_code * 16;
+    return divisor << shift;
+}
+
+auto NoiseChannel::amplitude() const -> uint {
+    return (lfsr & 1) ? 0 : envelope.volume();
+}
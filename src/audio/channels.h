@@ -0,0 +1,174 @@
+#pragma once
+
+#include "../definitions.h"
+
+#include <array>
+
+/* Silences a channel once it has played for its length, if enabled. Clocked
+ * at 256Hz by the frame sequencer */
+class LengthCounter {
+public:
+    LengthCounter(uint inMaximum) : maximum(inMaximum) {}
+
+    void load(u8 value) { remaining = maximum - value; }
+    void set_enabled(bool is_enabled) { enabled = is_enabled; }
+    void trigger() { if (remaining == 0) { remaining = maximum; } }
+
+    /* Returns whether the channel should be silenced */
+    auto clock() -> bool;
+
+private:
+    uint maximum;
+    uint remaining = 0;
+    bool enabled = false;
+};
+
+/* Fades a channel's volume up or down. Clocked at 64Hz by the frame sequencer */
+class Envelope {
+public:
+    void write(u8 value) { register_value = value; }
+    void trigger();
+    void clock();
+
+    auto volume() const -> uint { return current_volume; }
+
+    /* Whether the channel's DAC is on, which shares a register with the envelope */
+    auto dac_enabled() const -> bool { return (register_value & 0xF8) != 0; }
+
+private:
+    auto period() const -> uint { return register_value & 0x7; }
+
+    u8 register_value = 0;
+    uint current_volume = 0;
+    uint timer = 0;
+};
+
+/*
+ * What every channel has in common: it starts playing when triggered, stops
+ * when its length runs out (or it is switched off), and moves through its
+ * waveform each time its frequency timer runs out.
+ *
+ * Times are absolute, in clock cycles. Channels are run by the APU, which
+ * calls step() for each timer expiry up to the present, so that nothing
+ * happens per cycle.
+ */
+class Channel {
+public:
+    Channel(uint max_length) : length(max_length) {}
+
+    auto enabled() const -> bool { return active; }
+    void disable() { active = false; }
+
+    void clock_length() { if (length.clock()) { active = false; } }
+
+    /* When the frequency timer next runs out */
+    u64 next_step = 0;
+
+protected:
+    /* The frequency timer restarts when the channel is triggered */
+    void restart_timer(u64 now, uint period) { next_step = now + period; }
+
+    /* Moves the timer on by whole periods to `time`, without stepping the
+     * waveform. Returns how many periods passed */
+    auto skip_periods(u64 time, uint period) -> u64;
+
+    bool active = false;
+    LengthCounter length;
+};
+
+/* Channels 1 and 2: a square wave with a choice of duty cycles. Channel 1
+ * can also sweep its frequency up or down */
+class SquareChannel : public Channel {
+public:
+    SquareChannel(bool inHasSweep = false) : Channel(64), has_sweep(inHasSweep) {}
+
+    /* `reg` is the register's index in the channel's block, e.g. 1 for NR11/NR21 */
+    void write(uint reg, u8 value, u64 now);
+
+    void clock_envelope() { envelope.clock(); }
+    void clock_sweep();
+
+    auto audible() const -> bool { return active && envelope.dac_enabled() && envelope.volume() != 0; }
+    auto dac_enabled() const -> bool { return envelope.dac_enabled(); }
+    auto amplitude() const -> uint;
+
+    void step() { duty_position = (duty_position + 1) & 0x7; next_step += period(); }
+    void skip_to(u64 time) { duty_position = (duty_position + skip_periods(time, period())) & 0x7; }
+
+private:
+    auto period() const -> uint { return (2048 - frequency) * 4; }
+    void trigger(u64 now);
+
+    /* The frequency the sweep would move to, disabling the channel if it
+     * would overflow */
+    auto sweep_frequency() -> uint;
+
+    bool has_sweep;
+
+    uint duty = 0;
+    uint duty_position = 0;
+    uint frequency = 0;
+    Envelope envelope;
+
+    u8 sweep_register = 0;
+    bool sweep_enabled = false;
+    uint sweep_timer = 0;
+    uint shadow_frequency = 0;
+};
+
+/* Channel 3: plays 32 4-bit samples from wave RAM */
+class WaveChannel : public Channel {
+public:
+    WaveChannel() : Channel(256) {}
+
+    void write(uint reg, u8 value, u64 now);
+    void write_wave_ram(uint offset, u8 value) { wave_ram[offset] = value; }
+
+    auto audible() const -> bool { return active && dac_on && volume_shift < 4; }
+    auto dac_enabled() const -> bool { return dac_on; }
+    auto amplitude() const -> uint;
+
+    void step() { position = (position + 1) & 0x1F; next_step += period(); }
+    void skip_to(u64 time) { position = (position + skip_periods(time, period())) & 0x1F; }
+
+private:
+    auto period() const -> uint { return (2048 - frequency) * 2; }
+
+    bool dac_on = false;
+    uint frequency = 0;
+    uint position = 0;
+
+    /* How far samples are shifted down: 4 silences the channel */
+    uint volume_shift = 4;
+
+    std::array<u8, 16> wave_ram = {};
+};
+
+/* Channel 4: pseudo-random noise from a linear feedback shift register */
+class NoiseChannel : public Channel {
+public:
+    NoiseChannel() : Channel(64) {}
+
+    void write(uint reg, u8 value, u64 now);
+
+    void clock_envelope() { envelope.clock(); }
+
+    auto audible() const -> bool { return active && envelope.dac_enabled() && envelope.volume() != 0; }
+    auto dac_enabled() const -> bool { return envelope.dac_enabled(); }
+    auto amplitude() const -> uint;
+
+    void step();
+
+    /* The exact noise doesn't matter while nothing can hear it, so the
+     * shift register is left alone */
+    void skip_to(u64 time) { skip_periods(time, period()); }
+
+private:
+    auto period() const -> uint;
+
+    Envelope envelope;
+
+    /* Divisor code, shift and 7-bit mode, from NR43 */
+    u8 polynomial = 0;
+    u16 lfsr = 0x7FFF;
+};
@@ -0,0 +1,63 @@
+#include "headless_sink.h"
+
+#include <array>
+
+HeadlessAudioSink::HeadlessAudioSink(AudioBuffer& inBuffer, const std::string& wav_path) :
+    buffer(inBuffer)
+{
+    if (wav_path.empty()) { return; }
+
+    wav_file.open(wav_path, std::ios::binary);
+    if (!wav_file) {
+        open_failed = true;
+        return;
+    }
+
+    /* Written again once the length is known */
+    write_wav_header();
+}
+
+HeadlessAudioSink::~HeadlessAudioSink() {
+    if (!wav_file.is_open()) { return; }
+
+    drain();
+
+    wav_file.seekp(0);
+    write_wav_header();
+}
+
+void HeadlessAudioSink::drain() {
+    std::array<AudioFrame, 1024> frames;
+
+    while (size_t count = read_audio(buffer, frames.data(), frames.size())) {
+        frame_count += count;
+
+        if (wav_file.is_open()) {
+            wav_file.write(reinterpret_cast<const char*>(frames.data()),
+                           static_cast<std::streamsize>(count * sizeof(AudioFrame)));
+        }
+    }
+}
+
+void HeadlessAudioSink::write_wav_header() {
+    auto write_u32 = [&](u32 value) { wav_file.write(reinterpret_cast<const char*>(&value), 4); };
+    auto write_u16 = [&](u16 value) { wav_file.write(reinterpret_cast<const char*>(&value), 2); };
+
+    u32 data_size = static_cast<u32>(frame_count * sizeof(AudioFrame));
+
+    wav_file.write("RIFF", 4);
+    write_u32(36 + data_size);
+    wav_file.write("WAVE", 4);
+
+    wav_file.write("fmt ", 4);
+    write_u32(16);
+    write_u16(1); /* PCM */
+    write_u16(2); /* Stereo */
+    write_u32(AUDIO_SAMPLE_RATE);
+    write_u32(AUDIO_SAMPLE_RATE * sizeof(AudioFrame));
+    write_u16(sizeof(AudioFrame));
+    write_u16(16); /* Bits per sample */
+
+    wav_file.write("data", 4);
+    write_u32(data_size);
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "audio_buffer.h"
+
+#include "../definitions.h"
+
+#include <fstream>
+#include <string>
+
+/*
+ * Plays nothing, but takes samples out of an AudioBuffer as a sound card
+ * would, so that emulation without a sound card (e.g. when running tests)
+ * exercises the same path. The samples can be written to a WAV file.
+ */
+class HeadlessAudioSink {
+public:
+    /* An empty path discards the samples */
+    HeadlessAudioSink(AudioBuffer& inBuffer, const std::string& wav_path = "");
+    ~HeadlessAudioSink();
+
+    /* False if a WAV file was asked for but couldn't be opened */
+    auto is_open() const -> bool { return !open_failed; }
+
+    /* Takes everything which is waiting in the buffer */
+    void drain();
+
+    auto frames_received() const -> u64 { return frame_count; }
+
+private:
+    void write_wav_header();
+
+    AudioBuffer& buffer;
+    std::ofstream wav_file;
+    bool open_failed = false;
+    u64 frame_count = 0;
+};
@@ -1,13 +1,33 @@
 #include "cartridge.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "../util/files.h"
 #include "../util/log.h"
+#include "../util/string_utils.h"
 
-auto get_cartridge(const std::vector<u8>& rom_data, const std::vector<u8>& ram_data)
+/* Stands in for a game which can't be loaded, so that the rest of the
+ * machine can still be put together */
+static auto blank_cartridge() -> std::shared_ptr<Cartridge> {
+    auto rom_data = std::make_shared<const std::vector<u8>>(0x8000, 0);
+    return std::make_shared<NoMBC>(rom_data, std::vector<u8>(), get_info(*rom_data));
+}
+
+auto get_cartridge(rom_t rom_data, const std::vector<u8>& ram_data, std::string& error)
     -> std::shared_ptr<Cartridge> {
-    std::unique_ptr<CartridgeInfo> info = get_info(rom_data);
+    if (rom_data->size() < MINIMUM_ROM_SIZE) {
+        error = str_format("ROM is too small to have a header (%zu bytes)", rom_data->size());
+        return blank_cartridge();
+    }
+
+    std::unique_ptr<CartridgeInfo> info = get_info(*rom_data);
+
+    auto ram_size_for_cartridge = get_actual_ram_size(info->ram_size);
+    if (!ram_data.empty() && ram_data.size() != ram_size_for_cartridge) {
+        error = str_format("Invalid or corrupted RAM file. Read %zu bytes, expected %u", ram_data.size(), ram_size_for_cartridge);
+        return blank_cartridge();
+    }
 
     switch (info->type) {
         case CartridgeType::ROMOnly:
@@ -15,34 +35,85 @@ auto get_cartridge(const std::vector<u8>& rom_data, const std::vector<u8>& ram_d
         case CartridgeType::MBC1:
             return std::make_shared<MBC1>(rom_data, ram_data, std::move(info));
         case CartridgeType::MBC2:
-            fatal_error("MBC2 is unimplemented");
+            error = "MBC2 is unimplemented";
+            break;
         case CartridgeType::MBC3:
             return std::make_shared<MBC3>(rom_data, ram_data, std::move(info));
         case CartridgeType::MBC4:
-            fatal_error("MBC4 is unimplemented");
+            error = "MBC4 is unimplemented";
+            break;
         case CartridgeType::MBC5:
-            fatal_error("MBC5 is unimplemented");
+            error = "MBC5 is unimplemented";
+            break;
         case CartridgeType::Unknown:
-            fatal_error("Unknown cartridge type");
+            error = "Unknown cartridge type";
+            break;
     }
+
+    return blank_cartridge();
 }
 
-Cartridge::Cartridge(std::vector<u8> rom_data, const std::vector<u8>& ram_data,
+Cartridge::Cartridge(rom_t rom_data, const std::vector<u8>& ram_data,
                      std::unique_ptr<CartridgeInfo> in_cartridge_info)
     : rom(std::move(rom_data)), cartridge_info(std::move(in_cartridge_info)) {
-    auto ram_size_for_cartridge = get_actual_ram_size(cartridge_info->ram_size);
-
+    /* get_cartridge() has checked that any RAM given is the right size */
     if (!ram_data.empty()) {
-        if (ram_data.size() != ram_size_for_cartridge) { fatal_error("Invalid or corrupted RAM file. Read %d bytes, expected %d", ram_data.size(), ram_size_for_cartridge); }
         ram = ram_data;
     } else {
-        ram = std::vector<u8>(ram_size_for_cartridge, 0);
+        ram = std::vector<u8>(get_actual_ram_size(cartridge_info->ram_size), 0);
     }
 }
 
 auto Cartridge::get_cartridge_ram() const -> const std::vector<u8>& { return ram; }
 
-NoMBC::NoMBC(std::vector<u8> rom_data, const std::vector<u8>& ram_data,
+void Cartridge::load_cartridge_ram(const u8* data) {
+    std::copy(data, data + ram.size(), ram.begin());
+}
+
+void Cartridge::save_state(CartridgeState& state) const {
+    state = {};
+}
+
+void Cartridge::load_state(const CartridgeState& state) {
+}
+
+auto Cartridge::map_read(u16 page_address) const -> const u8* { return nullptr; }
+
+auto Cartridge::map_write(u16 page_address) -> u8* { return nullptr; }
+
+auto Cartridge::rom_page(uint offset) const -> const u8* {
+    /* Pages which would run off the end of the ROM take the slow path, where
+     * read_rom() wraps them around. They aren't mapped to the memory they
+     * wrap to, as the block cache tells code apart by its host address */
+    if (offset + 0x100 > rom->size()) { return nullptr; }
+    return &(*rom)[offset];
+}
+
+auto Cartridge::read_rom(uint offset) const -> u8 {
+    return (*rom)[offset % rom->size()];
+}
+
+auto Cartridge::read_ram(uint offset) const -> u8 {
+    if (ram.empty()) { return 0xFF; }
+    return ram[offset % ram.size()];
+}
+
+void Cartridge::write_ram(uint offset, u8 value) {
+    if (ram.empty()) { return; }
+    ram[offset % ram.size()] = value;
+}
+
+auto Cartridge::ram_page(uint offset) const -> const u8* {
+    if (offset + 0x100 > ram.size()) { return nullptr; }
+    return &ram[offset];
+}
+
+auto Cartridge::ram_page(uint offset) -> u8* {
+    if (offset + 0x100 > ram.size()) { return nullptr; }
+    return &ram[offset];
+}
+
+NoMBC::NoMBC(rom_t rom_data, const std::vector<u8>& ram_data,
              std::unique_ptr<CartridgeInfo> in_cartridge_info)
     : Cartridge(std::move(rom_data), ram_data, std::move(in_cartridge_info)) {}
 
@@ -51,11 +122,19 @@ void NoMBC::write(const Address& address, u8 value) {
 }
 
 auto NoMBC::read(const Address& address) const -> u8 {
-    /* TODO: check this address is in sensible bounds */
-    return rom.at(address.value());
+    if (address.in_range(0xA000, 0xBFFF)) {
+        return read_ram(address.value() - 0xA000);
+    }
+
+    return read_rom(address.value());
 }
 
-MBC1::MBC1(std::vector<u8> rom_data, const std::vector<u8>& ram_data,
+auto NoMBC::map_read(u16 page_address) const -> const u8* {
+    if (page_address > 0x7FFF) { return nullptr; }
+    return rom_page(page_address);
+}
+
+MBC1::MBC1(rom_t rom_data, const std::vector<u8>& ram_data,
            std::unique_ptr<CartridgeInfo> in_cartridge_info)
     : Cartridge(std::move(rom_data), ram_data, std::move(in_cartridge_info)) {
     unused(rom_banking_mode);
@@ -63,6 +142,21 @@ MBC1::MBC1(std::vector<u8> rom_data, const std::vector<u8>& ram_data,
     rom_bank.set(0x1);
 }
 
+void MBC1::save_state(CartridgeState& state) const {
+    state = {};
+    state.rom_bank = rom_bank.value();
+    state.ram_bank = ram_bank.value();
+    state.ram_enabled = ram_enabled;
+    state.rom_banking_mode = rom_banking_mode;
+}
+
+void MBC1::load_state(const CartridgeState& state) {
+    rom_bank.set(state.rom_bank);
+    ram_bank.set(state.ram_bank);
+    ram_enabled = state.ram_enabled;
+    rom_banking_mode = state.rom_banking_mode;
+}
+
 void MBC1::write(const Address& address, u8 value) {
     if (address.in_range(0x0000, 0x1FFF)) {
         ram_enabled = true;
@@ -92,13 +186,13 @@ void MBC1::write(const Address& address, u8 value) {
 
         auto offset_into_ram = 0x2000 * ram_bank.value();
         auto address_in_ram = (address - 0xA000) + offset_into_ram;
-        ram.at(address_in_ram.value()) = value;
+        write_ram(address_in_ram.value(), value);
     }
 }
 
 auto MBC1::read(const Address& address) const -> u8 {
     if (address.in_range(0x0000, 0x3FFF)) {
-        return rom.at(address.value());
+        return read_rom(address.value());
     }
 
     if (address.in_range(0x4000, 0x7FFF)) {
@@ -106,19 +200,43 @@ auto MBC1::read(const Address& address) const -> u8 {
         uint bank_offset = 0x4000 * rom_bank.value();
 
         uint address_in_rom = bank_offset + address_into_bank;
-        return rom.at(address_in_rom);
+        return read_rom(address_in_rom);
     }
 
     if (address.in_range(0xA000, 0xBFFF)) {
         auto offset_into_ram = 0x2000 * ram_bank.value();
         auto address_in_ram = (address - 0xA000) + offset_into_ram;
-        return ram.at(address_in_ram.value());
+        return read_ram(address_in_ram.value());
+    }
+
+    log_error("Attempted to read from unmapped MBC1 address 0x%x", address.value());
+    return 0xFF;
+}
+
+auto MBC1::map_read(u16 page_address) const -> const u8* {
+    if (page_address <= 0x3FFF) {
+        return rom_page(page_address);
+    }
+
+    if (page_address <= 0x7FFF) {
+        return rom_page((0x4000 * rom_bank.value()) + (page_address - 0x4000));
+    }
+
+    if (page_address >= 0xA000 && page_address <= 0xBFFF) {
+        return ram_page((0x2000 * ram_bank.value()) + (page_address - 0xA000));
     }
 
-    fatal_error("Attempted to read from unmapped MBC1 address 0x%x", address.value());
+    return nullptr;
+}
+
+auto MBC1::map_write(u16 page_address) -> u8* {
+    if (page_address < 0xA000 || page_address > 0xBFFF) { return nullptr; }
+    if (!ram_enabled) { return nullptr; }
+
+    return ram_page((0x2000 * ram_bank.value()) + (page_address - 0xA000));
 }
 
-MBC3::MBC3(std::vector<u8> rom_data, const std::vector<u8>& ram_data,
+MBC3::MBC3(rom_t rom_data, const std::vector<u8>& ram_data,
            std::unique_ptr<CartridgeInfo> in_cartridge_info)
     : Cartridge(std::move(rom_data), ram_data, std::move(in_cartridge_info)) {
     unused(rom_banking_mode);
@@ -126,6 +244,23 @@ MBC3::MBC3(std::vector<u8> rom_data, const std::vector<u8>& ram_data,
     rom_bank.set(0x1);
 }
 
+void MBC3::save_state(CartridgeState& state) const {
+    state = {};
+    state.rom_bank = rom_bank.value();
+    state.ram_bank = ram_bank.value();
+    state.ram_enabled = ram_enabled;
+    state.ram_over_rtc = ram_over_rtc;
+    state.rom_banking_mode = rom_banking_mode;
+}
+
+void MBC3::load_state(const CartridgeState& state) {
+    rom_bank.set(state.rom_bank);
+    ram_bank.set(state.ram_bank);
+    ram_enabled = state.ram_enabled;
+    ram_over_rtc = state.ram_over_rtc;
+    rom_banking_mode = state.rom_banking_mode;
+}
+
 void MBC3::write(const Address& address, u8 value) {
     if (address.in_range(0x0000, 0x1FFF)) {
         if (value == 0x0A) {
@@ -166,14 +301,14 @@ void MBC3::write(const Address& address, u8 value) {
         if (ram_over_rtc) {
             auto offset_into_ram = 0x2000 * ram_bank.value();
             auto address_in_ram = (address - 0xA000) + offset_into_ram;
-            ram.at(address_in_ram.value()) = value;
+            write_ram(address_in_ram.value(), value);
         }
     }
 }
 
 auto MBC3::read(const Address& address) const -> u8 {
     if (address.in_range(0x0000, 0x3FFF)) {
-        return rom.at(address.value());
+        return read_rom(address.value());
     }
 
     if (address.in_range(0x4000, 0x7FFF)) {
@@ -181,14 +316,38 @@ auto MBC3::read(const Address& address) const -> u8 {
         uint bank_offset = 0x4000 * rom_bank.value();
 
         uint address_in_rom = bank_offset + address_into_bank;
-        return rom.at(address_in_rom);
+        return read_rom(address_in_rom);
     }
 
     if (address.in_range(0xA000, 0xBFFF)) {
         auto offset_into_ram = 0x2000 * ram_bank.value();
         auto address_in_ram = (address - 0xA000) + offset_into_ram;
-        return ram.at(address_in_ram.value());
+        return read_ram(address_in_ram.value());
+    }
+
+    log_error("Attempted to read from unmapped MBC3 address 0x%x", address.value());
+    return 0xFF;
+}
+
+auto MBC3::map_read(u16 page_address) const -> const u8* {
+    if (page_address <= 0x3FFF) {
+        return rom_page(page_address);
     }
 
-    fatal_error("Attempted to read from unmapped MBC1 address 0x%x", address.value());
+    if (page_address <= 0x7FFF) {
+        return rom_page((0x4000 * rom_bank.value()) + (page_address - 0x4000));
+    }
+
+    if (page_address >= 0xA000 && page_address <= 0xBFFF) {
+        return ram_page((0x2000 * ram_bank.value()) + (page_address - 0xA000));
+    }
+
+    return nullptr;
+}
+
+auto MBC3::map_write(u16 page_address) -> u8* {
+    if (page_address < 0xA000 || page_address > 0xBFFF) { return nullptr; }
+    if (!(ram_enabled && ram_over_rtc)) { return nullptr; }
+
+    return ram_page((0x2000 * ram_bank.value()) + (page_address - 0xA000));
 }
@@ -8,44 +8,93 @@
 #include <vector>
 #include <memory>
 
+/* The memory bank controller's registers, for save states (see save_state.h).
+ * Cartridge RAM is saved separately, as its size depends on the game */
+struct CartridgeState {
+    u16 rom_bank;
+    u16 ram_bank;
+    bool ram_enabled;
+    bool ram_over_rtc;
+    bool rom_banking_mode;
+};
+
+/* ROMs are never written to, so instances running the same game can share
+ * one copy */
+using rom_t = std::shared_ptr<const std::vector<u8>>;
+
 class Cartridge {
 public:
-    Cartridge(std::vector<u8> rom_data, const std::vector<u8>& ram_data,
+    Cartridge(rom_t rom_data, const std::vector<u8>& ram_data,
               std::unique_ptr<CartridgeInfo> cartridge_info);
     virtual ~Cartridge() = default;
 
     virtual auto read(const Address& address) const -> u8 = 0;
     virtual void write(const Address& address, u8 value) = 0;
 
+    /* Host memory backing the 256-byte page starting at the given address, or
+     * null if accesses to that page must go through read()/write(). Mappings
+     * can change whenever the cartridge is written to */
+    virtual auto map_read(u16 page_address) const -> const u8*;
+    virtual auto map_write(u16 page_address) -> u8*;
+
     auto get_cartridge_ram() const -> const std::vector<u8>&;
+    void load_cartridge_ram(const u8* data);
+
+    auto get_info() const -> const CartridgeInfo& { return *cartridge_info; }
+
+    virtual void save_state(CartridgeState& state) const;
+    virtual void load_state(const CartridgeState& state);
 
 protected:
-    std::vector<u8> rom;
+    /* Banks past the end of the ROM or RAM wrap around, as the MBC ignores
+     * the bank bits which the cartridge doesn't have */
+    auto read_rom(uint offset) const -> u8;
+    auto read_ram(uint offset) const -> u8;
+    void write_ram(uint offset, u8 value);
+
+    auto rom_page(uint offset) const -> const u8*;
+    auto ram_page(uint offset) const -> const u8*;
+    auto ram_page(uint offset) -> u8*;
+
+    rom_t rom;
     std::vector<u8> ram;
 
     std::unique_ptr<CartridgeInfo> cartridge_info;
 };
 
-auto get_cartridge(const std::vector<u8>& rom_data, const std::vector<u8>& ram_data = {})
+/* Headers end at 0x150 */
+const size_t MINIMUM_ROM_SIZE = 0x150;
+
+/* If the game can't be loaded, sets `error` and returns a blank cartridge in
+ * its place */
+auto get_cartridge(rom_t rom_data, const std::vector<u8>& ram_data, std::string& error)
     -> std::shared_ptr<Cartridge>;
 
 class NoMBC : public Cartridge {
 public:
-    NoMBC(std::vector<u8> rom_data, const std::vector<u8>& ram_data,
+    NoMBC(rom_t rom_data, const std::vector<u8>& ram_data,
           std::unique_ptr<CartridgeInfo> cartridge_info);
 
     auto read(const Address& address) const -> u8 override;
     void write(const Address& address, u8 value) override;
+
+    auto map_read(u16 page_address) const -> const u8* override;
 };
 
 class MBC1 : public Cartridge {
 public:
-    MBC1(std::vector<u8> rom_data, const std::vector<u8>& ram_data,
+    MBC1(rom_t rom_data, const std::vector<u8>& ram_data,
          std::unique_ptr<CartridgeInfo> cartridge_info);
 
     auto read(const Address& address) const -> u8 override;
     void write(const Address& address, u8 value) override;
 
+    auto map_read(u16 page_address) const -> const u8* override;
+    auto map_write(u16 page_address) -> u8* override;
+
+    void save_state(CartridgeState& state) const override;
+    void load_state(const CartridgeState& state) override;
+
 private:
     WordRegister rom_bank;
     WordRegister ram_bank;
@@ -59,12 +108,18 @@ private:
 
 class MBC3 : public Cartridge {
 public:
-    MBC3(std::vector<u8> rom_data, const std::vector<u8>& ram_data,
+    MBC3(rom_t rom_data, const std::vector<u8>& ram_data,
          std::unique_ptr<CartridgeInfo> cartridge_info);
 
     auto read(const Address& address) const -> u8 override;
     void write(const Address& address, u8 value) override;
 
+    auto map_read(u16 page_address) const -> const u8* override;
+    auto map_write(u16 page_address) -> u8* override;
+
+    void save_state(CartridgeState& state) const override;
+    void load_state(const CartridgeState& state) override;
+
 private:
     WordRegister rom_bank;
     WordRegister ram_bank;
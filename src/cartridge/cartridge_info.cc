@@ -2,7 +2,7 @@
 
 #include "../util/log.h"
 
-auto get_info(std::vector<u8> rom) -> std::unique_ptr<CartridgeInfo> {
+auto get_info(const std::vector<u8>& rom) -> std::unique_ptr<CartridgeInfo> {
     std::unique_ptr<CartridgeInfo> info = std::make_unique<CartridgeInfo>();
 
     u8 type_code = rom[header::cartridge_type];
@@ -16,11 +16,9 @@ auto get_info(std::vector<u8> rom) -> std::unique_ptr<CartridgeInfo> {
     info->ram_size = get_ram_size(ram_size_code);
     info->title = get_title(rom);
 
-    log_info("Title:\t\t %s (version %d)", info->title.c_str(), info->version);
-    log_info("Cartridge:\t\t %s", describe(info->type).c_str());
-    log_info("Rom Size:\t\t %s", describe(info->rom_size).c_str());
-    log_info("Ram Size:\t\t %s", describe(info->ram_size).c_str());
-    log_info("");
+    /* The global checksum is big-endian, unlike everything else */
+    info->header_checksum = rom[header::header_checksum];
+    info->global_checksum = static_cast<u16>((rom[header::global_checksum] << 8) | rom[header::global_checksum + 1]);
 
     return info;
 }
@@ -240,8 +238,17 @@ auto describe(Destination destination) -> std::string {
     }
 }
 
-auto get_title(std::vector<u8>& rom) -> std::string {
-    char name[TITLE_LENGTH] = {0};
+void log_cartridge_info(const CartridgeInfo& info) {
+    log_info("Title:\t\t %s (version %d)", info.title.c_str(), info.version);
+    log_info("Cartridge:\t\t %s", describe(info.type).c_str());
+    log_info("Rom Size:\t\t %s", describe(info.rom_size).c_str());
+    log_info("Ram Size:\t\t %s", describe(info.ram_size).c_str());
+    log_info("");
+}
+
+auto get_title(const std::vector<u8>& rom) -> std::string {
+    /* Titles which use every byte have no terminator of their own */
+    char name[TITLE_LENGTH + 1] = {0};
 
     for (u8 i = 0; i < TITLE_LENGTH; i++) {
         name[i] = static_cast<char>(rom[header::title + i]);
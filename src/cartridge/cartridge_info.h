@@ -39,7 +39,7 @@ enum class CartridgeType {
 extern auto get_type(u8 type) -> CartridgeType;
 extern auto describe(CartridgeType type) -> std::string;
 
-extern auto get_title(std::vector<u8>& rom) -> std::string;
+extern auto get_title(const std::vector<u8>& rom) -> std::string;
 
 extern auto get_license(u16 old_license, u16 new_license) -> std::string;
 
@@ -100,4 +100,5 @@ public:
     bool supports_sgb;
 };
 
-extern auto get_info(std::vector<u8> rom) -> std::unique_ptr<CartridgeInfo>;
+extern auto get_info(const std::vector<u8>& rom) -> std::unique_ptr<CartridgeInfo>;
+extern void log_cartridge_info(const CartridgeInfo& info);
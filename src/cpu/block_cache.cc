@@ -0,0 +1,140 @@
+#include "block_cache.h"
+
+#include "cpu.h"
+#include "../mmu.h"
+
+/* Upper bound on the length of a block, so that decoding a page of data which
+ * happens to be executed doesn't produce one huge block */
+static const uint max_block_length = 64;
+
+static auto ends_block(u8 opcode) -> bool {
+    switch (opcode) {
+        /* JR */
+        case 0x18: case 0x20: case 0x28: case 0x30: case 0x38:
+        /* JP */
+        case 0xC2: case 0xC3: case 0xCA: case 0xD2: case 0xDA: case 0xE9:
+        /* CALL */
+        case 0xC4: case 0xCC: case 0xCD: case 0xD4: case 0xDC:
+        /* RET, RETI */
+        case 0xC0: case 0xC8: case 0xC9: case 0xD0: case 0xD8: case 0xD9:
+        /* RST */
+        case 0xC7: case 0xCF: case 0xD7: case 0xDF: case 0xE7: case 0xEF: case 0xF7: case 0xFF:
+        /* HALT, STOP */
+        case 0x76: case 0x10:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+static auto is_ram(u16 address) -> bool { return address >= 0xC000; }
+
+BlockCache::BlockCache(MMU& inMMU) : mmu(inMMU) {}
+
+auto BlockCache::lookup(u16 address) -> Block* {
+    const u8* key = mmu.code_pointer(address);
+    if (key == nullptr) { return nullptr; }
+
+    auto cached = blocks.find(key);
+    if (cached != blocks.end()) { return cached->second.get(); }
+
+    auto block = decode(key, address);
+    if (block->instructions.empty()) { return nullptr; }
+
+    Block* decoded = block.get();
+    blocks[key] = std::move(block);
+
+    if (is_ram(address)) {
+        u8 page = static_cast<u8>(address >> 8);
+        ram_blocks[page].push_back(decoded);
+        mmu.protect_code_page(page);
+    }
+
+    return decoded;
+}
+
+auto BlockCache::decode(const u8* key, const u16 address) -> std::unique_ptr<Block> {
+    /* Stop at the end of the page, as the next page may be mapped elsewhere */
+    uint available = address >= 0xFF80 ? 0xFFFF - address : 0x100 - (address & 0xFF);
+
+    auto block = std::make_unique<Block>();
+    block->key = key;
+    block->start = address;
+
+    uint offset = 0;
+    while (offset < available && block->instructions.size() < max_block_length) {
+        u8 opcode = key[offset];
+        u8 length = CPU::opcodes[opcode].length;
+
+        if (offset + length > available) { break; }
+
+        DecodedInstruction instruction = {};
+        instruction.address = static_cast<u16>(address + offset);
+        instruction.length = length;
+        for (uint i = 0; i < length; i++) {
+            instruction.bytes[i] = key[offset + i];
+        }
+
+        block->instructions.push_back(instruction);
+        offset += length;
+
+        if (ends_block(opcode)) { break; }
+    }
+
+    block->end = static_cast<u16>(address + offset);
+    return block;
+}
+
+void BlockCache::invalidate(const u16 address) {
+    u8 page = static_cast<u8>(address >> 8);
+    auto& page_blocks = ram_blocks[page];
+
+    bool invalidated = false;
+    for (auto it = page_blocks.begin(); it != page_blocks.end();) {
+        const Block* block = *it;
+
+        if (address >= block->start && address < block->end) {
+            const u8* key = block->key;
+            it = page_blocks.erase(it);
+            blocks.erase(key);
+            invalidated = true;
+        } else {
+            ++it;
+        }
+    }
+
+    if (page_blocks.empty()) { mmu.unprotect_code_page(page); }
+    if (invalidated) { current_generation++; }
+}
+
+void BlockCache::mapping_changed() {
+    current_generation++;
+}
+
+void BlockCache::clear_ram() {
+    for (uint page = 0; page < ram_blocks.size(); page++) {
+        if (ram_blocks[page].empty()) { continue; }
+
+        for (const Block* block : ram_blocks[page]) {
+            blocks.erase(block->key);
+        }
+
+        ram_blocks[page].clear();
+        mmu.unprotect_code_page(static_cast<u8>(page));
+    }
+
+    current_generation++;
+}
+
+void BlockCache::clear() {
+    for (uint page = 0; page < ram_blocks.size(); page++) {
+        if (ram_blocks[page].empty()) { continue; }
+
+        ram_blocks[page].clear();
+        mmu.unprotect_code_page(static_cast<u8>(page));
+    }
+
+    blocks.clear();
+    current_generation++;
+}
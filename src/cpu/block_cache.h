@@ -0,0 +1,86 @@
+#pragma once
+
+#include "../definitions.h"
+
+#include <array>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+class MMU;
+
+/* A single instruction, decoded ahead of time so that it can be executed
+ * without fetching its bytes through the MMU again */
+struct DecodedInstruction {
+    u16 address;
+    u8 length;
+
+    /* The opcode (or 0xCB followed by the CB opcode), then any operands */
+    std::array<u8, 3> bytes;
+};
+
+/* A straight-line run of instructions ending at the first branch, or at the
+ * end of the 256-byte page it starts in */
+struct Block {
+    /* Host address of the first instruction's bytes. Banked ROM maps each bank
+     * to different host memory, so this identifies both the bank and the PC */
+    const u8* key;
+
+    u16 start;
+    u16 end;
+
+    std::vector<DecodedInstruction> instructions;
+
+    /* How often the block has been entered, and native code for the first
+     * native_length instructions once the JIT has compiled it, which takes
+     * at most native_cycles to run */
+    uint executions = 0;
+    const u8* native_code = nullptr;
+    uint native_length = 0;
+    uint native_cycles = 0;
+    bool native_failed = false;
+};
+
+/*
+ * Cache of decoded blocks for the cached interpreter.
+ *
+ * Only code in ROM, work RAM and high RAM is cached. Pages of work RAM and
+ * high RAM containing cached code are write-protected in the MMU, so writes to
+ * them reach invalidate() and any blocks overlapping the written address are
+ * thrown away. Bank switches don't need to discard anything (the blocks for
+ * the old bank stay valid for when it is mapped back in), but the CPU has to
+ * look its current block up again.
+ *
+ * Every change which could make a block the CPU holds on to stale bumps
+ * generation(), which is cheaper than tracking who holds which block.
+ */
+class BlockCache {
+public:
+    explicit BlockCache(MMU& inMMU);
+
+    /* Find or decode the block starting at the given address. Returns null if
+     * code at that address can't be cached */
+    auto lookup(u16 address) -> Block*;
+
+    void invalidate(u16 address);
+    void mapping_changed();
+    void clear();
+
+    /* Throw away every block decoded from RAM, keeping those in ROM. For
+     * when RAM is replaced wholesale, e.g. by loading a save state */
+    void clear_ram();
+
+    auto generation() const -> uint { return current_generation; }
+
+private:
+    auto decode(const u8* key, u16 address) -> std::unique_ptr<Block>;
+
+    MMU& mmu;
+
+    std::unordered_map<const u8*, std::unique_ptr<Block>> blocks;
+
+    /* Blocks decoded from RAM, by the page they start in */
+    std::array<std::vector<const Block*>, 0x100> ram_blocks;
+
+    uint current_generation = 0;
+};
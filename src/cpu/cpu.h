@@ -2,10 +2,35 @@
 
 #include "../address.h"
 #include "../register.h"
+#include "registers.h"
 #include "../options.h"
+#include "block_cache.h"
+#include "idle_loop.h"
+#include "jit/jit.h"
+
+#if defined(GBEMU_TRACE)
+#include "trace.h"
+#endif
+
+#include <array>
+#include <memory>
+
+/* Computed goto is a GNU extension, so fall back to the dispatch table elsewhere */
+#if defined(GBEMU_DISPATCH_THREADED) && !defined(__GNUC__)
+#undef GBEMU_DISPATCH_THREADED
+#endif
 
 class Gameboy;
 
+/* Everything needed to restore the CPU (see save_state.h) */
+struct CPUState {
+    RegisterFile regs;
+    u8 interrupt_flag;
+    u8 interrupt_enabled;
+    bool interrupts_enabled;
+    bool halted;
+};
+
 enum class Condition {
     NZ,
     Z,
@@ -39,15 +64,62 @@ public:
 
     auto tick() -> Cycles;
 
+    /* Halted until an interrupt fires, so there's nothing to do but wait */
+    auto is_halted() const -> bool { return halted; }
+
+    auto idle_loop_stats() const -> const IdleLoopStats& { return idle_loops.stats(); }
+
+    /* Frames run ahead are thrown away, so they mustn't end emulation (see
+     * Options::exit_on_infinite_jr); the real frames get there later */
+    void set_speculative(bool is_speculative) { speculative = is_speculative; }
+
+    /* Saving writes any pending flags into F first */
+    void save_state(CPUState& state);
+    void load_state(const CPUState& state);
+
     auto execute_opcode(u8 opcode, u16 opcode_pc) -> Cycles;
 
     auto execute_normal_opcode(u8 opcode, u16 opcode_pc) -> Cycles;
     auto execute_cb_opcode(u8 opcode, u16 opcode_pc) -> Cycles;
 
+#if defined(GBEMU_DISPATCH_THREADED)
+    /* Only the plain interpreter, with nothing watching individual
+     * instructions, can run more than one at a time */
+    auto can_run_threaded() const -> bool;
+
+    /* Run instructions back to back until the next scheduled event, or until
+     * tick() is needed to take an interrupt or wait in HALT */
+    void run_threaded();
+#endif
+
     ByteRegister interrupt_flag;
     ByteRegister interrupt_enabled;
 
+    BlockCache block_cache;
+
+    /* A single entry in the opcode dispatch tables, also used by the block
+     * cache and the JIT to decode instructions */
+    struct Opcode {
+        void (CPU::*handler)();
+        u8 cycles;
+        u8 cycles_branched;
+        u8 length;
+    };
+
+    static const std::array<Opcode, 256> opcodes;
+    static const std::array<Opcode, 256> cb_opcodes;
+
+    /* Write any flags which are still pending into F, so that F (and AF) can
+     * be read directly. Does nothing unless GBEMU_LAZY_FLAGS is set */
+    void materialize_flags();
+
 private:
+    auto tick_cached() -> Cycles;
+    auto execute_native() -> Cycles;
+
+    auto jit_state() const -> JitState;
+    void load_jit_state(const JitState& state);
+
     void handle_interrupts();
     auto handle_interrupt(u8 interrupt_bit, u16 interrupt_vector, u8 fired_interrupts) -> bool;
 
@@ -56,49 +128,78 @@ private:
 
     bool interrupts_enabled = false;
     bool halted = false;
+    bool speculative = false;
 
     bool branch_taken = false;
 
-    /* Basic registers */
-    ByteRegister a, b, c, d, e, h, l;
+    /* Cached interpreter state: the block being executed, and the operands of
+     * the current instruction if it was decoded ahead of time */
+    Block* current_block = nullptr;
+    uint block_index = 0;
+    uint block_generation = 0;
+    const u8* decoded_operands = nullptr;
+
+    JIT jit;
+
+    IdleLoopDetector idle_loops;
+
+#if defined(GBEMU_TRACE)
+    std::unique_ptr<Tracer> tracer;
+
+    void trace(u16 opcode_pc, u8 opcode, bool prefixed);
+#endif
+
+    RegisterFile regs = {};
+
+#if defined(GBEMU_LAZY_FLAGS)
+    /* The 8-bit arithmetic and logic instructions don't write their flags to
+     * F, they only record what's needed to work them out later. Most of the
+     * time the next such instruction comes along before anything has looked
+     * at F, and the flags are never computed at all */
+    enum class FlagOp : u8 { None, Add, Adc, Sub, Sbc, And, Or, Xor, Inc, Dec };
+
+    struct PendingFlags {
+        FlagOp op = FlagOp::None;
+        u8 lhs = 0;
+        u8 rhs = 0;
+        u8 result = 0;
 
-    /* 'Group' registers for operations which use two registers as a word */
-    RegisterPair af;
-    RegisterPair bc;
-    RegisterPair de;
-    RegisterPair hl;
+        /* Carry into ADC/SBC, or the carry flag left alone by INC/DEC */
+        u8 carry = 0;
+    };
 
-    /*
-     * Flags set dependant on the result of the last operation
-     *  0x80 - produced 0
-     *  0x40 - was a subtraction
-     *  0x20 - lower half of the byte overflowed 15
-     *  0x10 - overflowed 255 or underflowed 0 for additions/subtractions
-     */
-    FlagRegister f;
+    PendingFlags pending_flags;
+
+    void defer_flags(FlagOp op, u8 lhs, u8 rhs, u8 result, u8 carry = 0);
+    auto pending_flags_value() const -> u8;
+#endif
+
+    /* F, including any flags which are still pending */
+    auto flags_value() const -> u8;
 
     void set_flag_zero(bool set);
     void set_flag_subtract(bool set);
     void set_flag_half_carry(bool set);
     void set_flag_carry(bool set);
 
+    auto flag_zero() const -> bool;
+    auto flag_subtract() const -> bool;
+    auto flag_half_carry() const -> bool;
+    auto flag_carry() const -> bool;
+
+    auto flag_carry_value() const -> u8;
+
     /* Note: Not const because this also sets the 'branch_taken' member
      * variable if a branch is taken. This allows the correct cycle
      * count to be used */
     auto is_condition(Condition condition) -> bool;
 
-    /* Program counter */
-    WordRegister pc;
-
-    /* Stack pointer */
-    WordRegister sp;
-
     auto get_byte_from_pc() -> u8;
     auto get_signed_byte_from_pc() -> s8;
     auto get_word_from_pc() -> u16;
 
-    void stack_push(const WordValue& reg);
-    void stack_pop(WordValue& reg);
+    void stack_push(u16 value);
+    void stack_pop(u16& reg);
 
     /* Opcode Helper Functions */
 
@@ -106,19 +207,18 @@ private:
     void _opcode_adc(u8 value);
 
     void opcode_adc();
-    void opcode_adc(const ByteRegister& reg);
+    void opcode_adc(u8 value);
     void opcode_adc(const Address&& addr);
 
     /* ADD */
     void _opcode_add(u8 reg, u8 value);
 
     void opcode_add_a();
-    void opcode_add_a(const ByteRegister& reg);
+    void opcode_add_a(u8 value);
     void opcode_add_a(const Address& addr);
 
     void _opcode_add_hl(u16 value);
-    void opcode_add_hl(const RegisterPair& reg_pair);
-    void opcode_add_hl(const WordRegister& word_reg);
+    void opcode_add_hl(u16 value);
 
     void opcode_add_sp();
 
@@ -128,13 +228,13 @@ private:
     void _opcode_and(u8 value);
 
     void opcode_and();
-    void opcode_and(ByteRegister& reg);
+    void opcode_and(u8 value);
     void opcode_and(Address&& addr);
 
     /* BIT */
     void _opcode_bit(u8 bit, u8 value);
 
-    void opcode_bit(u8 bit, ByteRegister& reg);
+    void opcode_bit(u8 bit, u8 value);
     void opcode_bit(u8 bit, Address&& addr);
 
     /* CALL */
@@ -148,7 +248,7 @@ private:
     void _opcode_cp(u8 value);
 
     void opcode_cp();
-    void opcode_cp(const ByteRegister& reg);
+    void opcode_cp(u8 value);
     void opcode_cp(const Address& addr);
 
     /* CPL */
@@ -158,9 +258,8 @@ private:
     void opcode_daa();
 
     /* DEC */
-    void opcode_dec(ByteRegister& reg);
-    void opcode_dec(RegisterPair& reg);
-    void opcode_dec(WordRegister& reg);
+    void opcode_dec(u8& reg);
+    void opcode_dec(u16& reg);
     void opcode_dec(Address&& addr);
 
     /* DI */
@@ -170,9 +269,8 @@ private:
     void opcode_ei();
 
     /* INC */
-    void opcode_inc(ByteRegister& reg);
-    void opcode_inc(RegisterPair& reg);
-    void opcode_inc(WordRegister& reg);
+    void opcode_inc(u8& reg);
+    void opcode_inc(u16& reg);
     void opcode_inc(Address&& addr);
 
     /* JP */
@@ -188,28 +286,27 @@ private:
     void opcode_halt();
 
     /* LD */
-    void opcode_ld(ByteRegister& reg);
-    void opcode_ld(ByteRegister& reg, const ByteRegister& byte_reg);
-    void opcode_ld(ByteRegister& reg, const Address& address);
+    void opcode_ld(u8& reg);
+    void opcode_ld(u8& reg, u8 value);
+    void opcode_ld(u8& reg, const Address& address);
 
-    void opcode_ld(RegisterPair& reg);
+    void opcode_ld(u16& reg);
 
-    void opcode_ld(WordRegister& reg);
-    void opcode_ld(WordRegister& reg, const RegisterPair& reg_pair);
+    void opcode_ld(u16& reg, u16 value);
 
     void opcode_ld(const Address& address);
-    void opcode_ld(const Address& address, const ByteRegister& byte_reg);
-    void opcode_ld(const Address& address, const WordRegister& word_reg);
+    void opcode_ld(const Address& address, u8 value);
+    void opcode_ld(const Address& address, u16 value);
 
     // (nn), A
-    void opcode_ld_to_addr(const ByteRegister& reg);
-    void opcode_ld_from_addr(ByteRegister& reg);
+    void opcode_ld_to_addr(u8 value);
+    void opcode_ld_from_addr(u8& reg);
 
     /* LDD */
     auto _opcode_ldd(u8 value) -> u8;
 
-    void opcode_ldd(ByteRegister& reg, const Address& address);
-    void opcode_ldd(const Address& address, const ByteRegister& reg);
+    void opcode_ldd(u8& reg, const Address& address);
+    void opcode_ldd(const Address& address, u8 value);
 
     /* LDH */
     // A, (n)
@@ -225,8 +322,8 @@ private:
     void opcode_ldhl();
 
     /* LDI */
-    void opcode_ldi(ByteRegister& reg, const Address& address);
-    void opcode_ldi(const Address& address, const ByteRegister& reg);
+    void opcode_ldi(u8& reg, const Address& address);
+    void opcode_ldi(const Address& address, u8 value);
 
     /* NOP */
     void opcode_nop();
@@ -235,17 +332,18 @@ private:
     void _opcode_or(u8 value);
 
     void opcode_or();
-    void opcode_or(const ByteRegister& reg);
+    void opcode_or(u8 value);
     void opcode_or(const Address& addr);
 
     /* POP */
-    void opcode_pop(RegisterPair& reg);
+    void opcode_pop(u16& reg);
+    void opcode_pop_af();
 
     /* PUSH */
-    void opcode_push(const RegisterPair& reg);
+    void opcode_push(u16 value);
 
     /* RES */
-    void opcode_res(u8 bit, ByteRegister& reg);
+    void opcode_res(u8 bit, u8& reg);
     void opcode_res(u8 bit, Address&& addr);
 
     /* RET */
@@ -259,28 +357,28 @@ private:
     auto _opcode_rl(u8 value) -> u8;
 
     void opcode_rla();
-    void opcode_rl(ByteRegister& reg);
+    void opcode_rl(u8& reg);
     void opcode_rl(Address&& addr);
 
     /* RLC */
     auto _opcode_rlc(u8 value) -> u8;
 
     void opcode_rlca();
-    void opcode_rlc(ByteRegister& reg);
+    void opcode_rlc(u8& reg);
     void opcode_rlc(Address&& addr);
 
     /* RR */
     auto _opcode_rr(u8 value) -> u8;
 
     void opcode_rra();
-    void opcode_rr(ByteRegister& reg);
+    void opcode_rr(u8& reg);
     void opcode_rr(Address&& addr);
 
     /* RRC */
     auto _opcode_rrc(u8 value) -> u8;
 
     void opcode_rrca();
-    void opcode_rrc(ByteRegister& reg);
+    void opcode_rrc(u8& reg);
     void opcode_rrc(Address&& addr);
 
     /* RST */
@@ -290,32 +388,32 @@ private:
     void _opcode_sbc(u8 value);
 
     void opcode_sbc();
-    void opcode_sbc(ByteRegister& reg);
+    void opcode_sbc(u8 value);
     void opcode_sbc(Address&& addr);
 
     /* SCF */
     void opcode_scf();
 
     /* SET */
-    void opcode_set(u8 bit, ByteRegister& reg);
+    void opcode_set(u8 bit, u8& reg);
     void opcode_set(u8 bit, Address&& addr);
 
     /* SLA */
     auto _opcode_sla(u8 value) -> u8;
 
-    void opcode_sla(ByteRegister& reg);
+    void opcode_sla(u8& reg);
     void opcode_sla(Address&& addr);
 
     /* SRA */
     auto _opcode_sra(u8 value) -> u8;
 
-    void opcode_sra(ByteRegister& reg);
+    void opcode_sra(u8& reg);
     void opcode_sra(Address&& addr);
 
     /* SRL */
     auto _opcode_srl(u8 value) -> u8;
 
-    void opcode_srl(ByteRegister& reg);
+    void opcode_srl(u8& reg);
     void opcode_srl(Address&& addr);
 
     /* STOP */
@@ -325,20 +423,20 @@ private:
     void _opcode_sub(u8 value);
 
     void opcode_sub();
-    void opcode_sub(ByteRegister& reg);
+    void opcode_sub(u8 value);
     void opcode_sub(Address&& addr);
 
     /* SWAP */
     auto _opcode_swap(u8 value) -> u8;
 
-    void opcode_swap(ByteRegister& reg);
+    void opcode_swap(u8& reg);
     void opcode_swap(Address&& addr);
 
     /* XOR */
     void _opcode_xor(u8 value);
 
     void opcode_xor();
-    void opcode_xor(const ByteRegister& reg);
+    void opcode_xor(u8 value);
     void opcode_xor(const Address& addr);
 
 
@@ -382,3 +480,56 @@ private:
 
     friend class Debugger;
 };
+
+#if defined(GBEMU_LAZY_FLAGS)
+inline void CPU::materialize_flags() {
+    if (pending_flags.op == FlagOp::None) { return; }
+
+    regs.f = pending_flags_value();
+    pending_flags.op = FlagOp::None;
+}
+
+inline void CPU::defer_flags(FlagOp op, u8 lhs, u8 rhs, u8 result, u8 carry) {
+    pending_flags.op = op;
+    pending_flags.lhs = lhs;
+    pending_flags.rhs = rhs;
+    pending_flags.result = result;
+    pending_flags.carry = carry;
+}
+
+inline auto CPU::flags_value() const -> u8 {
+    return pending_flags.op == FlagOp::None ? regs.f : pending_flags_value();
+}
+#else
+inline void CPU::materialize_flags() {}
+
+inline auto CPU::flags_value() const -> u8 { return regs.f; }
+#endif
+
+inline void CPU::set_flag_zero(bool set) {
+    materialize_flags();
+    regs.f = static_cast<u8>(set ? (regs.f | flags::zero) : (regs.f & ~flags::zero));
+}
+
+inline void CPU::set_flag_subtract(bool set) {
+    materialize_flags();
+    regs.f = static_cast<u8>(set ? (regs.f | flags::subtract) : (regs.f & ~flags::subtract));
+}
+
+inline void CPU::set_flag_half_carry(bool set) {
+    materialize_flags();
+    regs.f = static_cast<u8>(set ? (regs.f | flags::half_carry) : (regs.f & ~flags::half_carry));
+}
+
+inline void CPU::set_flag_carry(bool set) {
+    materialize_flags();
+    regs.f = static_cast<u8>(set ? (regs.f | flags::carry) : (regs.f & ~flags::carry));
+}
+
+
+inline auto CPU::flag_zero() const -> bool { return (flags_value() & flags::zero) != 0; }
+inline auto CPU::flag_subtract() const -> bool { return (flags_value() & flags::subtract) != 0; }
+inline auto CPU::flag_half_carry() const -> bool { return (flags_value() & flags::half_carry) != 0; }
+inline auto CPU::flag_carry() const -> bool { return (flags_value() & flags::carry) != 0; }
+
+inline auto CPU::flag_carry_value() const -> u8 { return flag_carry() ? 1 : 0; }
@@ -0,0 +1,1101 @@
+#include "cpu.h"
+
+#if defined(GBEMU_DISPATCH_THREADED)
+
+#include "../gameboy.h"
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wgnu-label-as-value"
+
+auto CPU::can_run_threaded() const -> bool {
+#if defined(GBEMU_TRACE)
+    if (tracer) { return false; }
+#endif
+
+    return options.cpu_engine == CPUEngine::Interpreter
+        && !options.debugger
+        && !options.skip_idle_loops;
+}
+
+/*
+ * Every handler ends by fetching the next opcode and jumping straight to its
+ * handler, so there's a separate indirect branch after each one for the
+ * host's predictor to learn, rather than the single shared one in the table
+ * and switch variants. The loop ends wherever CPU::tick() would do something
+ * other than execute the next instruction: at the next event (which may have
+ * been brought forward by the last instruction), when an interrupt is to be
+ * taken, on HALT, or once the instance has been stopped (e.g. by a fault).
+ */
+#define DISPATCH() \
+    do { \
+        bool interrupt = interrupts_enabled && (interrupt_flag.value() & interrupt_enabled.value()); \
+        if (scheduler.now() >= scheduler.next_event_time() || halted || interrupt || gb.stopping) { return; } \
+        branch_taken = false; \
+        goto *labels[get_byte_from_pc()]; \
+    } while (false)
+
+#define NORMAL_OPCODE(code) \
+    op_##code: \
+        opcode_##code(); \
+        scheduler.advance((!branch_taken ? opcodes[0x##code].cycles : opcodes[0x##code].cycles_branched) * CLOCKS_PER_CYCLE); \
+        DISPATCH();
+
+#define CB_OPCODE(code) \
+    cb_op_##code: \
+        opcode_CB_##code(); \
+        scheduler.advance(cb_opcodes[0x##code].cycles * CLOCKS_PER_CYCLE); \
+        DISPATCH();
+
+/* clang-format off */
+void CPU::run_threaded() {
+    static void* const labels[256] = {
+        &&op_00,
+        &&op_01,
+        &&op_02,
+        &&op_03,
+        &&op_04,
+        &&op_05,
+        &&op_06,
+        &&op_07,
+        &&op_08,
+        &&op_09,
+        &&op_0A,
+        &&op_0B,
+        &&op_0C,
+        &&op_0D,
+        &&op_0E,
+        &&op_0F,
+        &&op_10,
+        &&op_11,
+        &&op_12,
+        &&op_13,
+        &&op_14,
+        &&op_15,
+        &&op_16,
+        &&op_17,
+        &&op_18,
+        &&op_19,
+        &&op_1A,
+        &&op_1B,
+        &&op_1C,
+        &&op_1D,
+        &&op_1E,
+        &&op_1F,
+        &&op_20,
+        &&op_21,
+        &&op_22,
+        &&op_23,
+        &&op_24,
+        &&op_25,
+        &&op_26,
+        &&op_27,
+        &&op_28,
+        &&op_29,
+        &&op_2A,
+        &&op_2B,
+        &&op_2C,
+        &&op_2D,
+        &&op_2E,
+        &&op_2F,
+        &&op_30,
+        &&op_31,
+        &&op_32,
+        &&op_33,
+        &&op_34,
+        &&op_35,
+        &&op_36,
+        &&op_37,
+        &&op_38,
+        &&op_39,
+        &&op_3A,
+        &&op_3B,
+        &&op_3C,
+        &&op_3D,
+        &&op_3E,
+        &&op_3F,
+        &&op_40,
+        &&op_41,
+        &&op_42,
+        &&op_43,
+        &&op_44,
+        &&op_45,
+        &&op_46,
+        &&op_47,
+        &&op_48,
+        &&op_49,
+        &&op_4A,
+        &&op_4B,
+        &&op_4C,
+        &&op_4D,
+        &&op_4E,
+        &&op_4F,
+        &&op_50,
+        &&op_51,
+        &&op_52,
+        &&op_53,
+        &&op_54,
+        &&op_55,
+        &&op_56,
+        &&op_57,
+        &&op_58,
+        &&op_59,
+        &&op_5A,
+        &&op_5B,
+        &&op_5C,
+        &&op_5D,
+        &&op_5E,
+        &&op_5F,
+        &&op_60,
+        &&op_61,
+        &&op_62,
+        &&op_63,
+        &&op_64,
+        &&op_65,
+        &&op_66,
+        &&op_67,
+        &&op_68,
+        &&op_69,
+        &&op_6A,
+        &&op_6B,
+        &&op_6C,
+        &&op_6D,
+        &&op_6E,
+        &&op_6F,
+        &&op_70,
+        &&op_71,
+        &&op_72,
+        &&op_73,
+        &&op_74,
+        &&op_75,
+        &&op_76,
+        &&op_77,
+        &&op_78,
+        &&op_79,
+        &&op_7A,
+        &&op_7B,
+        &&op_7C,
+        &&op_7D,
+        &&op_7E,
+        &&op_7F,
+        &&op_80,
+        &&op_81,
+        &&op_82,
+        &&op_83,
+        &&op_84,
+        &&op_85,
+        &&op_86,
+        &&op_87,
+        &&op_88,
+        &&op_89,
+        &&op_8A,
+        &&op_8B,
+        &&op_8C,
+        &&op_8D,
+        &&op_8E,
+        &&op_8F,
+        &&op_90,
+        &&op_91,
+        &&op_92,
+        &&op_93,
+        &&op_94,
+        &&op_95,
+        &&op_96,
+        &&op_97,
+        &&op_98,
+        &&op_99,
+        &&op_9A,
+        &&op_9B,
+        &&op_9C,
+        &&op_9D,
+        &&op_9E,
+        &&op_9F,
+        &&op_A0,
+        &&op_A1,
+        &&op_A2,
+        &&op_A3,
+        &&op_A4,
+        &&op_A5,
+        &&op_A6,
+        &&op_A7,
+        &&op_A8,
+        &&op_A9,
+        &&op_AA,
+        &&op_AB,
+        &&op_AC,
+        &&op_AD,
+        &&op_AE,
+        &&op_AF,
+        &&op_B0,
+        &&op_B1,
+        &&op_B2,
+        &&op_B3,
+        &&op_B4,
+        &&op_B5,
+        &&op_B6,
+        &&op_B7,
+        &&op_B8,
+        &&op_B9,
+        &&op_BA,
+        &&op_BB,
+        &&op_BC,
+        &&op_BD,
+        &&op_BE,
+        &&op_BF,
+        &&op_C0,
+        &&op_C1,
+        &&op_C2,
+        &&op_C3,
+        &&op_C4,
+        &&op_C5,
+        &&op_C6,
+        &&op_C7,
+        &&op_C8,
+        &&op_C9,
+        &&op_CA,
+        &&op_CB,
+        &&op_CC,
+        &&op_CD,
+        &&op_CE,
+        &&op_CF,
+        &&op_D0,
+        &&op_D1,
+        &&op_D2,
+        &&op_D3,
+        &&op_D4,
+        &&op_D5,
+        &&op_D6,
+        &&op_D7,
+        &&op_D8,
+        &&op_D9,
+        &&op_DA,
+        &&op_DB,
+        &&op_DC,
+        &&op_DD,
+        &&op_DE,
+        &&op_DF,
+        &&op_E0,
+        &&op_E1,
+        &&op_E2,
+        &&op_E3,
+        &&op_E4,
+        &&op_E5,
+        &&op_E6,
+        &&op_E7,
+        &&op_E8,
+        &&op_E9,
+        &&op_EA,
+        &&op_EB,
+        &&op_EC,
+        &&op_ED,
+        &&op_EE,
+        &&op_EF,
+        &&op_F0,
+        &&op_F1,
+        &&op_F2,
+        &&op_F3,
+        &&op_F4,
+        &&op_F5,
+        &&op_F6,
+        &&op_F7,
+        &&op_F8,
+        &&op_F9,
+        &&op_FA,
+        &&op_FB,
+        &&op_FC,
+        &&op_FD,
+        &&op_FE,
+        &&op_FF,
+    };
+
+    static void* const cb_labels[256] = {
+        &&cb_op_00,
+        &&cb_op_01,
+        &&cb_op_02,
+        &&cb_op_03,
+        &&cb_op_04,
+        &&cb_op_05,
+        &&cb_op_06,
+        &&cb_op_07,
+        &&cb_op_08,
+        &&cb_op_09,
+        &&cb_op_0A,
+        &&cb_op_0B,
+        &&cb_op_0C,
+        &&cb_op_0D,
+        &&cb_op_0E,
+        &&cb_op_0F,
+        &&cb_op_10,
+        &&cb_op_11,
+        &&cb_op_12,
+        &&cb_op_13,
+        &&cb_op_14,
+        &&cb_op_15,
+        &&cb_op_16,
+        &&cb_op_17,
+        &&cb_op_18,
+        &&cb_op_19,
+        &&cb_op_1A,
+        &&cb_op_1B,
+        &&cb_op_1C,
+        &&cb_op_1D,
+        &&cb_op_1E,
+        &&cb_op_1F,
+        &&cb_op_20,
+        &&cb_op_21,
+        &&cb_op_22,
+        &&cb_op_23,
+        &&cb_op_24,
+        &&cb_op_25,
+        &&cb_op_26,
+        &&cb_op_27,
+        &&cb_op_28,
+        &&cb_op_29,
+        &&cb_op_2A,
+        &&cb_op_2B,
+        &&cb_op_2C,
+        &&cb_op_2D,
+        &&cb_op_2E,
+        &&cb_op_2F,
+        &&cb_op_30,
+        &&cb_op_31,
+        &&cb_op_32,
+        &&cb_op_33,
+        &&cb_op_34,
+        &&cb_op_35,
+        &&cb_op_36,
+        &&cb_op_37,
+        &&cb_op_38,
+        &&cb_op_39,
+        &&cb_op_3A,
+        &&cb_op_3B,
+        &&cb_op_3C,
+        &&cb_op_3D,
+        &&cb_op_3E,
+        &&cb_op_3F,
+        &&cb_op_40,
+        &&cb_op_41,
+        &&cb_op_42,
+        &&cb_op_43,
+        &&cb_op_44,
+        &&cb_op_45,
+        &&cb_op_46,
+        &&cb_op_47,
+        &&cb_op_48,
+        &&cb_op_49,
+        &&cb_op_4A,
+        &&cb_op_4B,
+        &&cb_op_4C,
+        &&cb_op_4D,
+        &&cb_op_4E,
+        &&cb_op_4F,
+        &&cb_op_50,
+        &&cb_op_51,
+        &&cb_op_52,
+        &&cb_op_53,
+        &&cb_op_54,
+        &&cb_op_55,
+        &&cb_op_56,
+        &&cb_op_57,
+        &&cb_op_58,
+        &&cb_op_59,
+        &&cb_op_5A,
+        &&cb_op_5B,
+        &&cb_op_5C,
+        &&cb_op_5D,
+        &&cb_op_5E,
+        &&cb_op_5F,
+        &&cb_op_60,
+        &&cb_op_61,
+        &&cb_op_62,
+        &&cb_op_63,
+        &&cb_op_64,
+        &&cb_op_65,
+        &&cb_op_66,
+        &&cb_op_67,
+        &&cb_op_68,
+        &&cb_op_69,
+        &&cb_op_6A,
+        &&cb_op_6B,
+        &&cb_op_6C,
+        &&cb_op_6D,
+        &&cb_op_6E,
+        &&cb_op_6F,
+        &&cb_op_70,
+        &&cb_op_71,
+        &&cb_op_72,
+        &&cb_op_73,
+        &&cb_op_74,
+        &&cb_op_75,
+        &&cb_op_76,
+        &&cb_op_77,
+        &&cb_op_78,
+        &&cb_op_79,
+        &&cb_op_7A,
+        &&cb_op_7B,
+        &&cb_op_7C,
+        &&cb_op_7D,
+        &&cb_op_7E,
+        &&cb_op_7F,
+        &&cb_op_80,
+        &&cb_op_81,
+        &&cb_op_82,
+        &&cb_op_83,
+        &&cb_op_84,
+        &&cb_op_85,
+        &&cb_op_86,
+        &&cb_op_87,
+        &&cb_op_88,
+        &&cb_op_89,
+        &&cb_op_8A,
+        &&cb_op_8B,
+        &&cb_op_8C,
+        &&cb_op_8D,
+        &&cb_op_8E,
+        &&cb_op_8F,
+        &&cb_op_90,
+        &&cb_op_91,
+        &&cb_op_92,
+        &&cb_op_93,
+        &&cb_op_94,
+        &&cb_op_95,
+        &&cb_op_96,
+        &&cb_op_97,
+        &&cb_op_98,
+        &&cb_op_99,
+        &&cb_op_9A,
+        &&cb_op_9B,
+        &&cb_op_9C,
+        &&cb_op_9D,
+        &&cb_op_9E,
+        &&cb_op_9F,
+        &&cb_op_A0,
+        &&cb_op_A1,
+        &&cb_op_A2,
+        &&cb_op_A3,
+        &&cb_op_A4,
+        &&cb_op_A5,
+        &&cb_op_A6,
+        &&cb_op_A7,
+        &&cb_op_A8,
+        &&cb_op_A9,
+        &&cb_op_AA,
+        &&cb_op_AB,
+        &&cb_op_AC,
+        &&cb_op_AD,
+        &&cb_op_AE,
+        &&cb_op_AF,
+        &&cb_op_B0,
+        &&cb_op_B1,
+        &&cb_op_B2,
+        &&cb_op_B3,
+        &&cb_op_B4,
+        &&cb_op_B5,
+        &&cb_op_B6,
+        &&cb_op_B7,
+        &&cb_op_B8,
+        &&cb_op_B9,
+        &&cb_op_BA,
+        &&cb_op_BB,
+        &&cb_op_BC,
+        &&cb_op_BD,
+        &&cb_op_BE,
+        &&cb_op_BF,
+        &&cb_op_C0,
+        &&cb_op_C1,
+        &&cb_op_C2,
+        &&cb_op_C3,
+        &&cb_op_C4,
+        &&cb_op_C5,
+        &&cb_op_C6,
+        &&cb_op_C7,
+        &&cb_op_C8,
+        &&cb_op_C9,
+        &&cb_op_CA,
+        &&cb_op_CB,
+        &&cb_op_CC,
+        &&cb_op_CD,
+        &&cb_op_CE,
+        &&cb_op_CF,
+        &&cb_op_D0,
+        &&cb_op_D1,
+        &&cb_op_D2,
+        &&cb_op_D3,
+        &&cb_op_D4,
+        &&cb_op_D5,
+        &&cb_op_D6,
+        &&cb_op_D7,
+        &&cb_op_D8,
+        &&cb_op_D9,
+        &&cb_op_DA,
+        &&cb_op_DB,
+        &&cb_op_DC,
+        &&cb_op_DD,
+        &&cb_op_DE,
+        &&cb_op_DF,
+        &&cb_op_E0,
+        &&cb_op_E1,
+        &&cb_op_E2,
+        &&cb_op_E3,
+        &&cb_op_E4,
+        &&cb_op_E5,
+        &&cb_op_E6,
+        &&cb_op_E7,
+        &&cb_op_E8,
+        &&cb_op_E9,
+        &&cb_op_EA,
+        &&cb_op_EB,
+        &&cb_op_EC,
+        &&cb_op_ED,
+        &&cb_op_EE,
+        &&cb_op_EF,
+        &&cb_op_F0,
+        &&cb_op_F1,
+        &&cb_op_F2,
+        &&cb_op_F3,
+        &&cb_op_F4,
+        &&cb_op_F5,
+        &&cb_op_F6,
+        &&cb_op_F7,
+        &&cb_op_F8,
+        &&cb_op_F9,
+        &&cb_op_FA,
+        &&cb_op_FB,
+        &&cb_op_FC,
+        &&cb_op_FD,
+        &&cb_op_FE,
+        &&cb_op_FF,
+    };
+
+    Scheduler& scheduler = gb.scheduler;
+
+    DISPATCH();
+
+    /* The prefix has no handler of its own, it just picks the next table */
+op_CB:
+    goto *cb_labels[get_byte_from_pc()];
+
+    NORMAL_OPCODE(00)
+    NORMAL_OPCODE(01)
+    NORMAL_OPCODE(02)
+    NORMAL_OPCODE(03)
+    NORMAL_OPCODE(04)
+    NORMAL_OPCODE(05)
+    NORMAL_OPCODE(06)
+    NORMAL_OPCODE(07)
+    NORMAL_OPCODE(08)
+    NORMAL_OPCODE(09)
+    NORMAL_OPCODE(0A)
+    NORMAL_OPCODE(0B)
+    NORMAL_OPCODE(0C)
+    NORMAL_OPCODE(0D)
+    NORMAL_OPCODE(0E)
+    NORMAL_OPCODE(0F)
+    NORMAL_OPCODE(10)
+    NORMAL_OPCODE(11)
+    NORMAL_OPCODE(12)
+    NORMAL_OPCODE(13)
+    NORMAL_OPCODE(14)
+    NORMAL_OPCODE(15)
+    NORMAL_OPCODE(16)
+    NORMAL_OPCODE(17)
+    NORMAL_OPCODE(18)
+    NORMAL_OPCODE(19)
+    NORMAL_OPCODE(1A)
+    NORMAL_OPCODE(1B)
+    NORMAL_OPCODE(1C)
+    NORMAL_OPCODE(1D)
+    NORMAL_OPCODE(1E)
+    NORMAL_OPCODE(1F)
+    NORMAL_OPCODE(20)
+    NORMAL_OPCODE(21)
+    NORMAL_OPCODE(22)
+    NORMAL_OPCODE(23)
+    NORMAL_OPCODE(24)
+    NORMAL_OPCODE(25)
+    NORMAL_OPCODE(26)
+    NORMAL_OPCODE(27)
+    NORMAL_OPCODE(28)
+    NORMAL_OPCODE(29)
+    NORMAL_OPCODE(2A)
+    NORMAL_OPCODE(2B)
+    NORMAL_OPCODE(2C)
+    NORMAL_OPCODE(2D)
+    NORMAL_OPCODE(2E)
+    NORMAL_OPCODE(2F)
+    NORMAL_OPCODE(30)
+    NORMAL_OPCODE(31)
+    NORMAL_OPCODE(32)
+    NORMAL_OPCODE(33)
+    NORMAL_OPCODE(34)
+    NORMAL_OPCODE(35)
+    NORMAL_OPCODE(36)
+    NORMAL_OPCODE(37)
+    NORMAL_OPCODE(38)
+    NORMAL_OPCODE(39)
+    NORMAL_OPCODE(3A)
+    NORMAL_OPCODE(3B)
+    NORMAL_OPCODE(3C)
+    NORMAL_OPCODE(3D)
+    NORMAL_OPCODE(3E)
+    NORMAL_OPCODE(3F)
+    NORMAL_OPCODE(40)
+    NORMAL_OPCODE(41)
+    NORMAL_OPCODE(42)
+    NORMAL_OPCODE(43)
+    NORMAL_OPCODE(44)
+    NORMAL_OPCODE(45)
+    NORMAL_OPCODE(46)
+    NORMAL_OPCODE(47)
+    NORMAL_OPCODE(48)
+    NORMAL_OPCODE(49)
+    NORMAL_OPCODE(4A)
+    NORMAL_OPCODE(4B)
+    NORMAL_OPCODE(4C)
+    NORMAL_OPCODE(4D)
+    NORMAL_OPCODE(4E)
+    NORMAL_OPCODE(4F)
+    NORMAL_OPCODE(50)
+    NORMAL_OPCODE(51)
+    NORMAL_OPCODE(52)
+    NORMAL_OPCODE(53)
+    NORMAL_OPCODE(54)
+    NORMAL_OPCODE(55)
+    NORMAL_OPCODE(56)
+    NORMAL_OPCODE(57)
+    NORMAL_OPCODE(58)
+    NORMAL_OPCODE(59)
+    NORMAL_OPCODE(5A)
+    NORMAL_OPCODE(5B)
+    NORMAL_OPCODE(5C)
+    NORMAL_OPCODE(5D)
+    NORMAL_OPCODE(5E)
+    NORMAL_OPCODE(5F)
+    NORMAL_OPCODE(60)
+    NORMAL_OPCODE(61)
+    NORMAL_OPCODE(62)
+    NORMAL_OPCODE(63)
+    NORMAL_OPCODE(64)
+    NORMAL_OPCODE(65)
+    NORMAL_OPCODE(66)
+    NORMAL_OPCODE(67)
+    NORMAL_OPCODE(68)
+    NORMAL_OPCODE(69)
+    NORMAL_OPCODE(6A)
+    NORMAL_OPCODE(6B)
+    NORMAL_OPCODE(6C)
+    NORMAL_OPCODE(6D)
+    NORMAL_OPCODE(6E)
+    NORMAL_OPCODE(6F)
+    NORMAL_OPCODE(70)
+    NORMAL_OPCODE(71)
+    NORMAL_OPCODE(72)
+    NORMAL_OPCODE(73)
+    NORMAL_OPCODE(74)
+    NORMAL_OPCODE(75)
+    NORMAL_OPCODE(76)
+    NORMAL_OPCODE(77)
+    NORMAL_OPCODE(78)
+    NORMAL_OPCODE(79)
+    NORMAL_OPCODE(7A)
+    NORMAL_OPCODE(7B)
+    NORMAL_OPCODE(7C)
+    NORMAL_OPCODE(7D)
+    NORMAL_OPCODE(7E)
+    NORMAL_OPCODE(7F)
+    NORMAL_OPCODE(80)
+    NORMAL_OPCODE(81)
+    NORMAL_OPCODE(82)
+    NORMAL_OPCODE(83)
+    NORMAL_OPCODE(84)
+    NORMAL_OPCODE(85)
+    NORMAL_OPCODE(86)
+    NORMAL_OPCODE(87)
+    NORMAL_OPCODE(88)
+    NORMAL_OPCODE(89)
+    NORMAL_OPCODE(8A)
+    NORMAL_OPCODE(8B)
+    NORMAL_OPCODE(8C)
+    NORMAL_OPCODE(8D)
+    NORMAL_OPCODE(8E)
+    NORMAL_OPCODE(8F)
+    NORMAL_OPCODE(90)
+    NORMAL_OPCODE(91)
+    NORMAL_OPCODE(92)
+    NORMAL_OPCODE(93)
+    NORMAL_OPCODE(94)
+    NORMAL_OPCODE(95)
+    NORMAL_OPCODE(96)
+    NORMAL_OPCODE(97)
+    NORMAL_OPCODE(98)
+    NORMAL_OPCODE(99)
+    NORMAL_OPCODE(9A)
+    NORMAL_OPCODE(9B)
+    NORMAL_OPCODE(9C)
+    NORMAL_OPCODE(9D)
+    NORMAL_OPCODE(9E)
+    NORMAL_OPCODE(9F)
+    NORMAL_OPCODE(A0)
+    NORMAL_OPCODE(A1)
+    NORMAL_OPCODE(A2)
+    NORMAL_OPCODE(A3)
+    NORMAL_OPCODE(A4)
+    NORMAL_OPCODE(A5)
+    NORMAL_OPCODE(A6)
+    NORMAL_OPCODE(A7)
+    NORMAL_OPCODE(A8)
+    NORMAL_OPCODE(A9)
+    NORMAL_OPCODE(AA)
+    NORMAL_OPCODE(AB)
+    NORMAL_OPCODE(AC)
+    NORMAL_OPCODE(AD)
+    NORMAL_OPCODE(AE)
+    NORMAL_OPCODE(AF)
+    NORMAL_OPCODE(B0)
+    NORMAL_OPCODE(B1)
+    NORMAL_OPCODE(B2)
+    NORMAL_OPCODE(B3)
+    NORMAL_OPCODE(B4)
+    NORMAL_OPCODE(B5)
+    NORMAL_OPCODE(B6)
+    NORMAL_OPCODE(B7)
+    NORMAL_OPCODE(B8)
+    NORMAL_OPCODE(B9)
+    NORMAL_OPCODE(BA)
+    NORMAL_OPCODE(BB)
+    NORMAL_OPCODE(BC)
+    NORMAL_OPCODE(BD)
+    NORMAL_OPCODE(BE)
+    NORMAL_OPCODE(BF)
+    NORMAL_OPCODE(C0)
+    NORMAL_OPCODE(C1)
+    NORMAL_OPCODE(C2)
+    NORMAL_OPCODE(C3)
+    NORMAL_OPCODE(C4)
+    NORMAL_OPCODE(C5)
+    NORMAL_OPCODE(C6)
+    NORMAL_OPCODE(C7)
+    NORMAL_OPCODE(C8)
+    NORMAL_OPCODE(C9)
+    NORMAL_OPCODE(CA)
+    NORMAL_OPCODE(CC)
+    NORMAL_OPCODE(CD)
+    NORMAL_OPCODE(CE)
+    NORMAL_OPCODE(CF)
+    NORMAL_OPCODE(D0)
+    NORMAL_OPCODE(D1)
+    NORMAL_OPCODE(D2)
+    NORMAL_OPCODE(D3)
+    NORMAL_OPCODE(D4)
+    NORMAL_OPCODE(D5)
+    NORMAL_OPCODE(D6)
+    NORMAL_OPCODE(D7)
+    NORMAL_OPCODE(D8)
+    NORMAL_OPCODE(D9)
+    NORMAL_OPCODE(DA)
+    NORMAL_OPCODE(DB)
+    NORMAL_OPCODE(DC)
+    NORMAL_OPCODE(DD)
+    NORMAL_OPCODE(DE)
+    NORMAL_OPCODE(DF)
+    NORMAL_OPCODE(E0)
+    NORMAL_OPCODE(E1)
+    NORMAL_OPCODE(E2)
+    NORMAL_OPCODE(E3)
+    NORMAL_OPCODE(E4)
+    NORMAL_OPCODE(E5)
+    NORMAL_OPCODE(E6)
+    NORMAL_OPCODE(E7)
+    NORMAL_OPCODE(E8)
+    NORMAL_OPCODE(E9)
+    NORMAL_OPCODE(EA)
+    NORMAL_OPCODE(EB)
+    NORMAL_OPCODE(EC)
+    NORMAL_OPCODE(ED)
+    NORMAL_OPCODE(EE)
+    NORMAL_OPCODE(EF)
+    NORMAL_OPCODE(F0)
+    NORMAL_OPCODE(F1)
+    NORMAL_OPCODE(F2)
+    NORMAL_OPCODE(F3)
+    NORMAL_OPCODE(F4)
+    NORMAL_OPCODE(F5)
+    NORMAL_OPCODE(F6)
+    NORMAL_OPCODE(F7)
+    NORMAL_OPCODE(F8)
+    NORMAL_OPCODE(F9)
+    NORMAL_OPCODE(FA)
+    NORMAL_OPCODE(FB)
+    NORMAL_OPCODE(FC)
+    NORMAL_OPCODE(FD)
+    NORMAL_OPCODE(FE)
+    NORMAL_OPCODE(FF)
+
+    CB_OPCODE(00)
+    CB_OPCODE(01)
+    CB_OPCODE(02)
+    CB_OPCODE(03)
+    CB_OPCODE(04)
+    CB_OPCODE(05)
+    CB_OPCODE(06)
+    CB_OPCODE(07)
+    CB_OPCODE(08)
+    CB_OPCODE(09)
+    CB_OPCODE(0A)
+    CB_OPCODE(0B)
+    CB_OPCODE(0C)
+    CB_OPCODE(0D)
+    CB_OPCODE(0E)
+    CB_OPCODE(0F)
+    CB_OPCODE(10)
+    CB_OPCODE(11)
+    CB_OPCODE(12)
+    CB_OPCODE(13)
+    CB_OPCODE(14)
+    CB_OPCODE(15)
+    CB_OPCODE(16)
+    CB_OPCODE(17)
+    CB_OPCODE(18)
+    CB_OPCODE(19)
+    CB_OPCODE(1A)
+    CB_OPCODE(1B)
+    CB_OPCODE(1C)
+    CB_OPCODE(1D)
+    CB_OPCODE(1E)
+    CB_OPCODE(1F)
+    CB_OPCODE(20)
+    CB_OPCODE(21)
+    CB_OPCODE(22)
+    CB_OPCODE(23)
+    CB_OPCODE(24)
+    CB_OPCODE(25)
+    CB_OPCODE(26)
+    CB_OPCODE(27)
+    CB_OPCODE(28)
+    CB_OPCODE(29)
+    CB_OPCODE(2A)
+    CB_OPCODE(2B)
+    CB_OPCODE(2C)
+    CB_OPCODE(2D)
+    CB_OPCODE(2E)
+    CB_OPCODE(2F)
+    CB_OPCODE(30)
+    CB_OPCODE(31)
+    CB_OPCODE(32)
+    CB_OPCODE(33)
+    CB_OPCODE(34)
+    CB_OPCODE(35)
+    CB_OPCODE(36)
+    CB_OPCODE(37)
+    CB_OPCODE(38)
+    CB_OPCODE(39)
+    CB_OPCODE(3A)
+    CB_OPCODE(3B)
+    CB_OPCODE(3C)
+    CB_OPCODE(3D)
+    CB_OPCODE(3E)
+    CB_OPCODE(3F)
+    CB_OPCODE(40)
+    CB_OPCODE(41)
+    CB_OPCODE(42)
+    CB_OPCODE(43)
+    CB_OPCODE(44)
+    CB_OPCODE(45)
+    CB_OPCODE(46)
+    CB_OPCODE(47)
+    CB_OPCODE(48)
+    CB_OPCODE(49)
+    CB_OPCODE(4A)
+    CB_OPCODE(4B)
+    CB_OPCODE(4C)
+    CB_OPCODE(4D)
+    CB_OPCODE(4E)
+    CB_OPCODE(4F)
+    CB_OPCODE(50)
+    CB_OPCODE(51)
+    CB_OPCODE(52)
+    CB_OPCODE(53)
+    CB_OPCODE(54)
+    CB_OPCODE(55)
+    CB_OPCODE(56)
+    CB_OPCODE(57)
+    CB_OPCODE(58)
+    CB_OPCODE(59)
+    CB_OPCODE(5A)
+    CB_OPCODE(5B)
+    CB_OPCODE(5C)
+    CB_OPCODE(5D)
+    CB_OPCODE(5E)
+    CB_OPCODE(5F)
+    CB_OPCODE(60)
+    CB_OPCODE(61)
+    CB_OPCODE(62)
+    CB_OPCODE(63)
+    CB_OPCODE(64)
+    CB_OPCODE(65)
+    CB_OPCODE(66)
+    CB_OPCODE(67)
+    CB_OPCODE(68)
+    CB_OPCODE(69)
+    CB_OPCODE(6A)
+    CB_OPCODE(6B)
+    CB_OPCODE(6C)
+    CB_OPCODE(6D)
+    CB_OPCODE(6E)
+    CB_OPCODE(6F)
+    CB_OPCODE(70)
+    CB_OPCODE(71)
+    CB_OPCODE(72)
+    CB_OPCODE(73)
+    CB_OPCODE(74)
+    CB_OPCODE(75)
+    CB_OPCODE(76)
+    CB_OPCODE(77)
+    CB_OPCODE(78)
+    CB_OPCODE(79)
+    CB_OPCODE(7A)
+    CB_OPCODE(7B)
+    CB_OPCODE(7C)
+    CB_OPCODE(7D)
+    CB_OPCODE(7E)
+    CB_OPCODE(7F)
+    CB_OPCODE(80)
+    CB_OPCODE(81)
+    CB_OPCODE(82)
+    CB_OPCODE(83)
+    CB_OPCODE(84)
+    CB_OPCODE(85)
+    CB_OPCODE(86)
+    CB_OPCODE(87)
+    CB_OPCODE(88)
+    CB_OPCODE(89)
+    CB_OPCODE(8A)
+    CB_OPCODE(8B)
+    CB_OPCODE(8C)
+    CB_OPCODE(8D)
+    CB_OPCODE(8E)
+    CB_OPCODE(8F)
+    CB_OPCODE(90)
+    CB_OPCODE(91)
+    CB_OPCODE(92)
+    CB_OPCODE(93)
+    CB_OPCODE(94)
+    CB_OPCODE(95)
+    CB_OPCODE(96)
+    CB_OPCODE(97)
+    CB_OPCODE(98)
+    CB_OPCODE(99)
+    CB_OPCODE(9A)
+    CB_OPCODE(9B)
+    CB_OPCODE(9C)
+    CB_OPCODE(9D)
+    CB_OPCODE(9E)
+    CB_OPCODE(9F)
+    CB_OPCODE(A0)
+    CB_OPCODE(A1)
+    CB_OPCODE(A2)
+    CB_OPCODE(A3)
+    CB_OPCODE(A4)
+    CB_OPCODE(A5)
+    CB_OPCODE(A6)
+    CB_OPCODE(A7)
+    CB_OPCODE(A8)
+    CB_OPCODE(A9)
+    CB_OPCODE(AA)
+    CB_OPCODE(AB)
+    CB_OPCODE(AC)
+    CB_OPCODE(AD)
+    CB_OPCODE(AE)
+    CB_OPCODE(AF)
+    CB_OPCODE(B0)
+    CB_OPCODE(B1)
+    CB_OPCODE(B2)
+    CB_OPCODE(B3)
+    CB_OPCODE(B4)
+    CB_OPCODE(B5)
+    CB_OPCODE(B6)
+    CB_OPCODE(B7)
+    CB_OPCODE(B8)
+    CB_OPCODE(B9)
+    CB_OPCODE(BA)
+    CB_OPCODE(BB)
+    CB_OPCODE(BC)
+    CB_OPCODE(BD)
+    CB_OPCODE(BE)
+    CB_OPCODE(BF)
+    CB_OPCODE(C0)
+    CB_OPCODE(C1)
+    CB_OPCODE(C2)
+    CB_OPCODE(C3)
+    CB_OPCODE(C4)
+    CB_OPCODE(C5)
+    CB_OPCODE(C6)
+    CB_OPCODE(C7)
+    CB_OPCODE(C8)
+    CB_OPCODE(C9)
+    CB_OPCODE(CA)
+    CB_OPCODE(CB)
+    CB_OPCODE(CC)
+    CB_OPCODE(CD)
+    CB_OPCODE(CE)
+    CB_OPCODE(CF)
+    CB_OPCODE(D0)
+    CB_OPCODE(D1)
+    CB_OPCODE(D2)
+    CB_OPCODE(D3)
+    CB_OPCODE(D4)
+    CB_OPCODE(D5)
+    CB_OPCODE(D6)
+    CB_OPCODE(D7)
+    CB_OPCODE(D8)
+    CB_OPCODE(D9)
+    CB_OPCODE(DA)
+    CB_OPCODE(DB)
+    CB_OPCODE(DC)
+    CB_OPCODE(DD)
+    CB_OPCODE(DE)
+    CB_OPCODE(DF)
+    CB_OPCODE(E0)
+    CB_OPCODE(E1)
+    CB_OPCODE(E2)
+    CB_OPCODE(E3)
+    CB_OPCODE(E4)
+    CB_OPCODE(E5)
+    CB_OPCODE(E6)
+    CB_OPCODE(E7)
+    CB_OPCODE(E8)
+    CB_OPCODE(E9)
+    CB_OPCODE(EA)
+    CB_OPCODE(EB)
+    CB_OPCODE(EC)
+    CB_OPCODE(ED)
+    CB_OPCODE(EE)
+    CB_OPCODE(EF)
+    CB_OPCODE(F0)
+    CB_OPCODE(F1)
+    CB_OPCODE(F2)
+    CB_OPCODE(F3)
+    CB_OPCODE(F4)
+    CB_OPCODE(F5)
+    CB_OPCODE(F6)
+    CB_OPCODE(F7)
+    CB_OPCODE(F8)
+    CB_OPCODE(F9)
+    CB_OPCODE(FA)
+    CB_OPCODE(FB)
+    CB_OPCODE(FC)
+    CB_OPCODE(FD)
+    CB_OPCODE(FE)
+    CB_OPCODE(FF)
+}
+/* clang-format on */
+
+#undef CB_OPCODE
+#undef NORMAL_OPCODE
+#undef DISPATCH
+
+#pragma clang diagnostic pop
+#pragma GCC diagnostic pop
+
+#endif
@@ -0,0 +1,183 @@
+#include "idle_loop.h"
+
+#include "../mmu.h"
+#include "../scheduler.h"
+
+#include <cstring>
+
+/* Longest loop body (in instructions) worth analysing */
+static const uint max_loop_length = 16;
+
+/* Register index used in SM83 opcodes: B, C, D, E, H, L, (HL), A */
+static const uint register_b = 0;
+static const uint register_c = 1;
+static const uint register_d = 2;
+static const uint register_e = 3;
+static const uint register_h = 4;
+static const uint register_l = 5;
+static const uint register_hl_indirect = 6;
+
+/* Whether memory at `address` can only change when the CPU writes to it or
+ * an event is handled */
+static auto is_safe_read(const u16 address) -> bool {
+    /* The timer registers count on their own */
+    if (address >= 0xFF04 && address <= 0xFF07) { return false; }
+
+    /* As do the sound registers' status bits */
+    if (address >= 0xFF10 && address <= 0xFF3F) { return false; }
+
+    return true;
+}
+
+auto IdleLoopDetector::skippable_cycles(const u16 target, const RegisterFile& regs, const u64 now,
+                                        const u64 event_count, const u64 next_event) -> u64 {
+    bool same_state = seen && target == last_target && event_count == last_event_count
+        && std::memcmp(&regs, &last_regs, sizeof(RegisterFile)) == 0;
+
+    u64 iteration_length = now - last_time;
+
+    seen = true;
+    last_target = target;
+    last_regs = regs;
+    last_time = now;
+    last_event_count = event_count;
+
+    if (!same_state || iteration_length == 0 || next_event <= now || next_event == Scheduler::never()) {
+        return 0;
+    }
+    if (!is_idle_loop(target, regs)) { return 0; }
+
+    u64 skipped = ((next_event - now) / iteration_length) * iteration_length;
+    if (skipped == 0) { return 0; }
+
+    last_time = now + skipped;
+
+    statistics.loops_skipped++;
+    statistics.cycles_skipped += skipped;
+    return skipped;
+}
+
+/* Whether the loop starting at `target` is a straight run of instructions
+ * which don't write to memory or touch the stack, ending in a jump back to
+ * `target` */
+auto IdleLoopDetector::is_idle_loop(const u16 target, const RegisterFile& regs) const -> bool {
+    /* Registers written so far in the body. Memory read through a register
+     * pair must come before the pair is written, so that the address is the
+     * same on every iteration and can be checked here */
+    bool written[8] = {};
+
+    auto pair_unwritten = [&](uint high, uint low) { return !written[high] && !written[low]; };
+
+    u16 pc = target;
+
+    for (uint i = 0; i < max_loop_length; i++) {
+        u8 opcode = mmu.read(pc);
+        u8 operand = mmu.read(static_cast<u16>(pc + 1));
+        u16 word_operand = static_cast<u16>(operand | (mmu.read(static_cast<u16>(pc + 2)) << 8));
+
+        uint destination = (opcode >> 3) & 0x7;
+        uint source = opcode & 0x7;
+
+        /* JR, JR cc */
+        if (opcode == 0x18 || opcode == 0x20 || opcode == 0x28 || opcode == 0x30 || opcode == 0x38) {
+            return static_cast<u16>(pc + 2 + static_cast<s8>(operand)) == target;
+        }
+
+        /* JP, JP cc */
+        if (opcode == 0xC3 || opcode == 0xC2 || opcode == 0xCA || opcode == 0xD2 || opcode == 0xDA) {
+            return word_operand == target;
+        }
+
+        /* LD r, r' and LD r, (HL), but not LD (HL), r or HALT */
+        if (opcode >= 0x40 && opcode <= 0x7F) {
+            if (destination == register_hl_indirect) { return false; }
+
+            if (source == register_hl_indirect) {
+                if (!pair_unwritten(register_h, register_l) || !is_safe_read(regs.hl)) { return false; }
+            }
+
+            written[destination] = true;
+            pc++;
+            continue;
+        }
+
+        /* ADD/ADC/SUB/SBC/AND/XOR/OR/CP A, r and A, (HL) */
+        if (opcode >= 0x80 && opcode <= 0xBF) {
+            if (source == register_hl_indirect) {
+                if (!pair_unwritten(register_h, register_l) || !is_safe_read(regs.hl)) { return false; }
+            }
+
+            pc++;
+            continue;
+        }
+
+        switch (opcode) {
+            /* NOP, CPL, SCF, CCF */
+            case 0x00: case 0x2F: case 0x37: case 0x3F:
+                pc++;
+                break;
+
+            /* INC r, DEC r */
+            case 0x04: case 0x0C: case 0x14: case 0x1C: case 0x24: case 0x2C: case 0x3C:
+            case 0x05: case 0x0D: case 0x15: case 0x1D: case 0x25: case 0x2D: case 0x3D:
+                written[destination] = true;
+                pc++;
+                break;
+
+            /* LD r, n */
+            case 0x06: case 0x0E: case 0x16: case 0x1E: case 0x26: case 0x2E: case 0x3E:
+                written[destination] = true;
+                pc = static_cast<u16>(pc + 2);
+                break;
+
+            /* ALU A, n */
+            case 0xC6: case 0xCE: case 0xD6: case 0xDE: case 0xE6: case 0xEE: case 0xF6: case 0xFE:
+                pc = static_cast<u16>(pc + 2);
+                break;
+
+            /* LD A, (BC) */
+            case 0x0A:
+                if (!pair_unwritten(register_b, register_c) || !is_safe_read(regs.bc)) { return false; }
+                pc++;
+                break;
+
+            /* LD A, (DE) */
+            case 0x1A:
+                if (!pair_unwritten(register_d, register_e) || !is_safe_read(regs.de)) { return false; }
+                pc++;
+                break;
+
+            /* LDH A, (n) */
+            case 0xF0:
+                if (!is_safe_read(static_cast<u16>(0xFF00 + operand))) { return false; }
+                pc = static_cast<u16>(pc + 2);
+                break;
+
+            /* LD A, (C) */
+            case 0xF2:
+                if (written[register_c] || !is_safe_read(static_cast<u16>(0xFF00 + regs.c))) { return false; }
+                pc++;
+                break;
+
+            /* LD A, (nn) */
+            case 0xFA:
+                if (!is_safe_read(word_operand)) { return false; }
+                pc = static_cast<u16>(pc + 3);
+                break;
+
+            /* BIT b, r and BIT b, (HL) */
+            case 0xCB:
+                if (operand < 0x40 || operand > 0x7F) { return false; }
+                if ((operand & 0x7) == register_hl_indirect) {
+                    if (!pair_unwritten(register_h, register_l) || !is_safe_read(regs.hl)) { return false; }
+                }
+                pc = static_cast<u16>(pc + 2);
+                break;
+
+            default:
+                return false;
+        }
+    }
+
+    return false;
+}
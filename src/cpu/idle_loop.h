@@ -0,0 +1,57 @@
+#pragma once
+
+#include "registers.h"
+#include "../definitions.h"
+
+class MMU;
+
+struct IdleLoopStats {
+    u64 loops_skipped = 0;
+    u64 cycles_skipped = 0;
+};
+
+/*
+ * Spots loops which wait for something to change by polling memory, e.g.
+ *
+ *     wait: ldh a, (0x44)
+ *           cp 0x90
+ *           jr nz, wait
+ *
+ * Such a loop only reads memory and registers, so once it arrives back at its
+ * start with the same registers as on the previous iteration, every
+ * iteration after that will be identical until something else changes the
+ * memory it polls. Outside the CPU, that only happens when a scheduled
+ * event is handled, so the loop can skip whole iterations up to the next
+ * event. Skipping whole iterations (rather than jumping straight to the
+ * event) keeps the loop on the same instruction boundaries as running it
+ * would.
+ */
+class IdleLoopDetector {
+public:
+    IdleLoopDetector(MMU& inMMU) : mmu(inMMU) {}
+
+    /* Called when execution has jumped back to `target`, at time `now`.
+     * `event_count` identifies the events handled so far, and `next_event`
+     * is when the next one is due. Returns how many clocks (see
+     * Scheduler::now()) can be skipped */
+    auto skippable_cycles(u16 target, const RegisterFile& regs, u64 now, u64 event_count, u64 next_event) -> u64;
+
+    auto stats() const -> const IdleLoopStats& { return statistics; }
+
+    /* Forget the last arrival, e.g. when the machine's state is replaced */
+    void reset() { seen = false; }
+
+private:
+    auto is_idle_loop(u16 target, const RegisterFile& regs) const -> bool;
+
+    MMU& mmu;
+
+    /* The previous arrival at the start of a loop */
+    bool seen = false;
+    u16 last_target = 0;
+    RegisterFile last_regs = {};
+    u64 last_time = 0;
+    u64 last_event_count = 0;
+
+    IdleLoopStats statistics;
+};
@@ -0,0 +1,66 @@
+#include "emitter.h"
+
+Emitter::Emitter(u8* inBuffer, size_t inCapacity) :
+    buffer(inBuffer),
+    capacity(inCapacity)
+{
+}
+
+void Emitter::emit(std::initializer_list<u8> bytes) {
+    for (u8 byte : bytes) { emit8(byte); }
+}
+
+void Emitter::emit8(const u8 value) {
+    if (size < capacity) { buffer[size] = value; }
+    size++;
+}
+
+void Emitter::emit16(const u16 value) {
+    emit8(static_cast<u8>(value));
+    emit8(static_cast<u8>(value >> 8));
+}
+
+void Emitter::emit32(const u32 value) {
+    emit16(static_cast<u16>(value));
+    emit16(static_cast<u16>(value >> 16));
+}
+
+void Emitter::emit64(const u64 value) {
+    emit32(static_cast<u32>(value));
+    emit32(static_cast<u32>(value >> 32));
+}
+
+auto Emitter::jcc32(const u8 condition) -> size_t {
+    emit({0x0F, static_cast<u8>(0x80 | condition)});
+    size_t label = size;
+    emit32(0);
+    return label;
+}
+
+auto Emitter::jmp8() -> size_t {
+    emit8(0xEB);
+    size_t label = size;
+    emit8(0);
+    return label;
+}
+
+auto Emitter::jrcxz8() -> size_t {
+    emit8(0xE3);
+    size_t label = size;
+    emit8(0);
+    return label;
+}
+
+void Emitter::bind32(const size_t label) {
+    u32 displacement = static_cast<u32>(size - (label + 4));
+    if (label + 4 > capacity) { return; }
+
+    for (uint i = 0; i < 4; i++) {
+        buffer[label + i] = static_cast<u8>(displacement >> (i * 8));
+    }
+}
+
+void Emitter::bind8(const size_t label) {
+    if (label >= capacity) { return; }
+    buffer[label] = static_cast<u8>(size - (label + 1));
+}
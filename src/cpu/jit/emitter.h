@@ -0,0 +1,51 @@
+#pragma once
+
+#include "../../definitions.h"
+
+#include <cstddef>
+#include <initializer_list>
+
+/*
+ * Writes raw x86-64 machine code into a buffer.
+ *
+ * This deliberately isn't a general assembler: the JIT only uses a handful
+ * of instruction forms, which it emits directly as bytes (with the assembly
+ * alongside in comments). The emitter just tracks the write position and
+ * patches forward jumps.
+ */
+class Emitter {
+public:
+    Emitter(u8* inBuffer, size_t inCapacity);
+
+    void emit(std::initializer_list<u8> bytes);
+    void emit8(u8 value);
+    void emit16(u16 value);
+    void emit32(u32 value);
+    void emit64(u64 value);
+
+    /* Forward jumps. These emit the jump with a zero displacement and return
+     * a label which bind() later points at the current position */
+    auto jcc32(u8 condition) -> size_t;
+    auto jmp8() -> size_t;
+    auto jrcxz8() -> size_t;
+
+    void bind32(size_t label);
+    void bind8(size_t label);
+
+    auto position() const -> size_t { return size; }
+    auto overflowed() const -> bool { return size > capacity; }
+
+private:
+    u8* buffer;
+    size_t capacity;
+    size_t size = 0;
+};
+
+/* Condition codes for jcc32 (the low nibble of the 0F 8x opcode) */
+namespace x86_condition {
+const u8 carry = 0x2;
+const u8 not_carry = 0x3;
+const u8 zero = 0x4;
+const u8 not_zero = 0x5;
+const u8 below_or_equal = 0x6;
+} // namespace x86_condition
@@ -0,0 +1,846 @@
+#include "jit.h"
+
+#include "emitter.h"
+#include "../cpu.h"
+#include "../../mmu.h"
+#include "../../util/bitwise.h"
+#include "../../util/log.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#ifdef GBEMU_JIT_SUPPORTED
+#include <sys/mman.h>
+#endif
+
+static_assert(offsetof(JitState, regs.f) == 0, "compiled code relies on the JitState layout");
+static_assert(offsetof(JitState, regs.sp) == 8, "compiled code relies on the JitState layout");
+static_assert(offsetof(JitState, regs.pc) == 10, "compiled code relies on the JitState layout");
+static_assert(offsetof(JitState, read_pages) == 16, "compiled code relies on the JitState layout");
+static_assert(offsetof(JitState, mmu) == 24, "compiled code relies on the JitState layout");
+static_assert(offsetof(JitState, exit_index) == 32, "compiled code relies on the JitState layout");
+
+namespace {
+
+const size_t code_buffer_size = 16 * 1024 * 1024;
+
+/* Every instruction compiles to well under 512 bytes, including the exits
+ * for its reads, so this is always enough room for one more block */
+const size_t max_block_code_size = 64 * 512 + 1024;
+
+/* Offsets of JitState fields, as used in compiled code */
+namespace offset {
+const u8 f = 0;
+const u8 a = 1;
+const u8 c = 2;
+const u8 b = 3;
+const u8 e = 4;
+const u8 d = 5;
+const u8 l = 6;
+const u8 h = 7;
+const u8 sp = 8;
+const u8 pc = 10;
+const u8 mmu = 24;
+const u8 exit_index = 32;
+} // namespace offset
+
+/* Register index used in SM83 opcodes: B, C, D, E, H, L, (HL), A */
+const uint register_hl_indirect = 6;
+const uint register_a = 7;
+
+auto register_offset(uint index) -> u8 {
+    static const u8 offsets[] = {offset::b, offset::c, offset::d, offset::e, offset::h, offset::l};
+    return offsets[index];
+}
+
+/* Register pair index used in SM83 opcodes: BC, DE, HL, SP */
+auto pair_offset(uint index) -> u8 {
+    static const u8 offsets[] = {offset::c, offset::e, offset::l, offset::sp};
+    return offsets[index];
+}
+
+/* ALU operations, in SM83 opcode order */
+enum Operation { Add, Adc, Sub, Sbc, And, Xor, Or, Cp };
+
+/* Where the current value of a flag lives while a block is being compiled */
+enum class FlagState {
+    Guest,  /* In the guest F register (r14b) */
+    Host,   /* In the host flags register */
+    Zero,
+    One,
+};
+
+struct FlagStates {
+    FlagState zero = FlagState::Guest;
+    FlagState subtract = FlagState::Guest;
+    FlagState half_carry = FlagState::Guest;
+    FlagState carry = FlagState::Guest;
+};
+
+/* Source of the right-hand operand of an ALU operation */
+enum class Operand {
+    Register,   /* A guest register in JitState */
+    A,          /* r12b */
+    Loaded,     /* al, after a memory read */
+    Immediate,
+};
+
+auto read_byte(const MMU* mmu, u16 address) -> u8 {
+    return mmu->read(Address(address));
+}
+
+/* The IO registers, which unlike the rest of memory may read differently
+ * depending on the time (e.g. LY or DIV) */
+auto is_io_register(u16 address) -> bool {
+    return address >= 0xFF00 && address < 0xFF80;
+}
+
+/* Whether an instruction is known to read an IO register. Others may still
+ * do so through a register pair, which is checked when they run */
+auto reads_io_register(const DecodedInstruction& instruction) -> bool {
+    using bitwise::compose_bytes;
+
+    switch (instruction.bytes[0]) {
+        case 0xF0: return is_io_register(static_cast<u16>(0xFF00 + instruction.bytes[1]));
+        case 0xFA: return is_io_register(compose_bytes(instruction.bytes[2], instruction.bytes[1]));
+        default: return false;
+    }
+}
+
+auto ends_with_infinite_jr(const DecodedInstruction& instruction, const Options& options) -> bool {
+    return options.exit_on_infinite_jr && instruction.bytes[1] == 0xFE;
+}
+
+auto is_supported(const DecodedInstruction& instruction, const Options& options) -> bool {
+    u8 opcode = instruction.bytes[0];
+
+    switch (opcode) {
+        /* (HL) as a destination */
+        case 0x34: case 0x35: case 0x36:
+            return false;
+
+        case 0x00: case 0x0A: case 0x1A: case 0x2A: case 0x3A:
+        case 0x2F: case 0x37: case 0x3F:
+        case 0xF0: case 0xF2: case 0xFA:
+        case 0xC2: case 0xC3: case 0xCA: case 0xD2: case 0xDA: case 0xE9:
+        case 0xC0: case 0xC8: case 0xC9: case 0xD0: case 0xD8:
+            return true;
+
+        /* Leave the infinite loop check to the interpreter */
+        case 0x18: case 0x20: case 0x28: case 0x30: case 0x38:
+            return !ends_with_infinite_jr(instruction, options);
+
+        default:
+            break;
+    }
+
+    /* LD rr, nn / INC rr / DEC rr */
+    if ((opcode & 0xCF) == 0x01 || (opcode & 0xCF) == 0x03 || (opcode & 0xCF) == 0x0B) { return true; }
+
+    /* INC r / DEC r / LD r, n */
+    if ((opcode & 0xC7) == 0x04 || (opcode & 0xC7) == 0x05 || (opcode & 0xC7) == 0x06) { return true; }
+
+    /* LD r, r' except stores to (HL) and HALT */
+    if (opcode >= 0x40 && opcode <= 0x7F) { return (opcode & 0xF8) != 0x70; }
+
+    /* ALU A, r and ALU A, n */
+    if (opcode >= 0x80 && opcode <= 0xBF) { return true; }
+    if ((opcode & 0xC7) == 0xC6) { return true; }
+
+    return false;
+}
+
+class BlockCompiler {
+public:
+    BlockCompiler(Emitter& inEmitter, const Options& inOptions);
+
+    /* Returns the number of instructions compiled */
+    auto compile(const Block& block) -> uint;
+
+    /* The most cycles any exit from the compiled code takes */
+    auto longest_exit() const -> uint { return longest_exit_cycles; }
+
+private:
+    void compile_instruction(const DecodedInstruction& instruction);
+
+    void prologue();
+    void exit_to(FlagStates states, u16 pc, uint exit_cycles);
+    void exit_to_stored_pc(FlagStates states, uint exit_cycles);
+    void epilogue(FlagStates states, uint exit_cycles);
+    void side_exits();
+
+    void materialize(FlagStates& states);
+
+    void read();
+    void address_from_pair(u8 pair);
+    void store_loaded(uint index);
+
+    void ld(uint destination, uint source);
+    void ld_immediate(uint destination, u8 value);
+    void ld_pair_immediate(u8 pair, u16 value);
+    void step_pair(u8 pair, s8 step);
+    void inc_dec(uint index, bool decrement);
+    void alu(Operation operation, Operand operand, u8 value);
+    void alu_register(Operation operation, uint index);
+    void ccf();
+    void ret();
+
+    void conditional(Condition condition, const DecodedInstruction& instruction, bool is_return, u16 target);
+
+    Emitter& emitter;
+    const Options& options;
+
+    FlagStates flags;
+    uint cycles = 0;
+    uint longest_exit_cycles = 0;
+    bool ended = false;
+
+    /* The instruction being compiled, and where it is in the block */
+    u16 instruction_address = 0;
+    uint instruction_index = 0;
+
+    /* Exits from the slow path of a read, back to before the instruction
+     * which made it, emitted after the rest of the block */
+    struct SideExit {
+        size_t label;
+        FlagStates flags;
+        u16 pc;
+        uint index;
+        uint cycles;
+    };
+
+    std::vector<SideExit> pending_side_exits;
+
+    /* Set if is_supported() let through something compile_instruction()
+     * can't compile, so that the block is left to the interpreter */
+    bool failed = false;
+};
+
+BlockCompiler::BlockCompiler(Emitter& inEmitter, const Options& inOptions) :
+    emitter(inEmitter),
+    options(inOptions)
+{
+}
+
+auto BlockCompiler::compile(const Block& block) -> uint {
+    uint compiled = 0;
+
+    for (const auto& instruction : block.instructions) {
+        if (!is_supported(instruction, options)) { break; }
+
+        /* Left for the interpreter to read at the right time */
+        if (compiled > 0 && reads_io_register(instruction)) { break; }
+
+        if (compiled == 0) { prologue(); }
+
+        instruction_address = instruction.address;
+        instruction_index = compiled;
+        compile_instruction(instruction);
+        compiled++;
+
+        if (ended || failed) { break; }
+    }
+
+    if (compiled > 0 && !ended) {
+        const auto& last = block.instructions[compiled - 1];
+        exit_to(flags, static_cast<u16>(last.address + last.length), cycles);
+    }
+
+    side_exits();
+
+    return failed ? 0 : compiled;
+}
+
+void BlockCompiler::compile_instruction(const DecodedInstruction& instruction) {
+    using bitwise::compose_bytes;
+
+    u8 opcode = instruction.bytes[0];
+    u8 n = instruction.bytes[1];
+    u16 nn = compose_bytes(instruction.bytes[2], instruction.bytes[1]);
+    u16 next_pc = static_cast<u16>(instruction.address + instruction.length);
+
+    switch (opcode) {
+        case 0x00:
+            break;
+
+        /* LD A, (BC) / LD A, (DE) */
+        case 0x0A: case 0x1A:
+            address_from_pair(opcode == 0x0A ? offset::c : offset::e);
+            read();
+            store_loaded(register_a);
+            break;
+
+        /* LD A, (HL+) / LD A, (HL-) */
+        case 0x2A: case 0x3A:
+            address_from_pair(offset::l);
+            read();
+            store_loaded(register_a);
+            step_pair(offset::l, opcode == 0x2A ? 1 : -1);
+            break;
+
+        case 0x2F:
+            emitter.emit({0x41, 0xF6, 0xD4});               // not r12b
+            flags.subtract = FlagState::One;
+            flags.half_carry = FlagState::One;
+            break;
+
+        case 0x37:
+            flags.subtract = FlagState::Zero;
+            flags.half_carry = FlagState::Zero;
+            flags.carry = FlagState::One;
+            break;
+
+        case 0x3F:
+            ccf();
+            break;
+
+        /* LDH A, (n) / LD A, (C) / LD A, (nn) */
+        case 0xF0:
+            emitter.emit8(0xBA);                            // mov edx, 0xFF00 + n
+            emitter.emit32(0xFF00 + n);
+            read();
+            store_loaded(register_a);
+            break;
+
+        case 0xF2:
+            emitter.emit({0x0F, 0xB6, 0x53, offset::c});   // movzx edx, byte [rbx + c]
+            emitter.emit({0x8D, 0x92, 0x00, 0xFF, 0x00, 0x00}); // lea edx, [rdx + 0xFF00]
+            read();
+            store_loaded(register_a);
+            break;
+
+        case 0xFA:
+            emitter.emit8(0xBA);                            // mov edx, nn
+            emitter.emit32(nn);
+            read();
+            store_loaded(register_a);
+            break;
+
+        /* JR */
+        case 0x18:
+            exit_to(flags, static_cast<u16>(next_pc + static_cast<s8>(n)), cycles + CPU::opcodes[opcode].cycles);
+            ended = true;
+            break;
+
+        case 0x20: conditional(Condition::NZ, instruction, false, static_cast<u16>(next_pc + static_cast<s8>(n))); break;
+        case 0x28: conditional(Condition::Z, instruction, false, static_cast<u16>(next_pc + static_cast<s8>(n))); break;
+        case 0x30: conditional(Condition::NC, instruction, false, static_cast<u16>(next_pc + static_cast<s8>(n))); break;
+        case 0x38: conditional(Condition::C, instruction, false, static_cast<u16>(next_pc + static_cast<s8>(n))); break;
+
+        /* JP */
+        case 0xC3:
+            exit_to(flags, nn, cycles + CPU::opcodes[opcode].cycles);
+            ended = true;
+            break;
+
+        case 0xC2: conditional(Condition::NZ, instruction, false, nn); break;
+        case 0xCA: conditional(Condition::Z, instruction, false, nn); break;
+        case 0xD2: conditional(Condition::NC, instruction, false, nn); break;
+        case 0xDA: conditional(Condition::C, instruction, false, nn); break;
+
+        case 0xE9:
+            emitter.emit({0x0F, 0xB7, 0x4B, offset::l});   // movzx ecx, word [rbx + hl]
+            emitter.emit({0x66, 0x89, 0x4B, offset::pc});  // mov [rbx + pc], cx
+            exit_to_stored_pc(flags, cycles + CPU::opcodes[opcode].cycles);
+            ended = true;
+            break;
+
+        /* RET */
+        case 0xC9:
+            ret();
+            exit_to_stored_pc(flags, cycles + CPU::opcodes[opcode].cycles);
+            ended = true;
+            break;
+
+        case 0xC0: conditional(Condition::NZ, instruction, true, 0); break;
+        case 0xC8: conditional(Condition::Z, instruction, true, 0); break;
+        case 0xD0: conditional(Condition::NC, instruction, true, 0); break;
+        case 0xD8: conditional(Condition::C, instruction, true, 0); break;
+
+        default:
+            if ((opcode & 0xCF) == 0x01) {
+                ld_pair_immediate(pair_offset(opcode >> 4), nn);
+            } else if ((opcode & 0xCF) == 0x03) {
+                step_pair(pair_offset(opcode >> 4), 1);
+            } else if ((opcode & 0xCF) == 0x0B) {
+                step_pair(pair_offset(opcode >> 4), -1);
+            } else if ((opcode & 0xC7) == 0x04) {
+                inc_dec((opcode >> 3) & 0x7, false);
+            } else if ((opcode & 0xC7) == 0x05) {
+                inc_dec((opcode >> 3) & 0x7, true);
+            } else if ((opcode & 0xC7) == 0x06) {
+                ld_immediate((opcode >> 3) & 0x7, n);
+            } else if (opcode >= 0x40 && opcode <= 0x7F) {
+                ld((opcode >> 3) & 0x7, opcode & 0x7);
+            } else if (opcode >= 0x80 && opcode <= 0xBF) {
+                alu_register(static_cast<Operation>((opcode >> 3) & 0x7), opcode & 0x7);
+            } else if ((opcode & 0xC7) == 0xC6) {
+                alu(static_cast<Operation>((opcode >> 3) & 0x7), Operand::Immediate, n);
+            } else {
+                log_error("JIT: unsupported opcode 0x%02X", opcode);
+                failed = true;
+            }
+            break;
+    }
+
+    cycles += CPU::opcodes[opcode].cycles;
+}
+
+/*
+ * Compiled blocks are called as `uint block(JitState* state)` and return the
+ * number of cycles taken. While running, they use:
+ *
+ *   rbx: JitState
+ *   rbp: the MMU's read page table
+ *   r12: A
+ *   r14: F
+ *
+ * all of which are callee-saved, so calls into the MMU preserve them.
+ */
+void BlockCompiler::prologue() {
+    emitter.emit({0x53});                               // push rbx
+    emitter.emit({0x55});                               // push rbp
+    emitter.emit({0x41, 0x54});                         // push r12
+    emitter.emit({0x41, 0x56});                         // push r14
+    emitter.emit({0x48, 0x83, 0xEC, 0x08});             // sub rsp, 8 (keep the stack 16-byte aligned)
+
+    emitter.emit({0x48, 0x89, 0xFB});                   // mov rbx, rdi
+    emitter.emit({0x48, 0x8B, 0x6B, 0x10});             // mov rbp, [rbx + read_pages]
+    emitter.emit({0x44, 0x0F, 0xB6, 0x63, offset::a});  // movzx r12d, byte [rbx + a]
+    emitter.emit({0x44, 0x0F, 0xB6, 0x73, offset::f});  // movzx r14d, byte [rbx + f]
+}
+
+void BlockCompiler::exit_to(FlagStates states, const u16 pc, const uint exit_cycles) {
+    emitter.emit({0x66, 0xC7, 0x43, offset::pc});      // mov word [rbx + pc], imm16
+    emitter.emit16(pc);
+    epilogue(states, exit_cycles);
+}
+
+void BlockCompiler::exit_to_stored_pc(FlagStates states, const uint exit_cycles) {
+    epilogue(states, exit_cycles);
+}
+
+void BlockCompiler::epilogue(FlagStates states, const uint exit_cycles) {
+    longest_exit_cycles = std::max(longest_exit_cycles, exit_cycles);
+
+    materialize(states);
+
+    emitter.emit({0x44, 0x88, 0x63, offset::a});       // mov [rbx + a], r12b
+    emitter.emit({0x44, 0x88, 0x73, offset::f});       // mov [rbx + f], r14b
+
+    emitter.emit8(0xB8);                                // mov eax, cycles
+    emitter.emit32(exit_cycles);
+
+    emitter.emit({0x48, 0x83, 0xC4, 0x08});             // add rsp, 8
+    emitter.emit({0x41, 0x5E});                         // pop r14
+    emitter.emit({0x41, 0x5C});                         // pop r12
+    emitter.emit({0x5D});                               // pop rbp
+    emitter.emit({0x5B});                               // pop rbx
+    emitter.emit({0xC3});                               // ret
+}
+
+/* Write any flags not yet in the guest F register into it. Z, H and C sit in
+ * the host's ZF, AF and CF (bits 6, 4 and 0), and move to bits 7, 5 and 4 */
+void BlockCompiler::materialize(FlagStates& states) {
+    u8 clear_mask = 0;
+    u8 set_mask = 0;
+    u32 shifted_host_flags = 0;
+    bool host_carry = false;
+
+    auto collect = [&](FlagState& state, u8 mask, u32 host_flag) {
+        if (state == FlagState::Guest) { return; }
+
+        clear_mask |= mask;
+        if (state == FlagState::One) { set_mask |= mask; }
+        if (state == FlagState::Host) {
+            if (mask == flags::carry) { host_carry = true; }
+            else { shifted_host_flags |= host_flag; }
+        }
+
+        state = FlagState::Guest;
+    };
+
+    collect(states.zero, flags::zero, 0x40);
+    collect(states.subtract, flags::subtract, 0);
+    collect(states.half_carry, flags::half_carry, 0x10);
+    collect(states.carry, flags::carry, 0);
+
+    if (clear_mask == 0) { return; }
+
+    if (shifted_host_flags || host_carry) {
+        emitter.emit({0x9C});                           // pushfq
+        emitter.emit({0x58});                           // pop rax
+    }
+
+    emitter.emit({0x41, 0x80, 0xE6, static_cast<u8>(~clear_mask)}); // and r14b, ~clear_mask
+
+    if (shifted_host_flags) {
+        emitter.emit({0x89, 0xC1});                     // mov ecx, eax
+        emitter.emit({0x81, 0xE1});                     // and ecx, host flags
+        emitter.emit32(shifted_host_flags);
+        emitter.emit({0x01, 0xC9});                     // add ecx, ecx
+        emitter.emit({0x41, 0x09, 0xCE});               // or r14d, ecx
+    }
+
+    if (host_carry) {
+        emitter.emit({0x89, 0xC1});                     // mov ecx, eax
+        emitter.emit({0x83, 0xE1, 0x01});               // and ecx, 1
+        emitter.emit({0xC1, 0xE1, 0x04});               // shl ecx, 4
+        emitter.emit({0x41, 0x09, 0xCE});               // or r14d, ecx
+    }
+
+    if (set_mask) {
+        emitter.emit({0x41, 0x80, 0xCE, set_mask});     // or r14b, set_mask
+    }
+}
+
+/* Compiled code doesn't move the clock, so after the first instruction it
+ * can't read an IO register at the right time. Such a read leaves the block
+ * from before its instruction instead, for the interpreter to carry on */
+void BlockCompiler::side_exits() {
+    for (const SideExit& side_exit : pending_side_exits) {
+        emitter.bind32(side_exit.label);
+        emitter.emit({0x9D});                           // popfq
+        emitter.emit({0xC7, 0x43, offset::exit_index}); // mov dword [rbx + exit_index], index
+        emitter.emit32(side_exit.index);
+        exit_to(side_exit.flags, side_exit.pc, side_exit.cycles);
+    }
+
+    pending_side_exits.clear();
+}
+
+/* Read the byte at the address in edx into eax. Neither path changes the host
+ * flags, so flags held there survive memory accesses */
+void BlockCompiler::read() {
+    /* Fast path: the page maps straight to host memory */
+    emitter.emit({0x0F, 0xB6, 0xCE});                   // movzx ecx, dh
+    emitter.emit({0x48, 0x8B, 0x4C, 0xCD, 0x00});       // mov rcx, [rbp + rcx * 8]
+    size_t slow_path = emitter.jrcxz8();                // jrcxz slow_path
+    emitter.emit({0x0F, 0xB6, 0xC2});                   // movzx eax, dl
+    emitter.emit({0x0F, 0xB6, 0x04, 0x01});             // movzx eax, byte [rcx + rax]
+    size_t done = emitter.jmp8();                       // jmp done
+
+    /* Slow path: call into the MMU */
+    emitter.bind8(slow_path);
+    emitter.emit({0x9C});                               // pushfq
+
+    if (instruction_index > 0) {
+        emitter.emit({0x8D, 0x8A});                     // lea ecx, [rdx - 0xFF00]
+        emitter.emit32(static_cast<u32>(-0xFF00));
+        emitter.emit({0x83, 0xF9, 0x7F});               // cmp ecx, 0x7F
+        size_t label = emitter.jcc32(x86_condition::below_or_equal); // jbe side_exit
+        pending_side_exits.push_back({label, flags, instruction_address, instruction_index, cycles});
+    }
+
+    emitter.emit({0x48, 0x8D, 0x64, 0x24, 0xF8});       // lea rsp, [rsp - 8]
+    emitter.emit({0x48, 0x8B, 0x7B, offset::mmu});      // mov rdi, [rbx + mmu]
+    emitter.emit({0x0F, 0xB7, 0xF2});                   // movzx esi, dx
+    emitter.emit({0x48, 0xB8});                         // mov rax, read_byte
+    emitter.emit64(reinterpret_cast<uintptr_t>(&read_byte));
+    emitter.emit({0xFF, 0xD0});                         // call rax
+    emitter.emit({0x48, 0x8D, 0x64, 0x24, 0x08});       // lea rsp, [rsp + 8]
+    emitter.emit({0x9D});                               // popfq
+    emitter.emit({0x0F, 0xB6, 0xC0});                   // movzx eax, al
+
+    emitter.bind8(done);
+}
+
+void BlockCompiler::address_from_pair(const u8 pair) {
+    emitter.emit({0x0F, 0xB7, 0x53, pair});             // movzx edx, word [rbx + pair]
+}
+
+void BlockCompiler::store_loaded(const uint index) {
+    if (index == register_a) {
+        emitter.emit({0x41, 0x88, 0xC4});               // mov r12b, al
+    } else {
+        emitter.emit({0x88, 0x43, register_offset(index)}); // mov [rbx + r], al
+    }
+}
+
+void BlockCompiler::ld(const uint destination, const uint source) {
+    if (source == register_hl_indirect) {
+        address_from_pair(offset::l);
+        read();
+        store_loaded(destination);
+    } else if (destination == register_a && source == register_a) {
+        /* LD A, A */
+    } else if (destination == register_a) {
+        emitter.emit({0x44, 0x8A, 0x63, register_offset(source)}); // mov r12b, [rbx + r]
+    } else if (source == register_a) {
+        emitter.emit({0x44, 0x88, 0x63, register_offset(destination)}); // mov [rbx + r], r12b
+    } else {
+        emitter.emit({0x8A, 0x43, register_offset(source)}); // mov al, [rbx + r]
+        store_loaded(destination);
+    }
+}
+
+void BlockCompiler::ld_immediate(const uint destination, const u8 value) {
+    if (destination == register_a) {
+        emitter.emit({0x41, 0xB4, value});              // mov r12b, n
+    } else {
+        emitter.emit({0xC6, 0x43, register_offset(destination), value}); // mov byte [rbx + r], n
+    }
+}
+
+void BlockCompiler::ld_pair_immediate(const u8 pair, const u16 value) {
+    emitter.emit({0x66, 0xC7, 0x43, pair});             // mov word [rbx + pair], nn
+    emitter.emit16(value);
+}
+
+/* lea doesn't touch the host flags, unlike inc/dec (which 16-bit INC/DEC
+ * wouldn't match anyway, as they don't affect any flags) */
+void BlockCompiler::step_pair(const u8 pair, const s8 step) {
+    emitter.emit({0x0F, 0xB7, 0x4B, pair});             // movzx ecx, word [rbx + pair]
+    emitter.emit({0x8D, 0x49, static_cast<u8>(step)});  // lea ecx, [rcx + step]
+    emitter.emit({0x66, 0x89, 0x4B, pair});             // mov [rbx + pair], cx
+}
+
+void BlockCompiler::inc_dec(const uint index, const bool decrement) {
+    if (index == register_a) {
+        emitter.emit({0x41, 0xFE, static_cast<u8>(decrement ? 0xCC : 0xC4)}); // inc/dec r12b
+    } else {
+        emitter.emit({0xFE, static_cast<u8>(decrement ? 0x4B : 0x43), register_offset(index)}); // inc/dec byte [rbx + r]
+    }
+
+    /* x86 inc/dec leave CF alone, as INC/DEC do C */
+    flags.zero = FlagState::Host;
+    flags.subtract = decrement ? FlagState::One : FlagState::Zero;
+    flags.half_carry = FlagState::Host;
+}
+
+void BlockCompiler::alu_register(const Operation operation, const uint index) {
+    if (index == register_hl_indirect) {
+        address_from_pair(offset::l);
+        read();
+        alu(operation, Operand::Loaded, 0);
+    } else if (index == register_a) {
+        alu(operation, Operand::A, 0);
+    } else {
+        alu(operation, Operand::Register, register_offset(index));
+    }
+}
+
+void BlockCompiler::alu(Operation operation, const Operand operand, const u8 value) {
+    /* x86 'op r8, r/m8' opcodes and 'op r/m8, imm8' extensions, in SM83 order */
+    static const u8 register_opcodes[] = {0x02, 0x12, 0x2A, 0x1A, 0x22, 0x32, 0x0A, 0x3A};
+    static const u8 immediate_extensions[] = {0, 2, 5, 3, 4, 6, 1, 7};
+
+    /* ADC and SBC take their carry in from the host's CF */
+    if (operation == Adc || operation == Sbc) {
+        switch (flags.carry) {
+            case FlagState::Host:
+                break;
+            case FlagState::Zero:
+                operation = operation == Adc ? Add : Sub;
+                break;
+            case FlagState::One:
+                emitter.emit({0xF9});                   // stc
+                break;
+            case FlagState::Guest:
+                emitter.emit({0x41, 0x0F, 0xBA, 0xE6, 0x04}); // bt r14d, 4
+                break;
+        }
+    }
+
+    u8 opcode = register_opcodes[operation];
+
+    switch (operand) {
+        case Operand::Register:
+            emitter.emit({0x44, opcode, 0x63, value});  // op r12b, [rbx + r]
+            break;
+        case Operand::A:
+            emitter.emit({0x45, opcode, 0xE4});         // op r12b, r12b
+            break;
+        case Operand::Loaded:
+            emitter.emit({0x44, opcode, 0xE0});         // op r12b, al
+            break;
+        case Operand::Immediate:
+            emitter.emit({0x41, 0x80, static_cast<u8>(0xC4 | (immediate_extensions[operation] << 3)), value}); // op r12b, n
+            break;
+    }
+
+    flags.zero = FlagState::Host;
+
+    switch (operation) {
+        case Add: case Adc:
+            flags.subtract = FlagState::Zero;
+            flags.half_carry = FlagState::Host;
+            flags.carry = FlagState::Host;
+            break;
+        case Sub: case Sbc: case Cp:
+            flags.subtract = FlagState::One;
+            flags.half_carry = FlagState::Host;
+            flags.carry = FlagState::Host;
+            break;
+        case And:
+            flags.subtract = FlagState::Zero;
+            flags.half_carry = FlagState::One;
+            flags.carry = FlagState::Zero;
+            break;
+        case Xor: case Or:
+            flags.subtract = FlagState::Zero;
+            flags.half_carry = FlagState::Zero;
+            flags.carry = FlagState::Zero;
+            break;
+    }
+}
+
+void BlockCompiler::ccf() {
+    switch (flags.carry) {
+        case FlagState::Host:
+            emitter.emit({0xF5});                       // cmc
+            break;
+        case FlagState::Zero:
+            flags.carry = FlagState::One;
+            break;
+        case FlagState::One:
+            flags.carry = FlagState::Zero;
+            break;
+        case FlagState::Guest:
+            /* xor clobbers the host flags, so nothing can be left there */
+            materialize(flags);
+            emitter.emit({0x41, 0x80, 0xF6, flags::carry}); // xor r14b, 0x10
+            break;
+    }
+
+    flags.subtract = FlagState::Zero;
+    flags.half_carry = FlagState::Zero;
+}
+
+/* Pop the return address into JitState's PC */
+void BlockCompiler::ret() {
+    address_from_pair(offset::sp);
+    read();
+    emitter.emit({0x88, 0x43, offset::pc});             // mov [rbx + pc], al
+
+    address_from_pair(offset::sp);
+    emitter.emit({0x8D, 0x52, 0x01});                   // lea edx, [rdx + 1]
+    read();
+    emitter.emit({0x88, 0x43, static_cast<u8>(offset::pc + 1)});         // mov [rbx + pc + 1], al
+
+    step_pair(offset::sp, 2);
+}
+
+void BlockCompiler::conditional(const Condition condition, const DecodedInstruction& instruction,
+                                const bool is_return, const u16 target) {
+    const auto& info = CPU::opcodes[instruction.bytes[0]];
+    u16 next_pc = static_cast<u16>(instruction.address + instruction.length);
+
+    bool on_zero = condition == Condition::Z || condition == Condition::NZ;
+    bool when_set = condition == Condition::Z || condition == Condition::C;
+    FlagState state = on_zero ? flags.zero : flags.carry;
+
+    ended = true;
+
+    auto taken = [&]() {
+        if (is_return) {
+            ret();
+            exit_to_stored_pc(flags, cycles + info.cycles_branched);
+        } else {
+            exit_to(flags, target, cycles + info.cycles_branched);
+        }
+    };
+
+    /* The condition may be known while compiling */
+    if (state == FlagState::Zero || state == FlagState::One) {
+        if ((state == FlagState::One) == when_set) {
+            taken();
+        } else {
+            exit_to(flags, next_pc, cycles + info.cycles);
+        }
+        return;
+    }
+
+    u8 jump_condition;
+    if (state == FlagState::Host) {
+        jump_condition = on_zero
+            ? (when_set ? x86_condition::zero : x86_condition::not_zero)
+            : (when_set ? x86_condition::carry : x86_condition::not_carry);
+    } else {
+        materialize(flags);
+        emitter.emit({0x41, 0xF6, 0xC6, on_zero ? flags::zero : flags::carry}); // test r14b, flag
+        jump_condition = when_set ? x86_condition::not_zero : x86_condition::zero;
+    }
+
+    size_t taken_label = emitter.jcc32(jump_condition);
+    exit_to(flags, next_pc, cycles + info.cycles);
+
+    emitter.bind32(taken_label);
+    taken();
+}
+
+} // namespace
+
+JIT::JIT(MMU& inMMU, Options& inOptions) :
+    mmu(inMMU),
+    options(inOptions)
+{
+    if (options.cpu_engine != CPUEngine::JIT) { return; }
+
+#ifdef GBEMU_JIT_SUPPORTED
+    if (options.debugger || options.trace) {
+        log_info("JIT: disabled while debugging or tracing, using the cached interpreter");
+        return;
+    }
+
+    void* memory = mmap(nullptr, code_buffer_size, PROT_READ | PROT_WRITE | PROT_EXEC,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (memory == MAP_FAILED) {
+        log_warn("JIT: could not allocate executable memory, using the cached interpreter");
+        return;
+    }
+
+    code = static_cast<u8*>(memory);
+    active = true;
+#else
+    log_warn("JIT: not supported on this platform, using the cached interpreter");
+#endif
+}
+
+JIT::~JIT() {
+#ifdef GBEMU_JIT_SUPPORTED
+    if (code != nullptr) { munmap(code, code_buffer_size); }
+#endif
+}
+
+auto JIT::compile(Block& block) -> bool {
+    if (code_buffer_size - code_used < max_block_code_size) {
+        buffer_full = true;
+        return false;
+    }
+
+    Emitter emitter(code + code_used, code_buffer_size - code_used);
+    BlockCompiler compiler(emitter, options);
+
+    uint length = compiler.compile(block);
+
+    if (length == 0 || emitter.overflowed()) {
+        block.native_failed = true;
+        return false;
+    }
+
+    block.native_code = code + code_used;
+    block.native_length = length;
+    block.native_cycles = compiler.longest_exit();
+
+    /* Keep the start of each block aligned */
+    code_used += (emitter.position() + 15) & ~static_cast<size_t>(15);
+    return true;
+}
+
+auto JIT::run(const Block& block, JitState& state) const -> uint {
+    using block_function_t = uint (*)(JitState*);
+
+    state.read_pages = mmu.read_pages.data();
+    state.mmu = &mmu;
+
+    auto function = reinterpret_cast<block_function_t>(reinterpret_cast<uintptr_t>(block.native_code));
+    return function(&state);
+}
+
+void JIT::flush() {
+    code_used = 0;
+    buffer_full = false;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "../block_cache.h"
+#include "../registers.h"
+#include "../../definitions.h"
+#include "../../options.h"
+
+#include <cstddef>
+
+#if defined(__x86_64__) && defined(__linux__)
+#define GBEMU_JIT_SUPPORTED 1
+#endif
+
+class MMU;
+
+/* CPU registers as seen by compiled code. The layout is fixed, as compiled
+ * code addresses fields by offset, and register pairs are little-endian so
+ * that e.g. BC can be accessed as a single word at the offset of C */
+struct JitState {
+    RegisterFile regs;
+
+    const u8* const* read_pages;
+    const MMU* mmu;
+
+    /* Set if the block stopped before this instruction (see
+     * BlockCompiler::read()), otherwise left at 0 */
+    u32 exit_index;
+};
+
+/*
+ * Translates hot blocks from the block cache into x86-64 code.
+ *
+ * Only a subset of instructions is supported: register loads and
+ * arithmetic, loads from memory, and jumps/returns. Stores, stack pushes and
+ * anything touching interrupts are left to the interpreter, so a block is
+ * compiled up to its first unsupported instruction and the interpreter picks
+ * up from there.
+ *
+ * A compiled block runs without the clock moving, so it only runs when it
+ * can finish before the next event, and stops before any instruction which
+ * reads an IO register after the first (whose value may depend on the time).
+ *
+ * Compiled blocks keep A and F in host registers and leave flags in the host
+ * flags register until something needs them, as x86 computes Z, H (AF) and
+ * C the same way the SM83 does for the supported arithmetic.
+ */
+class JIT {
+public:
+    JIT(MMU& inMMU, Options& inOptions);
+    ~JIT();
+
+    /* Whether blocks should be compiled at all: the JIT was selected, the
+     * host is supported, and nothing needs to see individual instructions */
+    auto enabled() const -> bool { return active; }
+
+    auto compile(Block& block) -> bool;
+    auto run(const Block& block, JitState& state) const -> uint;
+
+    /* The code buffer fills up as blocks are compiled (and code in RAM is
+     * recompiled); once it is full, every block has to be thrown away */
+    auto needs_flush() const -> bool { return buffer_full; }
+    void flush();
+
+    /* Number of times a block runs in the cached interpreter before it is compiled */
+    static const uint compile_threshold = 8;
+
+private:
+    MMU& mmu;
+    Options& options;
+
+    bool active = false;
+    bool buffer_full = false;
+
+    u8* code = nullptr;
+    size_t code_used = 0;
+};
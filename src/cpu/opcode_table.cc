@@ -0,0 +1,529 @@
+#include "cpu.h"
+/* clang-format off */
+
+/**
+ * Static dispatch tables for every opcode. Each entry holds the handler which
+ * implements the opcode, the number of cycles it takes when no branch is taken,
+ * the number of cycles it takes when a branch is taken, and its length in
+ * bytes (including the CB prefix for two-byte opcodes).
+ *
+ * Note: STOP is listed as a single byte as its operand is not consumed.
+ */
+
+const std::array<CPU::Opcode, 256> CPU::opcodes = {{
+    { &CPU::opcode_00, 1, 1, 1 }, /* 0x00: NOP */
+    { &CPU::opcode_01, 3, 3, 3 }, /* 0x01: LD BC,nn */
+    { &CPU::opcode_02, 2, 2, 1 }, /* 0x02: LD (BC),A */
+    { &CPU::opcode_03, 2, 2, 1 }, /* 0x03: INC BC */
+    { &CPU::opcode_04, 1, 1, 1 }, /* 0x04: INC B */
+    { &CPU::opcode_05, 1, 1, 1 }, /* 0x05: DEC B */
+    { &CPU::opcode_06, 2, 2, 2 }, /* 0x06: LD B,n */
+    { &CPU::opcode_07, 1, 1, 1 }, /* 0x07: RLCA */
+    { &CPU::opcode_08, 5, 5, 3 }, /* 0x08: LD (nn),SP */
+    { &CPU::opcode_09, 2, 2, 1 }, /* 0x09: ADD HL,BC */
+    { &CPU::opcode_0A, 2, 2, 1 }, /* 0x0A: LD A,(BC) */
+    { &CPU::opcode_0B, 2, 2, 1 }, /* 0x0B: DEC BC */
+    { &CPU::opcode_0C, 1, 1, 1 }, /* 0x0C: INC C */
+    { &CPU::opcode_0D, 1, 1, 1 }, /* 0x0D: DEC C */
+    { &CPU::opcode_0E, 2, 2, 2 }, /* 0x0E: LD C,n */
+    { &CPU::opcode_0F, 1, 1, 1 }, /* 0x0F: RRCA */
+    { &CPU::opcode_10, 1, 1, 1 }, /* 0x10: STOP */
+    { &CPU::opcode_11, 3, 3, 3 }, /* 0x11: LD DE,nn */
+    { &CPU::opcode_12, 2, 2, 1 }, /* 0x12: LD (DE),A */
+    { &CPU::opcode_13, 2, 2, 1 }, /* 0x13: INC DE */
+    { &CPU::opcode_14, 1, 1, 1 }, /* 0x14: INC D */
+    { &CPU::opcode_15, 1, 1, 1 }, /* 0x15: DEC D */
+    { &CPU::opcode_16, 2, 2, 2 }, /* 0x16: LD D,n */
+    { &CPU::opcode_17, 1, 1, 1 }, /* 0x17: RLA */
+    { &CPU::opcode_18, 3, 3, 2 }, /* 0x18: JR n */
+    { &CPU::opcode_19, 2, 2, 1 }, /* 0x19: ADD HL,DE */
+    { &CPU::opcode_1A, 2, 2, 1 }, /* 0x1A: LD A,(DE) */
+    { &CPU::opcode_1B, 2, 2, 1 }, /* 0x1B: DEC DE */
+    { &CPU::opcode_1C, 1, 1, 1 }, /* 0x1C: INC E */
+    { &CPU::opcode_1D, 1, 1, 1 }, /* 0x1D: DEC E */
+    { &CPU::opcode_1E, 2, 2, 2 }, /* 0x1E: LD E,n */
+    { &CPU::opcode_1F, 1, 1, 1 }, /* 0x1F: RRA */
+    { &CPU::opcode_20, 2, 3, 2 }, /* 0x20: JR NZ,n */
+    { &CPU::opcode_21, 3, 3, 3 }, /* 0x21: LD HL,nn */
+    { &CPU::opcode_22, 2, 2, 1 }, /* 0x22: LD (HL+),A */
+    { &CPU::opcode_23, 2, 2, 1 }, /* 0x23: INC HL */
+    { &CPU::opcode_24, 1, 1, 1 }, /* 0x24: INC H */
+    { &CPU::opcode_25, 1, 1, 1 }, /* 0x25: DEC H */
+    { &CPU::opcode_26, 2, 2, 2 }, /* 0x26: LD H,n */
+    { &CPU::opcode_27, 1, 1, 1 }, /* 0x27: DAA */
+    { &CPU::opcode_28, 2, 3, 2 }, /* 0x28: JR Z,n */
+    { &CPU::opcode_29, 2, 2, 1 }, /* 0x29: ADD HL,HL */
+    { &CPU::opcode_2A, 2, 2, 1 }, /* 0x2A: LD A,(HLI) */
+    { &CPU::opcode_2B, 2, 2, 1 }, /* 0x2B: DEC HL */
+    { &CPU::opcode_2C, 1, 1, 1 }, /* 0x2C: INC L */
+    { &CPU::opcode_2D, 1, 1, 1 }, /* 0x2D: DEC L */
+    { &CPU::opcode_2E, 2, 2, 2 }, /* 0x2E: LD L,n */
+    { &CPU::opcode_2F, 1, 1, 1 }, /* 0x2F: CPL */
+    { &CPU::opcode_30, 2, 3, 2 }, /* 0x30: JR NC,n */
+    { &CPU::opcode_31, 3, 3, 3 }, /* 0x31: LD SP,nn */
+    { &CPU::opcode_32, 2, 2, 1 }, /* 0x32: LD (HL-),A */
+    { &CPU::opcode_33, 2, 2, 1 }, /* 0x33: INC SP */
+    { &CPU::opcode_34, 3, 3, 1 }, /* 0x34: INC (HL) */
+    { &CPU::opcode_35, 3, 3, 1 }, /* 0x35: DEC (HL) */
+    { &CPU::opcode_36, 3, 3, 2 }, /* 0x36: LD (HL),n */
+    { &CPU::opcode_37, 1, 1, 1 }, /* 0x37: SCF */
+    { &CPU::opcode_38, 2, 3, 2 }, /* 0x38: JR C,n */
+    { &CPU::opcode_39, 2, 2, 1 }, /* 0x39: ADD HL,SP */
+    { &CPU::opcode_3A, 2, 2, 1 }, /* 0x3A: LD A,(HLD) */
+    { &CPU::opcode_3B, 2, 2, 1 }, /* 0x3B: DEC SP */
+    { &CPU::opcode_3C, 1, 1, 1 }, /* 0x3C: INC A */
+    { &CPU::opcode_3D, 1, 1, 1 }, /* 0x3D: DEC A */
+    { &CPU::opcode_3E, 2, 2, 2 }, /* 0x3E: LDA,n */
+    { &CPU::opcode_3F, 1, 1, 1 }, /* 0x3F: CCF */
+    { &CPU::opcode_40, 1, 1, 1 }, /* 0x40: LD B,B */
+    { &CPU::opcode_41, 1, 1, 1 }, /* 0x41: LD B,C */
+    { &CPU::opcode_42, 1, 1, 1 }, /* 0x42: LD B,D */
+    { &CPU::opcode_43, 1, 1, 1 }, /* 0x43: LD B,E */
+    { &CPU::opcode_44, 1, 1, 1 }, /* 0x44: LD B,H */
+    { &CPU::opcode_45, 1, 1, 1 }, /* 0x45: LD B,L */
+    { &CPU::opcode_46, 2, 2, 1 }, /* 0x46: LD B,(HL) */
+    { &CPU::opcode_47, 1, 1, 1 }, /* 0x47: LD B,A */
+    { &CPU::opcode_48, 1, 1, 1 }, /* 0x48: LD C,B */
+    { &CPU::opcode_49, 1, 1, 1 }, /* 0x49: LD C,C */
+    { &CPU::opcode_4A, 1, 1, 1 }, /* 0x4A: LD C,D */
+    { &CPU::opcode_4B, 1, 1, 1 }, /* 0x4B: LD C,E */
+    { &CPU::opcode_4C, 1, 1, 1 }, /* 0x4C: LD C,H */
+    { &CPU::opcode_4D, 1, 1, 1 }, /* 0x4D: LD C,L */
+    { &CPU::opcode_4E, 2, 2, 1 }, /* 0x4E: LD C,(HL) */
+    { &CPU::opcode_4F, 1, 1, 1 }, /* 0x4F: LD C,A */
+    { &CPU::opcode_50, 1, 1, 1 }, /* 0x50: LD D,B */
+    { &CPU::opcode_51, 1, 1, 1 }, /* 0x51: LD D,C */
+    { &CPU::opcode_52, 1, 1, 1 }, /* 0x52: LD D,D */
+    { &CPU::opcode_53, 1, 1, 1 }, /* 0x53: LD D,E */
+    { &CPU::opcode_54, 1, 1, 1 }, /* 0x54: LD D,H */
+    { &CPU::opcode_55, 1, 1, 1 }, /* 0x55: LD D,L */
+    { &CPU::opcode_56, 2, 2, 1 }, /* 0x56: LD D,(HL) */
+    { &CPU::opcode_57, 1, 1, 1 }, /* 0x57: LD D,A */
+    { &CPU::opcode_58, 1, 1, 1 }, /* 0x58: LD E,B */
+    { &CPU::opcode_59, 1, 1, 1 }, /* 0x59: LD E,C */
+    { &CPU::opcode_5A, 1, 1, 1 }, /* 0x5A: LD E,D */
+    { &CPU::opcode_5B, 1, 1, 1 }, /* 0x5B: LD E,E */
+    { &CPU::opcode_5C, 1, 1, 1 }, /* 0x5C: LD E,H */
+    { &CPU::opcode_5D, 1, 1, 1 }, /* 0x5D: LD E,L */
+    { &CPU::opcode_5E, 2, 2, 1 }, /* 0x5E: LD E,(HL) */
+    { &CPU::opcode_5F, 1, 1, 1 }, /* 0x5F: LD E,A */
+    { &CPU::opcode_60, 1, 1, 1 }, /* 0x60: LD H,B */
+    { &CPU::opcode_61, 1, 1, 1 }, /* 0x61: LD H,C */
+    { &CPU::opcode_62, 1, 1, 1 }, /* 0x62: LD H,D */
+    { &CPU::opcode_63, 1, 1, 1 }, /* 0x63: LD H,E */
+    { &CPU::opcode_64, 1, 1, 1 }, /* 0x64: LD H,H */
+    { &CPU::opcode_65, 1, 1, 1 }, /* 0x65: LD H,L */
+    { &CPU::opcode_66, 2, 2, 1 }, /* 0x66: LD H,(HL) */
+    { &CPU::opcode_67, 1, 1, 1 }, /* 0x67: LD H,A */
+    { &CPU::opcode_68, 1, 1, 1 }, /* 0x68: LD L,B */
+    { &CPU::opcode_69, 1, 1, 1 }, /* 0x69: LD L,C */
+    { &CPU::opcode_6A, 1, 1, 1 }, /* 0x6A: LD L,D */
+    { &CPU::opcode_6B, 1, 1, 1 }, /* 0x6B: LD L,E */
+    { &CPU::opcode_6C, 1, 1, 1 }, /* 0x6C: LD L,H */
+    { &CPU::opcode_6D, 1, 1, 1 }, /* 0x6D: LD L,L */
+    { &CPU::opcode_6E, 2, 2, 1 }, /* 0x6E: LD L,(HL) */
+    { &CPU::opcode_6F, 1, 1, 1 }, /* 0x6F: LD L,A */
+    { &CPU::opcode_70, 2, 2, 1 }, /* 0x70: LD (HL),B */
+    { &CPU::opcode_71, 2, 2, 1 }, /* 0x71: LD (HL),C */
+    { &CPU::opcode_72, 2, 2, 1 }, /* 0x72: LD (HL),D */
+    { &CPU::opcode_73, 2, 2, 1 }, /* 0x73: LD (HL),E */
+    { &CPU::opcode_74, 2, 2, 1 }, /* 0x74: LD (HL),H */
+    { &CPU::opcode_75, 2, 2, 1 }, /* 0x75: LD (HL),L */
+    { &CPU::opcode_76, 1, 1, 1 }, /* 0x76: HALT */
+    { &CPU::opcode_77, 2, 2, 1 }, /* 0x77: LD (HL),A */
+    { &CPU::opcode_78, 1, 1, 1 }, /* 0x78: LD A,B */
+    { &CPU::opcode_79, 1, 1, 1 }, /* 0x79: LD A,C */
+    { &CPU::opcode_7A, 1, 1, 1 }, /* 0x7A: LD A,D */
+    { &CPU::opcode_7B, 1, 1, 1 }, /* 0x7B: LD A,E */
+    { &CPU::opcode_7C, 1, 1, 1 }, /* 0x7C: LD A,H */
+    { &CPU::opcode_7D, 1, 1, 1 }, /* 0x7D: LD A,L */
+    { &CPU::opcode_7E, 2, 2, 1 }, /* 0x7E: LD A,(HL) */
+    { &CPU::opcode_7F, 1, 1, 1 }, /* 0x7F: LD A,A */
+    { &CPU::opcode_80, 1, 1, 1 }, /* 0x80: ADD A,B */
+    { &CPU::opcode_81, 1, 1, 1 }, /* 0x81: ADD A,C */
+    { &CPU::opcode_82, 1, 1, 1 }, /* 0x82: ADD A,D */
+    { &CPU::opcode_83, 1, 1, 1 }, /* 0x83: ADD A,E */
+    { &CPU::opcode_84, 1, 1, 1 }, /* 0x84: ADD A,H */
+    { &CPU::opcode_85, 1, 1, 1 }, /* 0x85: ADD A,L */
+    { &CPU::opcode_86, 2, 2, 1 }, /* 0x86: ADD A,(HL) */
+    { &CPU::opcode_87, 1, 1, 1 }, /* 0x87: ADD A,A */
+    { &CPU::opcode_88, 1, 1, 1 }, /* 0x88: ADC A,B */
+    { &CPU::opcode_89, 1, 1, 1 }, /* 0x89: ADC A,C */
+    { &CPU::opcode_8A, 1, 1, 1 }, /* 0x8A: ADC A,D */
+    { &CPU::opcode_8B, 1, 1, 1 }, /* 0x8B: ADC A,E */
+    { &CPU::opcode_8C, 1, 1, 1 }, /* 0x8C: ADC A,H */
+    { &CPU::opcode_8D, 1, 1, 1 }, /* 0x8D: ADC A,L */
+    { &CPU::opcode_8E, 2, 2, 1 }, /* 0x8E: ADC A,(HL) */
+    { &CPU::opcode_8F, 1, 1, 1 }, /* 0x8F: ADC A,A */
+    { &CPU::opcode_90, 1, 1, 1 }, /* 0x90: SUB B */
+    { &CPU::opcode_91, 1, 1, 1 }, /* 0x91: SUB C */
+    { &CPU::opcode_92, 1, 1, 1 }, /* 0x92: SUB D */
+    { &CPU::opcode_93, 1, 1, 1 }, /* 0x93: SUB E */
+    { &CPU::opcode_94, 1, 1, 1 }, /* 0x94: SUB H */
+    { &CPU::opcode_95, 1, 1, 1 }, /* 0x95: SUB L */
+    { &CPU::opcode_96, 2, 2, 1 }, /* 0x96: SUB (HL) */
+    { &CPU::opcode_97, 1, 1, 1 }, /* 0x97: SUB A */
+    { &CPU::opcode_98, 1, 1, 1 }, /* 0x98: SBC A,B */
+    { &CPU::opcode_99, 1, 1, 1 }, /* 0x99: SBC A,C */
+    { &CPU::opcode_9A, 1, 1, 1 }, /* 0x9A: SBC A,D */
+    { &CPU::opcode_9B, 1, 1, 1 }, /* 0x9B: SBC A,E */
+    { &CPU::opcode_9C, 1, 1, 1 }, /* 0x9C: SBC A,H */
+    { &CPU::opcode_9D, 1, 1, 1 }, /* 0x9D: SBC A,L */
+    { &CPU::opcode_9E, 2, 2, 1 }, /* 0x9E: SBC A,(HL) */
+    { &CPU::opcode_9F, 1, 1, 1 }, /* 0x9F: SBC A,A */
+    { &CPU::opcode_A0, 1, 1, 1 }, /* 0xA0: AND B */
+    { &CPU::opcode_A1, 1, 1, 1 }, /* 0xA1: AND C */
+    { &CPU::opcode_A2, 1, 1, 1 }, /* 0xA2: AND D */
+    { &CPU::opcode_A3, 1, 1, 1 }, /* 0xA3: AND E */
+    { &CPU::opcode_A4, 1, 1, 1 }, /* 0xA4: AND H */
+    { &CPU::opcode_A5, 1, 1, 1 }, /* 0xA5: AND L */
+    { &CPU::opcode_A6, 2, 2, 1 }, /* 0xA6: AND (HL) */
+    { &CPU::opcode_A7, 1, 1, 1 }, /* 0xA7: AND A */
+    { &CPU::opcode_A8, 1, 1, 1 }, /* 0xA8: XOR B */
+    { &CPU::opcode_A9, 1, 1, 1 }, /* 0xA9: XOR C */
+    { &CPU::opcode_AA, 1, 1, 1 }, /* 0xAA: XOR D */
+    { &CPU::opcode_AB, 1, 1, 1 }, /* 0xAB: XOR E */
+    { &CPU::opcode_AC, 1, 1, 1 }, /* 0xAC: XOR H */
+    { &CPU::opcode_AD, 1, 1, 1 }, /* 0xAD: XOR L */
+    { &CPU::opcode_AE, 2, 2, 1 }, /* 0xAE: XOR (HL) */
+    { &CPU::opcode_AF, 1, 1, 1 }, /* 0xAF: XOR A */
+    { &CPU::opcode_B0, 1, 1, 1 }, /* 0xB0: OR B */
+    { &CPU::opcode_B1, 1, 1, 1 }, /* 0xB1: OR C */
+    { &CPU::opcode_B2, 1, 1, 1 }, /* 0xB2: OR D */
+    { &CPU::opcode_B3, 1, 1, 1 }, /* 0xB3: OR E */
+    { &CPU::opcode_B4, 1, 1, 1 }, /* 0xB4: OR H */
+    { &CPU::opcode_B5, 1, 1, 1 }, /* 0xB5: OR L */
+    { &CPU::opcode_B6, 2, 2, 1 }, /* 0xB6: OR (HL) */
+    { &CPU::opcode_B7, 1, 1, 1 }, /* 0xB7: OR A */
+    { &CPU::opcode_B8, 1, 1, 1 }, /* 0xB8: CP B */
+    { &CPU::opcode_B9, 1, 1, 1 }, /* 0xB9: CP C */
+    { &CPU::opcode_BA, 1, 1, 1 }, /* 0xBA: CP D */
+    { &CPU::opcode_BB, 1, 1, 1 }, /* 0xBB: CP E */
+    { &CPU::opcode_BC, 1, 1, 1 }, /* 0xBC: CP H */
+    { &CPU::opcode_BD, 1, 1, 1 }, /* 0xBD: CP L */
+    { &CPU::opcode_BE, 2, 2, 1 }, /* 0xBE: CP (HL) */
+    { &CPU::opcode_BF, 1, 1, 1 }, /* 0xBF: CP A */
+    { &CPU::opcode_C0, 2, 5, 1 }, /* 0xC0: RET NZ */
+    { &CPU::opcode_C1, 3, 3, 1 }, /* 0xC1: POP BC */
+    { &CPU::opcode_C2, 3, 4, 3 }, /* 0xC2: JP NZ,nn */
+    { &CPU::opcode_C3, 4, 4, 3 }, /* 0xC3: JP nn */
+    { &CPU::opcode_C4, 3, 6, 3 }, /* 0xC4: CALL NZ,nn */
+    { &CPU::opcode_C5, 4, 4, 1 }, /* 0xC5: PUSH BC */
+    { &CPU::opcode_C6, 2, 2, 2 }, /* 0xC6: ADD A,n */
+    { &CPU::opcode_C7, 4, 4, 1 }, /* 0xC7: RST  */
+    { &CPU::opcode_C8, 2, 5, 1 }, /* 0xC8: RET Z */
+    { &CPU::opcode_C9, 4, 4, 1 }, /* 0xC9: RET */
+    { &CPU::opcode_CA, 3, 4, 3 }, /* 0xCA: JP Z,nn */
+    { &CPU::opcode_CB, 0, 0, 2 }, /* 0xCB: cb opcode */
+    { &CPU::opcode_CC, 3, 6, 3 }, /* 0xCC: CALL Z,nn */
+    { &CPU::opcode_CD, 6, 6, 3 }, /* 0xCD: CALL nn */
+    { &CPU::opcode_CE, 2, 2, 2 }, /* 0xCE: ADC A,n */
+    { &CPU::opcode_CF, 4, 4, 1 }, /* 0xCF: RST 0x08 */
+    { &CPU::opcode_D0, 2, 5, 1 }, /* 0xD0: RET NC */
+    { &CPU::opcode_D1, 3, 3, 1 }, /* 0xD1: POP DE */
+    { &CPU::opcode_D2, 3, 4, 3 }, /* 0xD2: JP NC,nn */
+    { &CPU::opcode_D3, 0, 0, 1 }, /* 0xD3: unused opcode */
+    { &CPU::opcode_D4, 3, 6, 3 }, /* 0xD4: CALL NC,nn */
+    { &CPU::opcode_D5, 4, 4, 1 }, /* 0xD5: PUSH DE */
+    { &CPU::opcode_D6, 2, 2, 2 }, /* 0xD6: SUB n */
+    { &CPU::opcode_D7, 4, 4, 1 }, /* 0xD7: RST 0x10 */
+    { &CPU::opcode_D8, 2, 5, 1 }, /* 0xD8: RET C */
+    { &CPU::opcode_D9, 4, 4, 1 }, /* 0xD9: RETI */
+    { &CPU::opcode_DA, 3, 4, 3 }, /* 0xDA: JP C,nn */
+    { &CPU::opcode_DB, 0, 0, 1 }, /* 0xDB: unused opcode */
+    { &CPU::opcode_DC, 3, 6, 3 }, /* 0xDC: CALL C,nn */
+    { &CPU::opcode_DD, 0, 0, 1 }, /* 0xDD: unused opcode */
+    { &CPU::opcode_DE, 2, 2, 2 }, /* 0xDE: SBC A,n */
+    { &CPU::opcode_DF, 4, 4, 1 }, /* 0xDF: RST 0x18 */
+    { &CPU::opcode_E0, 3, 3, 2 }, /* 0xE0: LD (0xFF00+n),A */
+    { &CPU::opcode_E1, 3, 3, 1 }, /* 0xE1: POP HL */
+    { &CPU::opcode_E2, 2, 2, 1 }, /* 0xE2: LD (0xFF00+C),A */
+    { &CPU::opcode_E3, 0, 0, 1 }, /* 0xE3: unused opcode */
+    { &CPU::opcode_E4, 0, 0, 1 }, /* 0xE4: unused opcode */
+    { &CPU::opcode_E5, 4, 4, 1 }, /* 0xE5: PUSH HL */
+    { &CPU::opcode_E6, 2, 2, 2 }, /* 0xE6: AND n */
+    { &CPU::opcode_E7, 4, 4, 1 }, /* 0xE7: RST 0x20 */
+    { &CPU::opcode_E8, 4, 4, 2 }, /* 0xE8: ADD SP,n */
+    { &CPU::opcode_E9, 1, 1, 1 }, /* 0xE9: JP (HL) */
+    { &CPU::opcode_EA, 4, 4, 3 }, /* 0xEA: LD (nn),A */
+    { &CPU::opcode_EB, 0, 0, 1 }, /* 0xEB: unused opcode */
+    { &CPU::opcode_EC, 0, 0, 1 }, /* 0xEC: unused opcode */
+    { &CPU::opcode_ED, 0, 0, 1 }, /* 0xED: unused opcode */
+    { &CPU::opcode_EE, 2, 2, 2 }, /* 0xEE: XOR n */
+    { &CPU::opcode_EF, 4, 4, 1 }, /* 0xEF: RST 0x28 */
+    { &CPU::opcode_F0, 3, 3, 2 }, /* 0xF0: LD A,(0xFF00+n) */
+    { &CPU::opcode_F1, 3, 3, 1 }, /* 0xF1: POP AF */
+    { &CPU::opcode_F2, 2, 2, 1 }, /* 0xF2: LD A,(0xFF00+C) */
+    { &CPU::opcode_F3, 1, 1, 1 }, /* 0xF3: DI */
+    { &CPU::opcode_F4, 0, 0, 1 }, /* 0xF4: unused opcode */
+    { &CPU::opcode_F5, 4, 4, 1 }, /* 0xF5: PUSH AF */
+    { &CPU::opcode_F6, 2, 2, 2 }, /* 0xF6: OR n */
+    { &CPU::opcode_F7, 4, 4, 1 }, /* 0xF7: RST 0x30 */
+    { &CPU::opcode_F8, 3, 3, 2 }, /* 0xF8: LD HL,SP */
+    { &CPU::opcode_F9, 2, 2, 1 }, /* 0xF9: LD SP,HL */
+    { &CPU::opcode_FA, 4, 4, 3 }, /* 0xFA: LD A,(nn) */
+    { &CPU::opcode_FB, 1, 1, 1 }, /* 0xFB: EI */
+    { &CPU::opcode_FC, 0, 0, 1 }, /* 0xFC: unused opcode */
+    { &CPU::opcode_FD, 0, 0, 1 }, /* 0xFD: unused opcode */
+    { &CPU::opcode_FE, 2, 2, 2 }, /* 0xFE: CP n */
+    { &CPU::opcode_FF, 4, 4, 1 }, /* 0xFF: RST 0x38 */
+}};
+
+const std::array<CPU::Opcode, 256> CPU::cb_opcodes = {{
+    { &CPU::opcode_CB_00, 2, 2, 2 }, /* CB 0x00: RLC B */
+    { &CPU::opcode_CB_01, 2, 2, 2 }, /* CB 0x01: RLC C */
+    { &CPU::opcode_CB_02, 2, 2, 2 }, /* CB 0x02: RLC D */
+    { &CPU::opcode_CB_03, 2, 2, 2 }, /* CB 0x03: RLC E */
+    { &CPU::opcode_CB_04, 2, 2, 2 }, /* CB 0x04: RLC H */
+    { &CPU::opcode_CB_05, 2, 2, 2 }, /* CB 0x05: RLC L */
+    { &CPU::opcode_CB_06, 4, 4, 2 }, /* CB 0x06: RLC (HL) */
+    { &CPU::opcode_CB_07, 2, 2, 2 }, /* CB 0x07: RLC A */
+    { &CPU::opcode_CB_08, 2, 2, 2 }, /* CB 0x08: RRC B */
+    { &CPU::opcode_CB_09, 2, 2, 2 }, /* CB 0x09: RRC C */
+    { &CPU::opcode_CB_0A, 2, 2, 2 }, /* CB 0x0A: RRC D */
+    { &CPU::opcode_CB_0B, 2, 2, 2 }, /* CB 0x0B: RRC E */
+    { &CPU::opcode_CB_0C, 2, 2, 2 }, /* CB 0x0C: RRC H */
+    { &CPU::opcode_CB_0D, 2, 2, 2 }, /* CB 0x0D: RRC L */
+    { &CPU::opcode_CB_0E, 4, 4, 2 }, /* CB 0x0E: RRC (HL) */
+    { &CPU::opcode_CB_0F, 2, 2, 2 }, /* CB 0x0F: RRC A */
+    { &CPU::opcode_CB_10, 2, 2, 2 }, /* CB 0x10: RL B */
+    { &CPU::opcode_CB_11, 2, 2, 2 }, /* CB 0x11: RL C */
+    { &CPU::opcode_CB_12, 2, 2, 2 }, /* CB 0x12: RL D */
+    { &CPU::opcode_CB_13, 2, 2, 2 }, /* CB 0x13: RL E */
+    { &CPU::opcode_CB_14, 2, 2, 2 }, /* CB 0x14: RL H */
+    { &CPU::opcode_CB_15, 2, 2, 2 }, /* CB 0x15: RL L  */
+    { &CPU::opcode_CB_16, 4, 4, 2 }, /* CB 0x16: RL (HL) */
+    { &CPU::opcode_CB_17, 2, 2, 2 }, /* CB 0x17: RL A */
+    { &CPU::opcode_CB_18, 2, 2, 2 }, /* CB 0x18: RR B */
+    { &CPU::opcode_CB_19, 2, 2, 2 }, /* CB 0x19: RR C */
+    { &CPU::opcode_CB_1A, 2, 2, 2 }, /* CB 0x1A: RR D */
+    { &CPU::opcode_CB_1B, 2, 2, 2 }, /* CB 0x1B: RR E */
+    { &CPU::opcode_CB_1C, 2, 2, 2 }, /* CB 0x1C: RR H */
+    { &CPU::opcode_CB_1D, 2, 2, 2 }, /* CB 0x1D: RR L */
+    { &CPU::opcode_CB_1E, 4, 4, 2 }, /* CB 0x1E: RR (HL) */
+    { &CPU::opcode_CB_1F, 2, 2, 2 }, /* CB 0x1F: RR A */
+    { &CPU::opcode_CB_20, 2, 2, 2 }, /* CB 0x20: SLA B */
+    { &CPU::opcode_CB_21, 2, 2, 2 }, /* CB 0x21: SLA C */
+    { &CPU::opcode_CB_22, 2, 2, 2 }, /* CB 0x22: SLA D */
+    { &CPU::opcode_CB_23, 2, 2, 2 }, /* CB 0x23: SLA E */
+    { &CPU::opcode_CB_24, 2, 2, 2 }, /* CB 0x24: SLA H */
+    { &CPU::opcode_CB_25, 2, 2, 2 }, /* CB 0x25: SLA L */
+    { &CPU::opcode_CB_26, 4, 4, 2 }, /* CB 0x26: SLA (HL) */
+    { &CPU::opcode_CB_27, 2, 2, 2 }, /* CB 0x27: SLA A */
+    { &CPU::opcode_CB_28, 2, 2, 2 }, /* CB 0x28: SRA B */
+    { &CPU::opcode_CB_29, 2, 2, 2 }, /* CB 0x29: SRA C */
+    { &CPU::opcode_CB_2A, 2, 2, 2 }, /* CB 0x2A: SRA D */
+    { &CPU::opcode_CB_2B, 2, 2, 2 }, /* CB 0x2B: SRA E */
+    { &CPU::opcode_CB_2C, 2, 2, 2 }, /* CB 0x2C: SRA H */
+    { &CPU::opcode_CB_2D, 2, 2, 2 }, /* CB 0x2D: SRA L */
+    { &CPU::opcode_CB_2E, 4, 4, 2 }, /* CB 0x2E: SRA (HL) */
+    { &CPU::opcode_CB_2F, 2, 2, 2 }, /* CB 0x2F: SRA A */
+    { &CPU::opcode_CB_30, 2, 2, 2 }, /* CB 0x30: SWAP B */
+    { &CPU::opcode_CB_31, 2, 2, 2 }, /* CB 0x31: SWAP C */
+    { &CPU::opcode_CB_32, 2, 2, 2 }, /* CB 0x32: SWAP D */
+    { &CPU::opcode_CB_33, 2, 2, 2 }, /* CB 0x33: SWAP E */
+    { &CPU::opcode_CB_34, 2, 2, 2 }, /* CB 0x34: SWAP H */
+    { &CPU::opcode_CB_35, 2, 2, 2 }, /* CB 0x35: SWAP L */
+    { &CPU::opcode_CB_36, 4, 4, 2 }, /* CB 0x36: SWAP (HL) */
+    { &CPU::opcode_CB_37, 2, 2, 2 }, /* CB 0x37: SWAP A */
+    { &CPU::opcode_CB_38, 2, 2, 2 }, /* CB 0x38: SRL B */
+    { &CPU::opcode_CB_39, 2, 2, 2 }, /* CB 0x39: SRL C */
+    { &CPU::opcode_CB_3A, 2, 2, 2 }, /* CB 0x3A: SRL D */
+    { &CPU::opcode_CB_3B, 2, 2, 2 }, /* CB 0x3B: SRL E */
+    { &CPU::opcode_CB_3C, 2, 2, 2 }, /* CB 0x3C: SRL H */
+    { &CPU::opcode_CB_3D, 2, 2, 2 }, /* CB 0x3D: SRL L */
+    { &CPU::opcode_CB_3E, 4, 4, 2 }, /* CB 0x3E: SRL (HL) */
+    { &CPU::opcode_CB_3F, 2, 2, 2 }, /* CB 0x3F: SRL A */
+    { &CPU::opcode_CB_40, 2, 2, 2 }, /* CB 0x40: BIT 0 B */
+    { &CPU::opcode_CB_41, 2, 2, 2 }, /* CB 0x41: BIT 0 C */
+    { &CPU::opcode_CB_42, 2, 2, 2 }, /* CB 0x42: BIT 0 D */
+    { &CPU::opcode_CB_43, 2, 2, 2 }, /* CB 0x43: BIT 0 E */
+    { &CPU::opcode_CB_44, 2, 2, 2 }, /* CB 0x44: BIT 0 H */
+    { &CPU::opcode_CB_45, 2, 2, 2 }, /* CB 0x45: BIT 0 L */
+    { &CPU::opcode_CB_46, 3, 3, 2 }, /* CB 0x46: BIT 0 (HL) */
+    { &CPU::opcode_CB_47, 2, 2, 2 }, /* CB 0x47: BIT 0 A */
+    { &CPU::opcode_CB_48, 2, 2, 2 }, /* CB 0x48: BIT 1 B */
+    { &CPU::opcode_CB_49, 2, 2, 2 }, /* CB 0x49: BIT 1 C */
+    { &CPU::opcode_CB_4A, 2, 2, 2 }, /* CB 0x4A: BIT 1 D */
+    { &CPU::opcode_CB_4B, 2, 2, 2 }, /* CB 0x4B: BIT 1 E */
+    { &CPU::opcode_CB_4C, 2, 2, 2 }, /* CB 0x4C: BIT 1 H */
+    { &CPU::opcode_CB_4D, 2, 2, 2 }, /* CB 0x4D: BIT 1 L */
+    { &CPU::opcode_CB_4E, 3, 3, 2 }, /* CB 0x4E: BIT 1 (HL) */
+    { &CPU::opcode_CB_4F, 2, 2, 2 }, /* CB 0x4F: BIT 1 A */
+    { &CPU::opcode_CB_50, 2, 2, 2 }, /* CB 0x50: BIT 2 B */
+    { &CPU::opcode_CB_51, 2, 2, 2 }, /* CB 0x51: BIT 2 C */
+    { &CPU::opcode_CB_52, 2, 2, 2 }, /* CB 0x52: BIT 2 D */
+    { &CPU::opcode_CB_53, 2, 2, 2 }, /* CB 0x53: BIT 2 E */
+    { &CPU::opcode_CB_54, 2, 2, 2 }, /* CB 0x54: BIT 2 H */
+    { &CPU::opcode_CB_55, 2, 2, 2 }, /* CB 0x55: BIT 2 L */
+    { &CPU::opcode_CB_56, 3, 3, 2 }, /* CB 0x56: BIT 2 (HL) */
+    { &CPU::opcode_CB_57, 2, 2, 2 }, /* CB 0x57: BIT 2 A */
+    { &CPU::opcode_CB_58, 2, 2, 2 }, /* CB 0x58: BIT 3 B */
+    { &CPU::opcode_CB_59, 2, 2, 2 }, /* CB 0x59: BIT 3 C */
+    { &CPU::opcode_CB_5A, 2, 2, 2 }, /* CB 0x5A: BIT 3 D */
+    { &CPU::opcode_CB_5B, 2, 2, 2 }, /* CB 0x5B: BIT 3 E */
+    { &CPU::opcode_CB_5C, 2, 2, 2 }, /* CB 0x5C: BIT 3 H */
+    { &CPU::opcode_CB_5D, 2, 2, 2 }, /* CB 0x5D: BIT 3 L */
+    { &CPU::opcode_CB_5E, 3, 3, 2 }, /* CB 0x5E: BIT 3 (HL) */
+    { &CPU::opcode_CB_5F, 2, 2, 2 }, /* CB 0x5F: BIT 3 A */
+    { &CPU::opcode_CB_60, 2, 2, 2 }, /* CB 0x60: BIT 4 B */
+    { &CPU::opcode_CB_61, 2, 2, 2 }, /* CB 0x61: BIT 4 C */
+    { &CPU::opcode_CB_62, 2, 2, 2 }, /* CB 0x62: BIT 4 D */
+    { &CPU::opcode_CB_63, 2, 2, 2 }, /* CB 0x63: BIT 4 E */
+    { &CPU::opcode_CB_64, 2, 2, 2 }, /* CB 0x64: BIT 4 H */
+    { &CPU::opcode_CB_65, 2, 2, 2 }, /* CB 0x65: BIT 4 L */
+    { &CPU::opcode_CB_66, 3, 3, 2 }, /* CB 0x66: BIT 4 (HL) */
+    { &CPU::opcode_CB_67, 2, 2, 2 }, /* CB 0x67: BIT 4 A */
+    { &CPU::opcode_CB_68, 2, 2, 2 }, /* CB 0x68: BIT 5 B */
+    { &CPU::opcode_CB_69, 2, 2, 2 }, /* CB 0x69: BIT 5 C */
+    { &CPU::opcode_CB_6A, 2, 2, 2 }, /* CB 0x6A: BIT 5 D */
+    { &CPU::opcode_CB_6B, 2, 2, 2 }, /* CB 0x6B: BIT 5 E */
+    { &CPU::opcode_CB_6C, 2, 2, 2 }, /* CB 0x6C: BIT 5 H */
+    { &CPU::opcode_CB_6D, 2, 2, 2 }, /* CB 0x6D: BIT 5 L */
+    { &CPU::opcode_CB_6E, 3, 3, 2 }, /* CB 0x6E: BIT 5 (HL) */
+    { &CPU::opcode_CB_6F, 2, 2, 2 }, /* CB 0x6F: BIT 5 A */
+    { &CPU::opcode_CB_70, 2, 2, 2 }, /* CB 0x70: BIT 6 B */
+    { &CPU::opcode_CB_71, 2, 2, 2 }, /* CB 0x71: BIT 6 C */
+    { &CPU::opcode_CB_72, 2, 2, 2 }, /* CB 0x72: BIT 6 D */
+    { &CPU::opcode_CB_73, 2, 2, 2 }, /* CB 0x73: BIT 6 E */
+    { &CPU::opcode_CB_74, 2, 2, 2 }, /* CB 0x74: BIT 6 H */
+    { &CPU::opcode_CB_75, 2, 2, 2 }, /* CB 0x75: BIT 6 L */
+    { &CPU::opcode_CB_76, 3, 3, 2 }, /* CB 0x76: BIT 6 (HL) */
+    { &CPU::opcode_CB_77, 2, 2, 2 }, /* CB 0x77: BIT 6 A */
+    { &CPU::opcode_CB_78, 2, 2, 2 }, /* CB 0x78: BIT 7 B */
+    { &CPU::opcode_CB_79, 2, 2, 2 }, /* CB 0x79: BIT 7 C */
+    { &CPU::opcode_CB_7A, 2, 2, 2 }, /* CB 0x7A: BIT 7 D */
+    { &CPU::opcode_CB_7B, 2, 2, 2 }, /* CB 0x7B: BIT 7 E */
+    { &CPU::opcode_CB_7C, 2, 2, 2 }, /* CB 0x7C: BIT 7 H */
+    { &CPU::opcode_CB_7D, 2, 2, 2 }, /* CB 0x7D: BIT 7 L */
+    { &CPU::opcode_CB_7E, 3, 3, 2 }, /* CB 0x7E: BIT 7 (HL) */
+    { &CPU::opcode_CB_7F, 2, 2, 2 }, /* CB 0x7F: BIT 7 A */
+    { &CPU::opcode_CB_80, 2, 2, 2 }, /* CB 0x80: RES 0 B */
+    { &CPU::opcode_CB_81, 2, 2, 2 }, /* CB 0x81: RES 0 C */
+    { &CPU::opcode_CB_82, 2, 2, 2 }, /* CB 0x82: RES 0 D */
+    { &CPU::opcode_CB_83, 2, 2, 2 }, /* CB 0x83: RES 0 E */
+    { &CPU::opcode_CB_84, 2, 2, 2 }, /* CB 0x84: RES 0 H */
+    { &CPU::opcode_CB_85, 2, 2, 2 }, /* CB 0x85: RES 0 L */
+    { &CPU::opcode_CB_86, 4, 4, 2 }, /* CB 0x86: RES 0 (HL) */
+    { &CPU::opcode_CB_87, 2, 2, 2 }, /* CB 0x87: RES 0 A */
+    { &CPU::opcode_CB_88, 2, 2, 2 }, /* CB 0x88: RES 1 B */
+    { &CPU::opcode_CB_89, 2, 2, 2 }, /* CB 0x89: RES 1 C */
+    { &CPU::opcode_CB_8A, 2, 2, 2 }, /* CB 0x8A: RES 1 D */
+    { &CPU::opcode_CB_8B, 2, 2, 2 }, /* CB 0x8B: RES 1 E */
+    { &CPU::opcode_CB_8C, 2, 2, 2 }, /* CB 0x8C: RES 1 H */
+    { &CPU::opcode_CB_8D, 2, 2, 2 }, /* CB 0x8D: RES 1 L */
+    { &CPU::opcode_CB_8E, 4, 4, 2 }, /* CB 0x8E: RES 1 (HL) */
+    { &CPU::opcode_CB_8F, 2, 2, 2 }, /* CB 0x8F: RES 1 A */
+    { &CPU::opcode_CB_90, 2, 2, 2 }, /* CB 0x90: RES 2 B */
+    { &CPU::opcode_CB_91, 2, 2, 2 }, /* CB 0x91: RES 2 C */
+    { &CPU::opcode_CB_92, 2, 2, 2 }, /* CB 0x92: RES 2 D */
+    { &CPU::opcode_CB_93, 2, 2, 2 }, /* CB 0x93: RES 2 E */
+    { &CPU::opcode_CB_94, 2, 2, 2 }, /* CB 0x94: RES 2 H */
+    { &CPU::opcode_CB_95, 2, 2, 2 }, /* CB 0x95: RES 2 L */
+    { &CPU::opcode_CB_96, 4, 4, 2 }, /* CB 0x96: RES 2 (HL) */
+    { &CPU::opcode_CB_97, 2, 2, 2 }, /* CB 0x97: RES 2 A */
+    { &CPU::opcode_CB_98, 2, 2, 2 }, /* CB 0x98: RES 3 B */
+    { &CPU::opcode_CB_99, 2, 2, 2 }, /* CB 0x99: RES 3 C */
+    { &CPU::opcode_CB_9A, 2, 2, 2 }, /* CB 0x9A: RES 3 D */
+    { &CPU::opcode_CB_9B, 2, 2, 2 }, /* CB 0x9B: RES 3 E */
+    { &CPU::opcode_CB_9C, 2, 2, 2 }, /* CB 0x9C: RES 3 H */
+    { &CPU::opcode_CB_9D, 2, 2, 2 }, /* CB 0x9D: RES 3 L */
+    { &CPU::opcode_CB_9E, 4, 4, 2 }, /* CB 0x9E: RES 3 (HL) */
+    { &CPU::opcode_CB_9F, 2, 2, 2 }, /* CB 0x9F: RES 3 A */
+    { &CPU::opcode_CB_A0, 2, 2, 2 }, /* CB 0xA0: RES 4 B */
+    { &CPU::opcode_CB_A1, 2, 2, 2 }, /* CB 0xA1: RES 4 C */
+    { &CPU::opcode_CB_A2, 2, 2, 2 }, /* CB 0xA2: RES 4 D */
+    { &CPU::opcode_CB_A3, 2, 2, 2 }, /* CB 0xA3: RES 4 E */
+    { &CPU::opcode_CB_A4, 2, 2, 2 }, /* CB 0xA4: RES 4 H */
+    { &CPU::opcode_CB_A5, 2, 2, 2 }, /* CB 0xA5: RES 4 L */
+    { &CPU::opcode_CB_A6, 4, 4, 2 }, /* CB 0xA6: RES 4 (HL) */
+    { &CPU::opcode_CB_A7, 2, 2, 2 }, /* CB 0xA7: RES 4 A */
+    { &CPU::opcode_CB_A8, 2, 2, 2 }, /* CB 0xA8: RES 5 B */
+    { &CPU::opcode_CB_A9, 2, 2, 2 }, /* CB 0xA9: RES 5 C */
+    { &CPU::opcode_CB_AA, 2, 2, 2 }, /* CB 0xAA: RES 5 D */
+    { &CPU::opcode_CB_AB, 2, 2, 2 }, /* CB 0xAB: RES 5 E */
+    { &CPU::opcode_CB_AC, 2, 2, 2 }, /* CB 0xAC: RES 5 H */
+    { &CPU::opcode_CB_AD, 2, 2, 2 }, /* CB 0xAD: RES 5 L */
+    { &CPU::opcode_CB_AE, 4, 4, 2 }, /* CB 0xAE: RES 5 (HL) */
+    { &CPU::opcode_CB_AF, 2, 2, 2 }, /* CB 0xAF: RES 5 A */
+    { &CPU::opcode_CB_B0, 2, 2, 2 }, /* CB 0xB0: RES 6 B */
+    { &CPU::opcode_CB_B1, 2, 2, 2 }, /* CB 0xB1: RES 6 C */
+    { &CPU::opcode_CB_B2, 2, 2, 2 }, /* CB 0xB2: RES 6 D */
+    { &CPU::opcode_CB_B3, 2, 2, 2 }, /* CB 0xB3: RES 6 E */
+    { &CPU::opcode_CB_B4, 2, 2, 2 }, /* CB 0xB4: RES 6 H */
+    { &CPU::opcode_CB_B5, 2, 2, 2 }, /* CB 0xB5: RES 6 L */
+    { &CPU::opcode_CB_B6, 4, 4, 2 }, /* CB 0xB6: RES 6 (HL) */
+    { &CPU::opcode_CB_B7, 2, 2, 2 }, /* CB 0xB7: RES 6 A */
+    { &CPU::opcode_CB_B8, 2, 2, 2 }, /* CB 0xB8: RES 7 B */
+    { &CPU::opcode_CB_B9, 2, 2, 2 }, /* CB 0xB9: RES 7 C */
+    { &CPU::opcode_CB_BA, 2, 2, 2 }, /* CB 0xBA: RES 7 D */
+    { &CPU::opcode_CB_BB, 2, 2, 2 }, /* CB 0xBB: RES 7 E */
+    { &CPU::opcode_CB_BC, 2, 2, 2 }, /* CB 0xBC: RES 7 H */
+    { &CPU::opcode_CB_BD, 2, 2, 2 }, /* CB 0xBD: RES 7 L */
+    { &CPU::opcode_CB_BE, 4, 4, 2 }, /* CB 0xBE: RES 7 (HL) */
+    { &CPU::opcode_CB_BF, 2, 2, 2 }, /* CB 0xBF: RES 7 A */
+    { &CPU::opcode_CB_C0, 2, 2, 2 }, /* CB 0xC0: SET 0 B */
+    { &CPU::opcode_CB_C1, 2, 2, 2 }, /* CB 0xC1: SET 0 C */
+    { &CPU::opcode_CB_C2, 2, 2, 2 }, /* CB 0xC2: SET 0 D */
+    { &CPU::opcode_CB_C3, 2, 2, 2 }, /* CB 0xC3: SET 0 E */
+    { &CPU::opcode_CB_C4, 2, 2, 2 }, /* CB 0xC4: SET 0 H */
+    { &CPU::opcode_CB_C5, 2, 2, 2 }, /* CB 0xC5: SET 0 L */
+    { &CPU::opcode_CB_C6, 4, 4, 2 }, /* CB 0xC6: SET 0 (HL) */
+    { &CPU::opcode_CB_C7, 2, 2, 2 }, /* CB 0xC7: SET 0 A */
+    { &CPU::opcode_CB_C8, 2, 2, 2 }, /* CB 0xC8: SET 1 B */
+    { &CPU::opcode_CB_C9, 2, 2, 2 }, /* CB 0xC9: SET 1 C */
+    { &CPU::opcode_CB_CA, 2, 2, 2 }, /* CB 0xCA: SET 1 D */
+    { &CPU::opcode_CB_CB, 2, 2, 2 }, /* CB 0xCB: SET 1 E */
+    { &CPU::opcode_CB_CC, 2, 2, 2 }, /* CB 0xCC: SET 1 H */
+    { &CPU::opcode_CB_CD, 2, 2, 2 }, /* CB 0xCD: SET 1 L */
+    { &CPU::opcode_CB_CE, 4, 4, 2 }, /* CB 0xCE: SET 1 (HL) */
+    { &CPU::opcode_CB_CF, 2, 2, 2 }, /* CB 0xCF: SET 1 A */
+    { &CPU::opcode_CB_D0, 2, 2, 2 }, /* CB 0xD0: SET 2 B */
+    { &CPU::opcode_CB_D1, 2, 2, 2 }, /* CB 0xD1: SET 2 C */
+    { &CPU::opcode_CB_D2, 2, 2, 2 }, /* CB 0xD2: SET 2 D */
+    { &CPU::opcode_CB_D3, 2, 2, 2 }, /* CB 0xD3: SET 2 E */
+    { &CPU::opcode_CB_D4, 2, 2, 2 }, /* CB 0xD4: SET 2 H */
+    { &CPU::opcode_CB_D5, 2, 2, 2 }, /* CB 0xD5: SET 2 L */
+    { &CPU::opcode_CB_D6, 4, 4, 2 }, /* CB 0xD6: SET 2 (HL) */
+    { &CPU::opcode_CB_D7, 2, 2, 2 }, /* CB 0xD7: SET 2 A */
+    { &CPU::opcode_CB_D8, 2, 2, 2 }, /* CB 0xD8: SET 3 B */
+    { &CPU::opcode_CB_D9, 2, 2, 2 }, /* CB 0xD9: SET 3 C */
+    { &CPU::opcode_CB_DA, 2, 2, 2 }, /* CB 0xDA: SET 3 D */
+    { &CPU::opcode_CB_DB, 2, 2, 2 }, /* CB 0xDB: SET 3 E */
+    { &CPU::opcode_CB_DC, 2, 2, 2 }, /* CB 0xDC: SET 3 H */
+    { &CPU::opcode_CB_DD, 2, 2, 2 }, /* CB 0xDD: SET 3 L */
+    { &CPU::opcode_CB_DE, 4, 4, 2 }, /* CB 0xDE: SET 3 (HL) */
+    { &CPU::opcode_CB_DF, 2, 2, 2 }, /* CB 0xDF: SET 3 A */
+    { &CPU::opcode_CB_E0, 2, 2, 2 }, /* CB 0xE0: SET 4 B */
+    { &CPU::opcode_CB_E1, 2, 2, 2 }, /* CB 0xE1: SET 4 C */
+    { &CPU::opcode_CB_E2, 2, 2, 2 }, /* CB 0xE2: SET 4 D */
+    { &CPU::opcode_CB_E3, 2, 2, 2 }, /* CB 0xE3: SET 4 E */
+    { &CPU::opcode_CB_E4, 2, 2, 2 }, /* CB 0xE4: SET 4 H */
+    { &CPU::opcode_CB_E5, 2, 2, 2 }, /* CB 0xE5: SET 4 L */
+    { &CPU::opcode_CB_E6, 4, 4, 2 }, /* CB 0xE6: SET 4 (HL) */
+    { &CPU::opcode_CB_E7, 2, 2, 2 }, /* CB 0xE7: SET 4 A */
+    { &CPU::opcode_CB_E8, 2, 2, 2 }, /* CB 0xE8: SET 5 B */
+    { &CPU::opcode_CB_E9, 2, 2, 2 }, /* CB 0xE9: SET 5 C */
+    { &CPU::opcode_CB_EA, 2, 2, 2 }, /* CB 0xEA: SET 5 D */
+    { &CPU::opcode_CB_EB, 2, 2, 2 }, /* CB 0xEB: SET 5 E */
+    { &CPU::opcode_CB_EC, 2, 2, 2 }, /* CB 0xEC: SET 5 H */
+    { &CPU::opcode_CB_ED, 2, 2, 2 }, /* CB 0xED: SET 5 L */
+    { &CPU::opcode_CB_EE, 4, 4, 2 }, /* CB 0xEE: SET 5 (HL) */
+    { &CPU::opcode_CB_EF, 2, 2, 2 }, /* CB 0xEF: SET 5 A */
+    { &CPU::opcode_CB_F0, 2, 2, 2 }, /* CB 0xF0: SET 6 B */
+    { &CPU::opcode_CB_F1, 2, 2, 2 }, /* CB 0xF1: SET 6 C */
+    { &CPU::opcode_CB_F2, 2, 2, 2 }, /* CB 0xF2: SET 6 D */
+    { &CPU::opcode_CB_F3, 2, 2, 2 }, /* CB 0xF3: SET 6 E */
+    { &CPU::opcode_CB_F4, 2, 2, 2 }, /* CB 0xF4: SET 6 H */
+    { &CPU::opcode_CB_F5, 2, 2, 2 }, /* CB 0xF5: SET 6 L */
+    { &CPU::opcode_CB_F6, 4, 4, 2 }, /* CB 0xF6: SET 6 (HL) */
+    { &CPU::opcode_CB_F7, 2, 2, 2 }, /* CB 0xF7: SET 6 A */
+    { &CPU::opcode_CB_F8, 2, 2, 2 }, /* CB 0xF8: SET 7 B */
+    { &CPU::opcode_CB_F9, 2, 2, 2 }, /* CB 0xF9: SET 7 C */
+    { &CPU::opcode_CB_FA, 2, 2, 2 }, /* CB 0xFA: SET 7 D */
+    { &CPU::opcode_CB_FB, 2, 2, 2 }, /* CB 0xFB: SET 7 E */
+    { &CPU::opcode_CB_FC, 2, 2, 2 }, /* CB 0xFC: SET 7 H */
+    { &CPU::opcode_CB_FD, 2, 2, 2 }, /* CB 0xFD: SET 7 L */
+    { &CPU::opcode_CB_FE, 4, 4, 2 }, /* CB 0xFE: SET 7 (HL) */
+    { &CPU::opcode_CB_FF, 2, 2, 2 }, /* CB 0xFF: SET 7 A */
+}};
@@ -12,26 +12,30 @@ using bitwise::set_bit;
 
 /* ADC */
 void CPU::_opcode_adc(u8 value) {
-    u8 reg = a.value();
-    u8 carry = f.flag_carry_value();
+    u8 reg = regs.a;
+    u8 carry = flag_carry_value();
 
     uint result_full = reg + value + carry;
     u8 result = static_cast<u8>(result_full);
 
+#if defined(GBEMU_LAZY_FLAGS)
+    defer_flags(FlagOp::Adc, reg, value, result, carry);
+#else
     set_flag_zero(result == 0);
     set_flag_subtract(false);
     set_flag_half_carry(((reg & 0xf) + (value & 0xf) + carry) > 0xf);
     set_flag_carry(result_full > 0xff);
+#endif
 
-    a.set(result);
+    regs.a = result;
 }
 
 void CPU::opcode_adc() {
     _opcode_adc(get_byte_from_pc());
 }
 
-void CPU::opcode_adc(const ByteRegister& reg) {
-    _opcode_adc(reg.value());
+void CPU::opcode_adc(const u8 value) {
+    _opcode_adc(value);
 }
 
 void CPU::opcode_adc(const Address&& addr) {
@@ -43,29 +47,33 @@ void CPU::opcode_adc(const Address&& addr) {
 void CPU::_opcode_add(u8 reg, u8 value) {
     uint result = reg + value;
 
-    a.set(static_cast<u8>(result));
+    regs.a = static_cast<u8>(result);
 
-    set_flag_zero(a.value() == 0);
+#if defined(GBEMU_LAZY_FLAGS)
+    defer_flags(FlagOp::Add, reg, value, regs.a);
+#else
+    set_flag_zero(regs.a == 0);
     set_flag_subtract(false);
     set_flag_half_carry((reg & 0xf) + (value & 0xf) > 0xf);
     set_flag_carry((result & 0x100) != 0);
+#endif
 }
 
 void CPU::opcode_add_a() {
-    _opcode_add(a.value(), get_byte_from_pc());
+    _opcode_add(regs.a, get_byte_from_pc());
 }
 
-void CPU::opcode_add_a(const ByteRegister& reg) {
-    _opcode_add(a.value(), reg.value());
+void CPU::opcode_add_a(const u8 value) {
+    _opcode_add(regs.a, value);
 }
 
 void CPU::opcode_add_a(const Address& addr) {
-    _opcode_add(a.value(), gb.mmu.read(addr));
+    _opcode_add(regs.a, gb.mmu.read(addr));
 }
 
 
 void CPU::_opcode_add_hl(u16 value) {
-    u16 reg = hl.value();
+    u16 reg = regs.hl;
 
     uint result = reg + value;
 
@@ -73,19 +81,15 @@ void CPU::_opcode_add_hl(u16 value) {
     set_flag_half_carry((reg & 0xfff) + (value & 0xfff) > 0xfff);
     set_flag_carry((result & 0x10000) != 0);
 
-    hl.set(static_cast<u16>(result));
+    regs.hl = static_cast<u16>(result);
 }
 
-void CPU::opcode_add_hl(const RegisterPair& reg_pair) {
-    _opcode_add_hl(reg_pair.value());
-}
-
-void CPU::opcode_add_hl(const WordRegister& word_reg) {
-    _opcode_add_hl(word_reg.value());
+void CPU::opcode_add_hl(const u16 value) {
+    _opcode_add_hl(value);
 }
 
 void CPU::opcode_add_sp() {
-    u16 reg = sp.value();
+    u16 reg = regs.sp;
     s8 value = get_signed_byte_from_pc();
 
     int result = static_cast<int>(reg + value);
@@ -95,29 +99,33 @@ void CPU::opcode_add_sp() {
     set_flag_half_carry(((reg ^ value ^ (result & 0xFFFF)) & 0x10) == 0x10);
     set_flag_carry(((reg ^ value ^ (result & 0xFFFF)) & 0x100) == 0x100);
 
-    sp.set(static_cast<u16>(result));
+    regs.sp = static_cast<u16>(result);
 }
 
 
 /* AND */
 void CPU::_opcode_and(u8 value) {
-    u8 reg = a.value();
+    u8 reg = regs.a;
     u8 result = reg & value;
 
-    a.set(result);
+    regs.a = result;
 
-    set_flag_zero(a.value() == 0);
+#if defined(GBEMU_LAZY_FLAGS)
+    defer_flags(FlagOp::And, reg, value, result);
+#else
+    set_flag_zero(regs.a == 0);
     set_flag_half_carry(true);
     set_flag_carry(false);
     set_flag_subtract(false);
+#endif
 }
 
 void CPU::opcode_and() {
     _opcode_and(get_byte_from_pc());
 }
 
-void CPU::opcode_and(ByteRegister& reg) {
-    _opcode_and(reg.value());
+void CPU::opcode_and(const u8 value) {
+    _opcode_and(value);
 }
 
 void CPU::opcode_and(Address&& addr) {
@@ -132,8 +140,8 @@ void CPU::_opcode_bit(const u8 bit, const u8 value) {
     set_flag_half_carry(true);
 }
 
-void CPU::opcode_bit(const u8 bit, ByteRegister& reg) {
-    _opcode_bit(bit, reg.value());
+void CPU::opcode_bit(const u8 bit, const u8 value) {
+    _opcode_bit(bit, value);
 }
 
 void CPU::opcode_bit(const u8 bit, Address&& addr) {
@@ -144,8 +152,8 @@ void CPU::opcode_bit(const u8 bit, Address&& addr) {
 /* CALL */
 void CPU::opcode_call() {
     u16 address = get_word_from_pc();
-    stack_push(pc);
-    pc.set(address);
+    stack_push(regs.pc);
+    regs.pc = address;
 }
 
 void CPU::opcode_call(Condition condition) {
@@ -162,27 +170,31 @@ void CPU::opcode_call(Condition condition) {
 void CPU::opcode_ccf() {
     set_flag_subtract(false);
     set_flag_half_carry(false);
-    set_flag_carry(!f.flag_carry());
+    set_flag_carry(!flag_carry());
 }
 
 
 /* CP */
 void CPU::_opcode_cp(const u8 value) {
-    u8 reg = a.value();
+    u8 reg = regs.a;
     u8 result = static_cast<u8>(reg - value);
 
+#if defined(GBEMU_LAZY_FLAGS)
+    defer_flags(FlagOp::Sub, reg, value, result);
+#else
     set_flag_zero(result == 0);
     set_flag_subtract(true);
     set_flag_half_carry(((reg & 0xf) - (value & 0xf)) < 0);
     set_flag_carry(reg < value);
+#endif
 }
 
 void CPU::opcode_cp() {
     _opcode_cp(get_byte_from_pc());
 }
 
-void CPU::opcode_cp(const ByteRegister& reg) {
-    _opcode_cp(reg.value());
+void CPU::opcode_cp(const u8 value) {
+    _opcode_cp(value);
 }
 
 void CPU::opcode_cp(const Address& addr) {
@@ -192,9 +204,9 @@ void CPU::opcode_cp(const Address& addr) {
 
 /* CPL */
 void CPU::opcode_cpl() {
-    u8 reg = a.value();
+    u8 reg = regs.a;
     u8 result = ~reg;
-    a.set(result);
+    regs.a = result;
 
     set_flag_subtract(true);
     set_flag_half_carry(true);
@@ -203,21 +215,21 @@ void CPU::opcode_cpl() {
 
 /* DAA */
 void CPU::opcode_daa() {
-    u8 reg = a.value();
+    u8 reg = regs.a;
 
-    u16 correction = f.flag_carry()
+    u16 correction = flag_carry()
         ? 0x60
         : 0x00;
 
-    if (f.flag_half_carry() || (!f.flag_subtract() && ((reg & 0x0F) > 9))) {
+    if (flag_half_carry() || (!flag_subtract() && ((reg & 0x0F) > 9))) {
         correction |= 0x06;
     }
 
-    if (f.flag_carry() || (!f.flag_subtract() && (reg > 0x99))) {
+    if (flag_carry() || (!flag_subtract() && (reg > 0x99))) {
         correction |= 0x60;
     }
 
-    if (f.flag_subtract()) {
+    if (flag_subtract()) {
         reg = static_cast<u8>(reg - correction);
     } else {
         reg = static_cast<u8>(reg + correction);
@@ -230,25 +242,25 @@ void CPU::opcode_daa() {
     set_flag_half_carry(false);
     set_flag_zero(reg == 0);
 
-    a.set(static_cast<u8>(reg));
+    regs.a = static_cast<u8>(reg);
 }
 
 
 /* DEC */
-void CPU::opcode_dec(ByteRegister& reg) {
-    reg.decrement();
+void CPU::opcode_dec(u8& reg) {
+    reg--;
 
-    set_flag_zero(reg.value() == 0);
+#if defined(GBEMU_LAZY_FLAGS)
+    defer_flags(FlagOp::Dec, 0, 0, reg, flag_carry_value());
+#else
+    set_flag_zero(reg == 0);
     set_flag_subtract(true);
-    set_flag_half_carry((reg.value() & 0x0F) == 0x0F);
+    set_flag_half_carry((reg & 0x0F) == 0x0F);
+#endif
 }
 
-void CPU::opcode_dec(RegisterPair& reg) {
-    reg.decrement();
-}
-
-void CPU::opcode_dec(WordRegister& reg) {
-    reg.decrement();
+void CPU::opcode_dec(u16& reg) {
+    reg--;
 }
 
 void CPU::opcode_dec(Address&& addr) {
@@ -256,9 +268,13 @@ void CPU::opcode_dec(Address&& addr) {
     u8 result = static_cast<u8>(value - 1);
     gb.mmu.write(addr, result);
 
+#if defined(GBEMU_LAZY_FLAGS)
+    defer_flags(FlagOp::Dec, 0, 0, result, flag_carry_value());
+#else
     set_flag_zero(result == 0);
     set_flag_subtract(true);
     set_flag_half_carry((result & 0x0F) == 0x0F);
+#endif
 }
 
 
@@ -275,20 +291,20 @@ void CPU::opcode_ei() {
 
 
 /* INC */
-void CPU::opcode_inc(ByteRegister& reg) {
-    reg.increment();
+void CPU::opcode_inc(u8& reg) {
+    reg++;
 
-    set_flag_zero(reg.value() == 0);
+#if defined(GBEMU_LAZY_FLAGS)
+    defer_flags(FlagOp::Inc, 0, 0, reg, flag_carry_value());
+#else
+    set_flag_zero(reg == 0);
     set_flag_subtract(false);
-    set_flag_half_carry((reg.value() & 0x0F) == 0x00);
-}
-
-void CPU::opcode_inc(RegisterPair& reg) {
-    reg.increment();
+    set_flag_half_carry((reg & 0x0F) == 0x00);
+#endif
 }
 
-void CPU::opcode_inc(WordRegister& reg) {
-    reg.increment();
+void CPU::opcode_inc(u16& reg) {
+    reg++;
 }
 
 void CPU::opcode_inc(Address&& addr) {
@@ -296,16 +312,20 @@ void CPU::opcode_inc(Address&& addr) {
     u8 result = static_cast<u8>(value + 1);
     gb.mmu.write(addr, result);
 
+#if defined(GBEMU_LAZY_FLAGS)
+    defer_flags(FlagOp::Inc, 0, 0, result, flag_carry_value());
+#else
     set_flag_zero(result == 0);
     set_flag_subtract(false);
     set_flag_half_carry((result & 0x0F) == 0x00);
+#endif
 }
 
 
 /* JP */
 void CPU::opcode_jp() {
     u16 address = get_word_from_pc();
-    pc.set(address);
+    regs.pc = address;
 }
 
 void CPU::opcode_jp(Condition condition) {
@@ -319,7 +339,7 @@ void CPU::opcode_jp(Condition condition) {
 
 void CPU::opcode_jp(const Address& addr) {
     unused(addr);
-    pc.set(hl.value());
+    regs.pc = regs.hl;
 }
 
 
@@ -327,12 +347,12 @@ void CPU::opcode_jp(const Address& addr) {
 void CPU::opcode_jr() {
     s8 offset = get_signed_byte_from_pc();
 
-    if (options.exit_on_infinite_jr && offset == -2) { exit(0); }
+    if (options.exit_on_infinite_jr && offset == -2 && !speculative) { gb.stop(RunResult::InfiniteLoop); }
 
-    u16 old_pc = pc.value();
+    u16 old_pc = regs.pc;
 
     u16 new_pc = static_cast<u16>(old_pc + offset);
-    pc.set(new_pc);
+    regs.pc = new_pc;
 }
 
 void CPU::opcode_jr(Condition condition) {
@@ -352,37 +372,32 @@ void CPU::opcode_halt() {
 
 
 /* LD */
-void CPU::opcode_ld(ByteRegister& reg) {
+void CPU::opcode_ld(u8& reg) {
     u8 n = get_byte_from_pc();
-    reg.set(n);
+    reg = n;
 }
 
-void CPU::opcode_ld(ByteRegister& reg, const ByteRegister& byte_reg) {
-    reg.set(byte_reg.value());
+void CPU::opcode_ld(u8& reg, const u8 value) {
+    reg = value;
 }
 
-void CPU::opcode_ld(ByteRegister& reg, const Address& address) {
-    reg.set(gb.mmu.read(address));
+void CPU::opcode_ld(u8& reg, const Address& address) {
+    reg = gb.mmu.read(address);
 }
 
-void CPU::opcode_ld_from_addr(ByteRegister& reg) {
+void CPU::opcode_ld_from_addr(u8& reg) {
     u16 nn = get_word_from_pc();
-    reg.set(gb.mmu.read(nn));
+    reg = gb.mmu.read(nn);
 }
 
-void CPU::opcode_ld(RegisterPair& reg) {
+void CPU::opcode_ld(u16& reg) {
     u16 nn = get_word_from_pc();
-    reg.set(nn);
+    reg = nn;
 }
 
 
-void CPU::opcode_ld(WordRegister& reg) {
-    u16 nn = get_word_from_pc();
-    reg.set(nn);
-}
-
-void CPU::opcode_ld(WordRegister& reg, const RegisterPair& reg_pair) {
-    reg.set(reg_pair.value());
+void CPU::opcode_ld(u16& reg, const u16 value) {
+    reg = value;
 }
 
 
@@ -391,31 +406,31 @@ void CPU::opcode_ld(const Address& address) {
     gb.mmu.write(address, n);
 }
 
-void CPU::opcode_ld(const Address& address, const ByteRegister& byte_reg) {
-    gb.mmu.write(address, byte_reg.value());
+void CPU::opcode_ld(const Address& address, const u8 value) {
+    gb.mmu.write(address, value);
 }
 
-void CPU::opcode_ld(const Address& address, const WordRegister& word_reg) {
-    gb.mmu.write(address, word_reg.low());
-    gb.mmu.write(address + 1, word_reg.high());
+void CPU::opcode_ld(const Address& address, const u16 value) {
+    gb.mmu.write(address, static_cast<u8>(value));
+    gb.mmu.write(address + 1, static_cast<u8>(value >> 8));
 }
 
 
-void CPU::opcode_ld_to_addr(const ByteRegister &reg) {
+void CPU::opcode_ld_to_addr(const u8 value) {
     u16 address = get_word_from_pc();
-    gb.mmu.write(Address(address), reg.value());
+    gb.mmu.write(Address(address), value);
 }
 
 
 /* LDD */
-void CPU::opcode_ldd(ByteRegister& reg, const Address& address) {
-    reg.set(gb.mmu.read(address));
-    hl.decrement();
+void CPU::opcode_ldd(u8& reg, const Address& address) {
+    reg = gb.mmu.read(address);
+    regs.hl--;
 }
 
-void CPU::opcode_ldd(const Address& address, const ByteRegister& reg) {
-    gb.mmu.write(address, reg.value());
-    hl.decrement();
+void CPU::opcode_ldd(const Address& address, const u8 value) {
+    gb.mmu.write(address, value);
+    regs.hl--;
 }
 
 
@@ -425,33 +440,33 @@ void CPU::opcode_ldh_into_a() {
     auto address = Address(0xFF00 + offset);
 
     u8 value = gb.mmu.read(address);
-    a.set(value);
+    regs.a = value;
 }
 
 void CPU::opcode_ldh_into_data() {
     u8 offset = get_byte_from_pc();
     auto address = Address(0xFF00 + offset);
 
-    gb.mmu.write(address, a.value());
+    gb.mmu.write(address, regs.a);
 }
 
 void CPU::opcode_ldh_into_c() {
-    u8 offset = c.value();
+    u8 offset = regs.c;
     auto address = Address(0xFF00 + offset);
 
-    gb.mmu.write(address, a.value());
+    gb.mmu.write(address, regs.a);
 }
 
 void CPU::opcode_ldh_c_into_a() {
-    auto address = Address(0xFF00 + c.value());
+    auto address = Address(0xFF00 + regs.c);
 
-    a.set(gb.mmu.read(address));
+    regs.a = gb.mmu.read(address);
 }
 
 
 /* LDHL */
 void CPU::opcode_ldhl() {
-    u16 reg = sp.value();
+    u16 reg = regs.sp;
     s8 value = get_signed_byte_from_pc();
 
     int result = static_cast<int>(reg + value);
@@ -461,19 +476,19 @@ void CPU::opcode_ldhl() {
     set_flag_half_carry(((reg ^ value ^ (result & 0xFFFF)) & 0x10) == 0x10);
     set_flag_carry(((reg ^ value ^ (result & 0xFFFF)) & 0x100) == 0x100);
 
-    hl.set(static_cast<u16>(result));
+    regs.hl = static_cast<u16>(result);
 }
 
 
 /* LDI */
-void CPU::opcode_ldi(ByteRegister& reg, const Address& address) {
-    reg.set(gb.mmu.read(address));
-    hl.increment();
+void CPU::opcode_ldi(u8& reg, const Address& address) {
+    reg = gb.mmu.read(address);
+    regs.hl++;
 }
 
-void CPU::opcode_ldi(const Address& address, const ByteRegister& reg) {
-    gb.mmu.write(address, reg.value());
-    hl.increment();
+void CPU::opcode_ldi(const Address& address, const u8 value) {
+    gb.mmu.write(address, value);
+    regs.hl++;
 }
 
 
@@ -485,15 +500,19 @@ void CPU::opcode_nop() {
 
 /* OR */
 void CPU::_opcode_or(u8 value) {
-    u8 reg = a.value();
+    u8 reg = regs.a;
     u8 result = reg | value;
 
-    a.set(result);
+    regs.a = result;
 
-    set_flag_zero(a.value() == 0);
+#if defined(GBEMU_LAZY_FLAGS)
+    defer_flags(FlagOp::Or, reg, value, result);
+#else
+    set_flag_zero(regs.a == 0);
     set_flag_half_carry(false);
     set_flag_carry(false);
     set_flag_subtract(false);
+#endif
 
 }
 
@@ -501,8 +520,8 @@ void CPU::opcode_or() {
     _opcode_or(get_byte_from_pc());
 }
 
-void CPU::opcode_or(const ByteRegister& reg) {
-    _opcode_or(reg.value());
+void CPU::opcode_or(const u8 value) {
+    _opcode_or(value);
 }
 
 void CPU::opcode_or(const Address& addr) {
@@ -511,21 +530,29 @@ void CPU::opcode_or(const Address& addr) {
 
 
 /* POP */
-void CPU::opcode_pop(RegisterPair& reg) {
+void CPU::opcode_pop(u16& reg) {
     stack_pop(reg);
 }
 
+void CPU::opcode_pop_af() {
+    materialize_flags();
+    stack_pop(regs.af);
+
+    /* The lower nibble of F always reads as 0 */
+    regs.f &= 0xF0;
+}
+
 
 /* PUSH */
-void CPU::opcode_push(const RegisterPair& reg) {
-    stack_push(reg);
+void CPU::opcode_push(const u16 value) {
+    stack_push(value);
 }
 
 
 /* RES */
-void CPU::opcode_res(const u8 bit, ByteRegister& reg) {
-    u8 result = clear_bit(reg.value(), bit);
-    reg.set(result);
+void CPU::opcode_res(const u8 bit, u8& reg) {
+    u8 result = clear_bit(reg, bit);
+    reg = result;
 }
 
 void CPU::opcode_res(const u8 bit, Address&& addr) {
@@ -537,7 +564,7 @@ void CPU::opcode_res(const u8 bit, Address&& addr) {
 
 /* RET */
 void CPU::opcode_ret() {
-    stack_pop(pc);
+    stack_pop(regs.pc);
 }
 
 void CPU::opcode_ret(Condition condition) {
@@ -556,7 +583,7 @@ void CPU::opcode_reti() {
 
 /* RL */
 auto CPU::_opcode_rl(u8 value) -> u8 {
-    u8 carry = f.flag_carry_value();
+    u8 carry = flag_carry_value();
 
     bool will_carry = check_bit(value, 7);
     set_flag_carry(will_carry);
@@ -573,13 +600,13 @@ auto CPU::_opcode_rl(u8 value) -> u8 {
 }
 
 void CPU::opcode_rla() {
-    opcode_rl(a);
+    opcode_rl(regs.a);
     set_flag_zero(false);
 }
 
-void CPU::opcode_rl(ByteRegister& reg) {
-    u8 result = _opcode_rl(reg.value());
-    reg.set(result);
+void CPU::opcode_rl(u8& reg) {
+    u8 result = _opcode_rl(reg);
+    reg = result;
 }
 
 void CPU::opcode_rl(Address&& addr) {
@@ -603,13 +630,13 @@ auto CPU::_opcode_rlc(u8 value) -> u8 {
 }
 
 void CPU::opcode_rlca() {
-    opcode_rlc(a);
+    opcode_rlc(regs.a);
     set_flag_zero(false);
 }
 
-void CPU::opcode_rlc(ByteRegister& reg) {
-    u8 result = _opcode_rlc(reg.value());
-    reg.set(result);
+void CPU::opcode_rlc(u8& reg) {
+    u8 result = _opcode_rlc(reg);
+    reg = result;
 }
 
 void CPU::opcode_rlc(Address&& addr) {
@@ -620,7 +647,7 @@ void CPU::opcode_rlc(Address&& addr) {
 
 /* RR */
 auto CPU::_opcode_rr(u8 value) -> u8 {
-    u8 carry = f.flag_carry_value();
+    u8 carry = flag_carry_value();
 
     bool will_carry = check_bit(value, 0);
     set_flag_carry(will_carry);
@@ -636,13 +663,13 @@ auto CPU::_opcode_rr(u8 value) -> u8 {
 }
 
 void CPU::opcode_rra() {
-    opcode_rr(a);
+    opcode_rr(regs.a);
     set_flag_zero(false);
 }
 
-void CPU::opcode_rr(ByteRegister& reg) {
-    u8 result = _opcode_rr(reg.value());
-    reg.set(result);
+void CPU::opcode_rr(u8& reg) {
+    u8 result = _opcode_rr(reg);
+    reg = result;
 }
 
 void CPU::opcode_rr(Address&& addr) {
@@ -666,13 +693,13 @@ auto CPU::_opcode_rrc(u8 value) -> u8 {
 }
 
 void CPU::opcode_rrca() {
-    opcode_rrc(a);
+    opcode_rrc(regs.a);
     set_flag_zero(false);
 }
 
-void CPU::opcode_rrc(ByteRegister& reg) {
-    u8 result = _opcode_rrc(reg.value());
-    reg.set(result);
+void CPU::opcode_rrc(u8& reg) {
+    u8 result = _opcode_rrc(reg);
+    reg = result;
 }
 
 void CPU::opcode_rrc(Address&& addr) {
@@ -683,33 +710,37 @@ void CPU::opcode_rrc(Address&& addr) {
 
 /* RST */
 void CPU::opcode_rst(const u8 offset) {
-    stack_push(pc);
-    pc.set(offset);
+    stack_push(regs.pc);
+    regs.pc = offset;
 }
 
 
 /* SBC */
 void CPU::_opcode_sbc(const u8 value) {
-    u8 carry = f.flag_carry_value();
-    u8 reg = a.value();
+    u8 carry = flag_carry_value();
+    u8 reg = regs.a;
 
     int result_full = reg - value - carry;
     u8 result = static_cast<u8>(result_full);
 
+#if defined(GBEMU_LAZY_FLAGS)
+    defer_flags(FlagOp::Sbc, reg, value, result, carry);
+#else
     set_flag_zero(result == 0);
     set_flag_subtract(true);
     set_flag_carry(result_full < 0);
     set_flag_half_carry(((reg & 0xf) - (value & 0xf) - carry) < 0);
+#endif
 
-    a.set(result);
+    regs.a = result;
 }
 
 void CPU::opcode_sbc() {
     _opcode_sbc(get_byte_from_pc());
 }
 
-void CPU::opcode_sbc(ByteRegister& reg) {
-    _opcode_sbc(reg.value());
+void CPU::opcode_sbc(const u8 value) {
+    _opcode_sbc(value);
 }
 
 void CPU::opcode_sbc(Address&& addr) {
@@ -726,9 +757,9 @@ void CPU::opcode_scf() {
 
 
 /* SET */
-void CPU::opcode_set(const u8 bit, ByteRegister& reg) {
-    u8 result = set_bit(reg.value(), bit);
-    reg.set(result);
+void CPU::opcode_set(const u8 bit, u8& reg) {
+    u8 result = set_bit(reg, bit);
+    reg = result;
 }
 
 void CPU::opcode_set(const u8 bit, Address&& addr) {
@@ -752,9 +783,9 @@ auto CPU::_opcode_sla(u8 value) -> u8 {
     return result;
 }
 
-void CPU::opcode_sla(ByteRegister& reg) {
-    u8 result = _opcode_sla(reg.value());
-    reg.set(result);
+void CPU::opcode_sla(u8& reg) {
+    u8 result = _opcode_sla(reg);
+    reg = result;
 }
 
 void CPU::opcode_sla(Address&& addr) {
@@ -779,9 +810,9 @@ auto CPU::_opcode_sra(u8 value) -> u8 {
     return result;
 }
 
-void CPU::opcode_sra(ByteRegister& reg) {
-    u8 result = _opcode_sra(reg.value());
-    reg.set(result);
+void CPU::opcode_sra(u8& reg) {
+    u8 result = _opcode_sra(reg);
+    reg = result;
 }
 
 void CPU::opcode_sra(Address&& addr) {
@@ -803,9 +834,9 @@ auto CPU::_opcode_srl(u8 value) -> u8 {
     return result;
 }
 
-void CPU::opcode_srl(ByteRegister& reg) {
-    u8 result = _opcode_srl(reg.value());
-    reg.set(result);
+void CPU::opcode_srl(u8& reg) {
+    u8 result = _opcode_srl(reg);
+    reg = result;
 }
 
 void CPU::opcode_srl(Address&& addr) {
@@ -822,23 +853,27 @@ void CPU::opcode_stop() {
 
 /* SUB */
 void CPU::_opcode_sub(u8 value) {
-    u8 reg = a.value();
+    u8 reg = regs.a;
     u8 result = static_cast<u8>(reg - value);
 
-    a.set(result);
+    regs.a = result;
 
-    set_flag_zero(a.value() == 0);
+#if defined(GBEMU_LAZY_FLAGS)
+    defer_flags(FlagOp::Sub, reg, value, result);
+#else
+    set_flag_zero(regs.a == 0);
     set_flag_subtract(true);
     set_flag_half_carry(((reg & 0xf) - (value & 0xf)) < 0);
     set_flag_carry(reg < value);
+#endif
 }
 
 void CPU::opcode_sub() {
     _opcode_sub(get_byte_from_pc());
 }
 
-void CPU::opcode_sub(ByteRegister& reg) {
-    _opcode_sub(reg.value());
+void CPU::opcode_sub(const u8 value) {
+    _opcode_sub(value);
 }
 
 void CPU::opcode_sub(Address&& addr) {
@@ -863,9 +898,9 @@ auto CPU::_opcode_swap(u8 value) -> u8 {
     return result;
 }
 
-void CPU::opcode_swap(ByteRegister& reg) {
-    u8 result = _opcode_swap(reg.value());
-    reg.set(result);
+void CPU::opcode_swap(u8& reg) {
+    u8 result = _opcode_swap(reg);
+    reg = result;
 }
 
 void CPU::opcode_swap(Address&& addr) {
@@ -876,24 +911,28 @@ void CPU::opcode_swap(Address&& addr) {
 
 /* XOR */
 void CPU::_opcode_xor(u8 value) {
-    u8 reg = a.value();
+    u8 reg = regs.a;
 
     u8 result = reg ^ value;
 
+#if defined(GBEMU_LAZY_FLAGS)
+    defer_flags(FlagOp::Xor, reg, value, result);
+#else
     set_flag_zero(result == 0);
     set_flag_subtract(false);
     set_flag_half_carry(false);
     set_flag_carry(false);
+#endif
 
-    a.set(result);
+    regs.a = result;
 }
 
 void CPU::opcode_xor() {
     _opcode_xor(get_byte_from_pc());
 }
 
-void CPU::opcode_xor(const ByteRegister& reg) {
-    _opcode_xor(reg.value());
+void CPU::opcode_xor(const u8 value) {
+    _opcode_xor(value);
 }
 
 void CPU::opcode_xor(const Address& addr) {
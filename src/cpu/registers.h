@@ -0,0 +1,63 @@
+#pragma once
+
+#include "../definitions.h"
+
+/*
+ * The CPU's registers, as plain data.
+ *
+ * Each pair of 8-bit registers shares storage with the 16-bit register pair
+ * it forms, so that e.g. writing `hl` is seen in `h` and `l` without any
+ * composing or splitting. The high register of a pair is the upper byte of
+ * the word, so the order of the bytes depends on the host's endianness.
+ *
+ * Keeping this trivially copyable makes copying the CPU state (for the JIT,
+ * or for snapshots) a plain memory copy.
+ */
+
+/* Anonymous structs inside unions are a (universally supported) extension */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define GBEMU_REGISTER_PAIR(high, low) \
+    union {                            \
+        struct { u8 high, low; };      \
+        u16 high##low;                 \
+    }
+#else
+#define GBEMU_REGISTER_PAIR(high, low) \
+    union {                            \
+        struct { u8 low, high; };      \
+        u16 high##low;                 \
+    }
+#endif
+
+struct RegisterFile {
+    GBEMU_REGISTER_PAIR(a, f);
+    GBEMU_REGISTER_PAIR(b, c);
+    GBEMU_REGISTER_PAIR(d, e);
+    GBEMU_REGISTER_PAIR(h, l);
+
+    u16 sp;
+    u16 pc;
+};
+
+#undef GBEMU_REGISTER_PAIR
+
+#pragma GCC diagnostic pop
+
+/*
+ * Flags set dependant on the result of the last operation, in F
+ *  0x80 - produced 0
+ *  0x40 - was a subtraction
+ *  0x20 - lower half of the byte overflowed 15
+ *  0x10 - overflowed 255 or underflowed 0 for additions/subtractions
+ *
+ * The lower nibble of F is always 0.
+ */
+namespace flags {
+const u8 zero = 0x80;
+const u8 subtract = 0x40;
+const u8 half_carry = 0x20;
+const u8 carry = 0x10;
+} // namespace flags
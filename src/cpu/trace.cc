@@ -0,0 +1,51 @@
+#include "trace.h"
+
+#include "../util/log.h"
+
+#include <chrono>
+
+Tracer::Tracer(const std::string& path) :
+    buffer(std::make_unique<RingBuffer<TraceRecord, 1 << 16>>())
+{
+    file = fopen(path.c_str(), "wb");
+    if (file == nullptr) { return; }
+
+    fwrite(trace_magic, sizeof(trace_magic), 1, file);
+
+    writer = std::thread(&Tracer::write_loop, this);
+    log_info("Writing instruction trace to %s", path.c_str());
+}
+
+Tracer::~Tracer() {
+    if (file == nullptr) { return; }
+
+    stopping = true;
+    writer.join();
+
+    while (write_pending() > 0) {}
+    fclose(file);
+}
+
+void Tracer::record(const TraceRecord& record) {
+    while (!buffer->push(record)) {
+        std::this_thread::yield();
+    }
+}
+
+void Tracer::write_loop() {
+    while (!stopping) {
+        if (write_pending() == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}
+
+auto Tracer::write_pending() -> size_t {
+    const TraceRecord* records = nullptr;
+    size_t count = buffer->peek(records);
+    if (count == 0) { return 0; }
+
+    fwrite(records, sizeof(TraceRecord), count, file);
+    buffer->consume(count);
+    return count;
+}
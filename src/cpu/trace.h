@@ -0,0 +1,66 @@
+#pragma once
+
+#include "../definitions.h"
+#include "../util/ring_buffer.h"
+
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+
+/*
+ * Binary instruction traces, written when the emulator is built with
+ * GBEMU_TRACE and run with --trace.
+ *
+ * A trace file is `trace_magic` followed by one TraceRecord per instruction,
+ * in host byte order. Use gbemu-trace to print it as text.
+ */
+
+const char trace_magic[8] = {'G', 'B', 'T', 'R', 'A', 'C', 'E', '1'};
+
+/* The state before an instruction was executed */
+struct TraceRecord {
+    u64 cycle;
+
+    u16 pc;
+    u16 af;
+    u16 bc;
+    u16 de;
+    u16 hl;
+    u16 sp;
+
+    u8 opcode;
+    bool prefixed; /* A CB-prefixed opcode */
+    u8 padding[2];
+};
+
+static_assert(sizeof(TraceRecord) == 24, "TraceRecord is written to files as-is");
+
+/*
+ * Collects trace records from the emulator thread, and writes them to a file
+ * from a background thread so that tracing never waits on I/O (unless the
+ * writer falls so far behind that the buffer fills up).
+ */
+class Tracer {
+public:
+    Tracer(const std::string& path);
+    ~Tracer();
+
+    /* False if the file couldn't be opened, in which case nothing is written */
+    auto is_open() const -> bool { return file != nullptr; }
+
+    void record(const TraceRecord& record);
+
+private:
+    void write_loop();
+    auto write_pending() -> size_t;
+
+    FILE* file = nullptr;
+
+    /* Large, so allocated separately */
+    std::unique_ptr<RingBuffer<TraceRecord, 1 << 16>> buffer;
+
+    std::atomic<bool> stopping = {false};
+    std::thread writer;
+};
@@ -26,7 +26,7 @@ void Debugger::cycle() {
     steps++;
 
     if (breakpoint_addr != 0 && !debugger_enabled) {
-        if (gameboy.cpu.pc.value() != breakpoint_addr) { return; }
+        if (gameboy.cpu.regs.pc != breakpoint_addr) { return; }
         debugger_enabled = true;
     }
 
@@ -73,7 +73,9 @@ auto Debugger::execute(const Command& command) -> bool {
         case CommandType::MemoryCell: command_memory_cell(command.args); break;
         case CommandType::Steps: command_steps(command.args); break;
         case CommandType::Log: command_log(command.args); break;
-        case CommandType::Exit: command_exit(command.args); break;
+        case CommandType::Exit:
+            command_exit(command.args);
+            return true;
         case CommandType::Help: command_help(command.args); break;
 
         case CommandType::Unknown:
@@ -119,21 +121,23 @@ auto Debugger::command_step(Args args) -> bool {
 void Debugger::command_registers(const Args& args) {
     unused(args);
 
-    printf("AF: %04X\n", gameboy.cpu.af.value());
-    printf("BC: %04X\n", gameboy.cpu.bc.value());
-    printf("DE: %04X\n", gameboy.cpu.de.value());
-    printf("HL: %04X\n", gameboy.cpu.hl.value());
-    printf("SP: %04X\n", gameboy.cpu.sp.value());
-    printf("PC: %04X\n", gameboy.cpu.pc.value());
+    gameboy.cpu.materialize_flags();
+
+    printf("AF: %04X\n", gameboy.cpu.regs.af);
+    printf("BC: %04X\n", gameboy.cpu.regs.bc);
+    printf("DE: %04X\n", gameboy.cpu.regs.de);
+    printf("HL: %04X\n", gameboy.cpu.regs.hl);
+    printf("SP: %04X\n", gameboy.cpu.regs.sp);
+    printf("PC: %04X\n", gameboy.cpu.regs.pc);
 }
 
 void Debugger::command_flags(const Args& args) {
     unused(args);
 
-    printf("Zero: %d\n", gameboy.cpu.f.flag_zero_value());
-    printf("Subtract: %d\n", gameboy.cpu.f.flag_subtract_value());
-    printf("Half Carry: %d\n", gameboy.cpu.f.flag_half_carry_value());
-    printf("Carry: %d\n", gameboy.cpu.f.flag_carry_value());
+    printf("Zero: %d\n", gameboy.cpu.flag_zero());
+    printf("Subtract: %d\n", gameboy.cpu.flag_subtract());
+    printf("Half Carry: %d\n", gameboy.cpu.flag_half_carry());
+    printf("Carry: %d\n", gameboy.cpu.flag_carry());
 }
 
 void Debugger::command_memory(Args args) {
@@ -239,7 +243,9 @@ void Debugger::command_exit(const Args& args) {
     unused(args);
 
     log_error("Exiting");
-    exit(1);
+    debugger_enabled = false;
+    enabled = false;
+    gameboy.stop(RunResult::Closed);
 }
 
 void Debugger::command_help(const Args& args) {
@@ -7,8 +7,10 @@ using uint = unsigned int;
 
 using u8 = uint8_t;
 using u16 = uint16_t;
+using u32 = uint32_t;
+using u64 = uint64_t;
 using s8 = int8_t;
-using s16 = uint16_t;
+using s16 = int16_t;
 
 struct Noncopyable {
     auto operator=(const Noncopyable&) -> Noncopyable& = delete;
@@ -22,6 +24,8 @@ struct Noncopyable {
 template <typename... T> void unused(T&&... unused_vars) {}
 #pragma clang diagnostic pop
 
+/* Ends the process, so only for frontends and tools. The emulator itself
+ * reports errors through Gameboy::fault(), which only stops that instance */
 #define fatal_error(...) \
     log_error("Fatal error @ %s (line %d)", __PRETTY_FUNCTION__, __LINE__); \
     log_error(__VA_ARGS__); \
@@ -32,8 +36,12 @@ const uint GAMEBOY_WIDTH = 160;
 const uint GAMEBOY_HEIGHT = 144;
 const uint BG_MAP_SIZE = 256;
 
+/* The master clock, which everything is timed by (see Scheduler::now()) */
 const int CLOCK_RATE = 4194304;
 
+/* The CPU counts in machine cycles, each of which is four master clocks */
+const uint CLOCKS_PER_CYCLE = 4;
+
 enum class GBColor {
     Color0, /* White */
     Color1, /* Light gray */
@@ -41,7 +49,9 @@ enum class GBColor {
     Color3, /* Black */
 };
 
-enum class Color {
+/* The four shades of the screen. One byte each, as the framebuffer is an
+ * array of these */
+enum class Color : u8 {
     White,
     LightGray,
     DarkGray,
@@ -1,27 +1,112 @@
 #include "gameboy.h"
+#include "save_state.h"
 
-Gameboy::Gameboy(const std::vector<u8>& cartridge_data, Options& options,
+#include "util/string_utils.h"
+
+#include <algorithm>
+#include <cstdarg>
+#include <cstring>
+
+static auto log_level(const Options& options) -> LogLevel {
+    if (options.disable_logs) { return LogLevel::Error; }
+    return options.trace ? LogLevel::Trace : LogLevel::Info;
+}
+
+/* The logger drops trace messages until tracing is turned on, which only
+ * --trace does */
+static auto make_logger(const Options& options) -> Logger {
+    Logger logger(log_level(options));
+    if (options.trace) { logger.enable_tracing(); }
+    return logger;
+}
+
+Gameboy::Gameboy(const std::vector<u8>& cartridge_data, Options& inOptions,
                  const std::vector<u8>& save_data)
-    : cartridge(get_cartridge(cartridge_data, save_data)),
-      cpu(*this, options),
-      video(*this, options),
-      mmu(*this, options),
-      serial(options),
-      debugger(*this, options)
+    : Gameboy(std::make_shared<const std::vector<u8>>(cartridge_data), inOptions, save_data)
 {
-    if (options.disable_logs) log_set_level(LogLevel::Error);
+}
+
+Gameboy::Gameboy(rom_t cartridge_data, Options& inOptions,
+                 const std::vector<u8>& save_data)
+    : logger(make_logger(inOptions)),
+      construction_log_scope(logger),
+      cartridge(load_cartridge(std::move(cartridge_data), save_data)),
+      cpu(*this, inOptions),
+      video(*this, inOptions),
+      mmu(*this, inOptions),
+      apu(*this, inOptions),
+      serial(inOptions),
+      timer(*this),
+      debugger(*this, inOptions),
+      options(inOptions)
+{
+    if (options.rewind_buffer_size > 0) {
+        rewind_buffer = std::make_unique<RewindBuffer>(options.rewind_buffer_size);
+    }
+
+    construction_log_scope.end();
+}
+
+auto Gameboy::load_cartridge(rom_t cartridge_data, const std::vector<u8>& save_data)
+    -> std::shared_ptr<Cartridge> {
+    std::string error;
+    std::shared_ptr<Cartridge> loaded = get_cartridge(std::move(cartridge_data), save_data, error);
+
+    if (!error.empty()) {
+        fault("%s", error.c_str());
+    } else {
+        log_cartridge_info(loaded->get_info());
+    }
+
+    return loaded;
+}
+
+void Gameboy::fault(const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    std::string message = str_format(fmt, args);
+    va_end(args);
+
+    log_error("Emulation fault: %s", message.c_str());
+
+    /* The first fault is the one which matters, as later ones may only be
+     * knock-on effects of it */
+    if (stop_reason != RunResult::Fault) { fault_message = message; }
+
+    stop_reason = RunResult::Fault;
+    stopping = true;
+}
+
+void Gameboy::stop(RunResult result) {
+    if (stop_reason == RunResult::Fault) { return; }
+
+    stop_reason = result;
+    stopping = true;
+}
 
-    log_set_level(options.trace
-        ? LogLevel::Trace
-        : LogLevel::Info
-    );
+auto Gameboy::get_fault() const -> const std::string& {
+    return fault_message;
 }
 
 void Gameboy::button_pressed(GbButton button) {
-    input.button_pressed(button);
+    if (running_ahead) {
+        run_ahead_input.push_back({button, true});
+        return;
+    }
+
+    bool newly_pressed = input.button_pressed(button);
+
+    if (newly_pressed) {
+        cpu.interrupt_flag.set_bit_to(4, true);
+    }
 }
 
 void Gameboy::button_released(GbButton button) {
+    if (running_ahead) {
+        run_ahead_input.push_back({button, false});
+        return;
+    }
+
     input.button_released(button);
 }
 
@@ -37,31 +122,258 @@ void Gameboy::debug_toggle_window() {
     video.debug_disable_window = !video.debug_disable_window;
 }
 
-void Gameboy::run(
+auto Gameboy::run(
     const should_close_callback_t& _should_close_callback,
     const vblank_callback_t& _vblank_callback
-) {
+) -> RunResult {
+    LogScope log_scope(logger);
+
     should_close_callback = _should_close_callback;
 
     video.register_vblank_callback(_vblank_callback);
 
-    while (!should_close_callback()) {
-        tick();
+    /* Only a fault is for good */
+    if (stop_reason != RunResult::Fault) { stopping = false; }
+
+    while (!stopping && !should_close_callback()) {
+        if (options.run_ahead_frames > 0) {
+            run_ahead();
+        } else {
+            tick();
+        }
+
+        if (rewind_buffer) { update_rewind(); }
     }
 
     debugger.set_enabled(false);
+
+    const IdleLoopStats& idle_loop_stats = get_idle_loop_stats();
+    if (idle_loop_stats.loops_skipped > 0) {
+        log_info("Skipped %llu cycles in %llu idle loops",
+                 static_cast<unsigned long long>(idle_loop_stats.cycles_skipped),
+                 static_cast<unsigned long long>(idle_loop_stats.loops_skipped));
+    }
+
+    return stopping ? stop_reason : RunResult::Closed;
 }
 
 void Gameboy::tick() {
-    debugger.cycle();
+    /* Nothing but the CPU needs to run until the next event is due. A fault
+     * stops the instance at the instruction which caused it */
+    while (scheduler.now() < scheduler.next_event_time() && !stopping) {
+#if defined(GBEMU_DISPATCH_THREADED)
+        /* Runs as far as it can, leaving the interrupt or HALT which stopped
+         * it (if it didn't reach the event) to the step below */
+        if (cpu.can_run_threaded()) {
+            cpu.run_threaded();
+            if (scheduler.now() >= scheduler.next_event_time()) { break; }
+        }
+#endif
+
+        debugger.cycle();
+
+        auto cycles = cpu.tick();
+        scheduler.advance(cycles.cycles * CLOCKS_PER_CYCLE);
+
+        /* Only an event (or a button press, which is only seen between calls)
+         * can raise an interrupt, so a halted CPU can skip straight to the
+         * next one instead of idling a cycle at a time */
+        if (cpu.is_halted() && scheduler.now() < scheduler.next_event_time()) {
+            scheduler.advance_to(scheduler.next_event_time());
+        }
+    }
+
+    Event event;
+    u64 deadline;
+    while (scheduler.pop_due(event, deadline)) {
+        handle_event(event, deadline);
+    }
+}
+
+void Gameboy::run_frame() {
+    u64 frame = video.frames();
+    while (video.frames() == frame && !stopping) {
+        tick();
+    }
+}
+
+void Gameboy::run_ahead() {
+    video.set_output_enabled(false);
+    apu.set_output_enabled(true);
+    run_frame();
+    if (stopping) { return; }
 
-    auto cycles = cpu.tick();
-    elapsed_cycles += cycles.cycles;
+    save_state(run_ahead_state);
+    running_ahead = true;
 
-    video.tick(cycles);
-    timer.tick(cycles.cycles);
+    apu.set_output_enabled(false);
+    serial.set_output_enabled(false);
+    cpu.set_speculative(true);
+    for (uint ahead = 1; ahead <= options.run_ahead_frames; ahead++) {
+        video.set_output_enabled(ahead == options.run_ahead_frames);
+        run_frame();
+    }
+
+    load_state(run_ahead_state);
+    running_ahead = false;
+    serial.set_output_enabled(true);
+    cpu.set_speculative(false);
+
+    /* Usually pressed in the vblank callback, i.e. during the frame which
+     * was shown */
+    for (const ButtonChange& change : run_ahead_input) {
+        if (change.pressed) {
+            button_pressed(change.button);
+        } else {
+            button_released(change.button);
+        }
+    }
+    run_ahead_input.clear();
+}
+
+void Gameboy::update_rewind() {
+    u64 frame = video.frames();
+    if (frame == last_rewind_frame) { return; }
+
+    if (rewinding) {
+        if (rewind_buffer->pop(rewind_state)) { load_state(rewind_state); }
+
+        /* The frame has gone back to the snapshot's */
+        last_rewind_frame = video.frames();
+        return;
+    }
+
+    last_rewind_frame = frame;
+
+    if (frame % options.rewind_interval != 0) { return; }
+
+    save_state(rewind_state);
+    rewind_buffer->push(rewind_state);
+}
+
+void Gameboy::set_rewinding(bool is_rewinding) {
+    rewinding = is_rewinding;
+}
+
+void Gameboy::handle_event(const Event event, const u64 deadline) {
+    switch (event) {
+        case Event::VideoMode:
+            video.handle_mode_event();
+            break;
+
+        case Event::Timer:
+            timer.handle_overflow_event();
+            break;
+
+        case Event::FrameSequencer:
+            apu.handle_frame_sequencer_event(deadline);
+            break;
+    }
 }
 
 auto Gameboy::get_cartridge_ram() const -> const std::vector<u8>& {
     return cartridge->get_cartridge_ram();
 }
+
+auto Gameboy::get_audio_output() -> AudioBuffer& {
+    return apu.output();
+}
+
+auto Gameboy::get_idle_loop_stats() const -> const IdleLoopStats& {
+    return cpu.idle_loop_stats();
+}
+
+auto Gameboy::get_frame_count() const -> u64 {
+    return video.frames();
+}
+
+auto Gameboy::get_serial_output() const -> const std::string& {
+    return serial.get_output();
+}
+
+void Gameboy::save_state(std::vector<u8>& out) {
+    LogScope log_scope(logger);
+
+    const std::vector<u8>& cartridge_ram = cartridge->get_cartridge_ram();
+
+    SaveStateHeader header = {};
+    header.magic = SAVE_STATE_MAGIC;
+    header.version = SAVE_STATE_VERSION;
+    header.state_size = sizeof(SaveState);
+    header.cartridge_ram_size = static_cast<u32>(cartridge_ram.size());
+    header.rom_checksum = cartridge->get_info().global_checksum;
+
+    /* Zeroed first so that the padding is too, and the same machine always
+     * saves the same bytes */
+    SaveState state;
+    std::memset(static_cast<void*>(&state), 0, sizeof(SaveState));
+
+    scheduler.save_state(state.scheduler);
+    cpu.save_state(state.cpu);
+    mmu.save_state(state.mmu);
+    cartridge->save_state(state.cartridge);
+    video.save_state(state.video);
+    apu.save_state(state.apu);
+    timer.save_state(state.timer);
+    input.save_state(state.input);
+    serial.save_state(state.serial);
+
+    out.resize(sizeof(SaveStateHeader) + sizeof(SaveState) + cartridge_ram.size());
+    std::memcpy(out.data(), &header, sizeof(SaveStateHeader));
+    std::memcpy(out.data() + sizeof(SaveStateHeader), &state, sizeof(SaveState));
+    std::copy(cartridge_ram.begin(), cartridge_ram.end(), out.begin() + sizeof(SaveStateHeader) + sizeof(SaveState));
+}
+
+auto Gameboy::load_state(const std::vector<u8>& data) -> bool {
+    LogScope log_scope(logger);
+
+    const std::vector<u8>& cartridge_ram = cartridge->get_cartridge_ram();
+
+    if (data.size() < sizeof(SaveStateHeader)) {
+        log_error("Save state is too short to have a header");
+        return false;
+    }
+
+    SaveStateHeader header;
+    std::memcpy(&header, data.data(), sizeof(SaveStateHeader));
+
+    if (header.magic != SAVE_STATE_MAGIC) {
+        log_error("Not a save state");
+        return false;
+    }
+
+    if (header.version != SAVE_STATE_VERSION || header.state_size != sizeof(SaveState)) {
+        log_error("Save state is from an incompatible version");
+        return false;
+    }
+
+    if (header.rom_checksum != cartridge->get_info().global_checksum
+            || header.cartridge_ram_size != cartridge_ram.size()) {
+        log_error("Save state is for a different game");
+        return false;
+    }
+
+    if (data.size() != sizeof(SaveStateHeader) + sizeof(SaveState) + cartridge_ram.size()) {
+        log_error("Save state is the wrong size");
+        return false;
+    }
+
+    SaveState state;
+    std::memcpy(&state, data.data() + sizeof(SaveStateHeader), sizeof(SaveState));
+
+    /* The clock first, as the other components restart from the time it
+     * says, then the memory map before anything which caches it. The CPU
+     * goes last so that it can drop anything it cached from RAM */
+    scheduler.load_state(state.scheduler);
+    cartridge->load_state(state.cartridge);
+    cartridge->load_cartridge_ram(data.data() + sizeof(SaveStateHeader) + sizeof(SaveState));
+    mmu.load_state(state.mmu);
+    video.load_state(state.video);
+    apu.load_state(state.apu);
+    timer.load_state(state.timer);
+    input.load_state(state.input);
+    serial.load_state(state.serial);
+    cpu.load_state(state.cpu);
+
+    return true;
+}
@@ -1,12 +1,15 @@
 #pragma once
 
+#include "audio/apu.h"
 #include "debugger.h"
 #include "input.h"
 #include "cpu/cpu.h"
 #include "video/video.h"
+#include "scheduler.h"
 #include "serial.h"
 #include "timer.h"
 #include "options.h"
+#include "rewind.h"
 #include "util/log.h"
 
 #include <memory>
@@ -14,15 +17,36 @@
 
 using should_close_callback_t = std::function<bool()>;
 
+/* Why Gameboy::run() returned */
+enum class RunResult {
+    /* The should-close callback asked it to, or the debugger did */
+    Closed,
+
+    /* The game reached an infinite JR, with Options::exit_on_infinite_jr */
+    InfiniteLoop,
+
+    /* Emulation went wrong (see Gameboy::get_fault()), and won't go on */
+    Fault,
+};
+
 class Gameboy {
 public:
     Gameboy(const std::vector<u8>& cartridge_data, Options& options,
             const std::vector<u8>& save_data = {});
 
-    void run(
+    /* For running several instances of a game without a copy of the ROM each */
+    Gameboy(rom_t cartridge_data, Options& options,
+            const std::vector<u8>& save_data = {});
+
+    auto run(
         const should_close_callback_t& _should_close_callback,
         const vblank_callback_t& _vblank_callback
-    );
+    ) -> RunResult;
+
+    /* What went wrong, once run() has returned RunResult::Fault. Faults can
+     * also come from loading the game, in which case run() returns straight
+     * away */
+    auto get_fault() const -> const std::string&;
 
     void button_pressed(GbButton button);
     void button_released(GbButton button);
@@ -33,11 +57,67 @@ public:
 
     auto get_cartridge_ram() const -> const std::vector<u8>&;
 
+    /* Samples for the frontend to play, which it may take from another thread */
+    auto get_audio_output() -> AudioBuffer&;
+
+    auto get_idle_loop_stats() const -> const IdleLoopStats&;
+
+    /* Frames the PPU has finished, whether or not they were drawn */
+    auto get_frame_count() const -> u64;
+
+    /* Everything sent over the serial port, with Options::capture_serial */
+    auto get_serial_output() const -> const std::string&;
+
+    /* Writes the whole machine's state into `out`, replacing its contents
+     * (see save_state.h). Reusing the same vector avoids reallocating it */
+    void save_state(std::vector<u8>& out);
+
+    /* Returns false, leaving the machine as it was, if the state is from a
+     * different game or an incompatible build */
+    auto load_state(const std::vector<u8>& data) -> bool;
+
+    /* While rewinding, each frame goes back to the snapshot before it
+     * instead of taking a new one (see Options::rewind_buffer_size) */
+    void set_rewinding(bool is_rewinding);
+
 private:
+    /* Stops emulation for good after the current instruction, instead of
+     * ending the process, so that one broken game can't take down others
+     * running alongside it */
+    void fault(const char* fmt, ...);
+
+    /* Makes run() return after the current instruction */
+    void stop(RunResult result);
+
+    auto load_cartridge(rom_t cartridge_data, const std::vector<u8>& save_data)
+        -> std::shared_ptr<Cartridge>;
+
     void tick();
+    void handle_event(Event event, u64 deadline);
+
+    /* Takes or restores a snapshot if a frame has finished */
+    void update_rewind();
+
+    /* Runs until the PPU finishes the current frame */
+    void run_frame();
+
+    /* Runs a frame which is heard but not seen, then the frames after it
+     * which are seen but not heard, and then goes back */
+    void run_ahead();
+
+    /* Everything this instance logs goes here rather than to a logger shared
+     * with other instances, including while it is being constructed */
+    Logger logger;
+    LogScope construction_log_scope;
+
+    bool stopping = false;
+    RunResult stop_reason = RunResult::Closed;
+    std::string fault_message;
 
     std::shared_ptr<Cartridge> cartridge;
 
+    Scheduler scheduler;
+
     CPU cpu;
     friend class CPU;
 
@@ -47,14 +127,34 @@ private:
     MMU mmu;
     friend class MMU;
 
+    APU apu;
+    friend class APU;
+
     Input input;
     Serial serial;
     Timer timer;
+    friend class Timer;
 
     Debugger debugger;
     friend class Debugger;
 
-    uint elapsed_cycles = 0;
-
     should_close_callback_t should_close_callback;
+
+    Options& options;
+
+    std::unique_ptr<RewindBuffer> rewind_buffer;
+    bool rewinding = false;
+    u64 last_rewind_frame = 0;
+    std::vector<u8> rewind_state;
+
+    /* Buttons which changed while running ahead, to apply once the real
+     * state is back */
+    struct ButtonChange {
+        GbButton button;
+        bool pressed;
+    };
+
+    bool running_ahead = false;
+    std::vector<u8> run_ahead_state;
+    std::vector<ButtonChange> run_ahead_input;
 };
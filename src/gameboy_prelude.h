@@ -1,5 +1,7 @@
 #include "gameboy.h"
+#include "audio/headless_sink.h"
 #include "input.h"
 #include "cartridge/cartridge.h"
+#include "video/pixel_format.h"
 #include "util/log.h"
 #include "util/files.h"
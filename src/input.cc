@@ -2,14 +2,31 @@
 
 #include "util/bitwise.h"
 
-void Input::button_pressed(GbButton button) {
+auto Input::button_pressed(GbButton button) -> bool {
+    bool was_pressed = is_pressed(button);
     set_button(button, true);
+    return !was_pressed;
 }
 
 void Input::button_released(GbButton button) {
     set_button(button, false);
 }
 
+auto Input::is_pressed(GbButton button) const -> bool {
+    switch (button) {
+        case GbButton::Up: return up;
+        case GbButton::Down: return down;
+        case GbButton::Left: return left;
+        case GbButton::Right: return right;
+        case GbButton::A: return a;
+        case GbButton::B: return b;
+        case GbButton::Select: return select;
+        case GbButton::Start: return start;
+    }
+
+    return false;
+}
+
 void Input::set_button(GbButton button, bool set) {
     if (button == GbButton::Up) { up = set; }
     if (button == GbButton::Down) { down = set; }
@@ -52,3 +69,21 @@ auto Input::get_input() const -> u8 {
 
     return buttons;
 }
+
+void Input::save_state(InputState& state) const {
+    state = {up, down, left, right, a, b, select, start, button_switch, direction_switch};
+}
+
+void Input::load_state(const InputState& state) {
+    up = state.up;
+    down = state.down;
+    left = state.left;
+    right = state.right;
+    a = state.a;
+    b = state.b;
+    select = state.select;
+    start = state.start;
+
+    button_switch = state.button_switch;
+    direction_switch = state.direction_switch;
+}
@@ -13,15 +13,35 @@ enum class GbButton {
     Start,
 };
 
+/* Everything needed to restore the joypad (see save_state.h) */
+struct InputState {
+    bool up;
+    bool down;
+    bool left;
+    bool right;
+    bool a;
+    bool b;
+    bool select;
+    bool start;
+
+    bool button_switch;
+    bool direction_switch;
+};
+
 class Input {
 public:
-    void button_pressed(GbButton button);
+    /* Returns whether the button wasn't already held */
+    auto button_pressed(GbButton button) -> bool;
     void button_released(GbButton button);
     void write(u8 set);
 
     auto get_input() const -> u8;
 
+    void save_state(InputState& state) const;
+    void load_state(const InputState& state);
+
 private:
+    auto is_pressed(GbButton button) const -> bool;
     void set_button(GbButton button, bool set);
 
     bool up = false;
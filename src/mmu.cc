@@ -9,16 +9,103 @@
 #include "cpu/cpu.h"
 #include "video/video.h"
 
+#include <algorithm>
+
 MMU::MMU(Gameboy& inGb, Options& inOptions) :
     gb(inGb),
     options(inOptions)
 {
     work_ram = std::vector<u8>(0x8000);
-    oam_ram = std::vector<u8>(0xA0);
     high_ram = std::vector<u8>(0x80);
+
+    map_memory();
+}
+
+void MMU::map_memory() {
+    read_pages.fill(nullptr);
+    write_pages.fill(nullptr);
+
+    map_cartridge();
+
+    /* VRAM: writes go through the slow path so that the PPU sees them */
+    for (uint page = 0x80; page <= 0x9F; page++) {
+        read_pages[page] = gb.video.video_ram_data() + ((page - 0x80) << 8);
+    }
+
+    /* Internal work RAM, and its mirror. Writes to the mirror go through the slow
+     * path so that they are still reported */
+    for (uint page = 0xC0; page <= 0xDF; page++) {
+        read_pages[page] = &work_ram[(page - 0xC0) << 8];
+        if (!code_pages[page]) { write_pages[page] = &work_ram[(page - 0xC0) << 8]; }
+    }
+
+    for (uint page = 0xE0; page <= 0xFD; page++) {
+        read_pages[page] = &work_ram[(page - 0xE0) << 8];
+    }
+
+    /* OAM, IO, high RAM and the interrupt enable register share pages with
+     * memory which has side effects, so they always use the slow path */
+}
+
+void MMU::map_cartridge() {
+    for (uint page = 0x00; page <= 0x7F; page++) {
+        read_pages[page] = gb.cartridge->map_read(static_cast<u16>(page << 8));
+    }
+
+    for (uint page = 0xA0; page <= 0xBF; page++) {
+        read_pages[page] = gb.cartridge->map_read(static_cast<u16>(page << 8));
+        write_pages[page] = gb.cartridge->map_write(static_cast<u16>(page << 8));
+    }
+
+    if (boot_rom_active()) {
+        read_pages[0x00] = bootDMG.data();
+    }
+
+    gb.cpu.block_cache.mapping_changed();
+}
+
+void MMU::save_state(MMUState& state) const {
+    std::copy(work_ram.begin(), work_ram.begin() + state.work_ram.size(), state.work_ram.begin());
+    std::copy(high_ram.begin(), high_ram.end(), state.high_ram.begin());
+    state.disable_boot_rom_switch = disable_boot_rom_switch.value();
+}
+
+void MMU::load_state(const MMUState& state) {
+    std::copy(state.work_ram.begin(), state.work_ram.end(), work_ram.begin());
+    std::copy(state.high_ram.begin(), state.high_ram.end(), high_ram.begin());
+    disable_boot_rom_switch.set(state.disable_boot_rom_switch);
+
+    /* The cartridge may be on a different bank, and the boot ROM may have
+     * been mapped or unmapped */
+    map_memory();
 }
 
-auto MMU::read(const Address& address) const -> u8 {
+auto MMU::code_pointer(const u16 address) const -> const u8* {
+    if (address <= 0x7FFF) {
+        const u8* page = read_pages[address >> 8];
+        return page ? page + (address & 0xFF) : nullptr;
+    }
+
+    if (address >= 0xC000 && address <= 0xDFFF) { return &work_ram[address - 0xC000]; }
+    if (address >= 0xFF80 && address <= 0xFFFE) { return &high_ram[address - 0xFF80]; }
+
+    return nullptr;
+}
+
+void MMU::protect_code_page(const u8 page) {
+    code_pages[page] = true;
+    write_pages[page] = nullptr;
+}
+
+void MMU::unprotect_code_page(const u8 page) {
+    code_pages[page] = false;
+
+    if (page >= 0xC0 && page <= 0xDF) {
+        write_pages[page] = &work_ram[(page - 0xC0) << 8];
+    }
+}
+
+auto MMU::read_slow(const Address& address) const -> u8 {
     if (address.in_range(0x0, 0x7FFF)) {
         if (address.in_range(0x0, 0xFF) && boot_rom_active()) {
             return bootDMG[address.value()];
@@ -43,12 +130,12 @@ auto MMU::read(const Address& address) const -> u8 {
 
     if (address.in_range(0xE000, 0xFDFF)) {
         /* log_warn("Attempting to read from mirrored work RAM"); */
-        return read(address.value() - 0x2000);
+        return read_slow(address.value() - 0x2000);
     }
 
     /* OAM */
     if (address.in_range(0xFE00, 0xFE9F)) {
-        return oam_ram.at(address.value() - 0xFE00);
+        return gb.video.read_oam(address.value() - 0xFE00);
     }
 
     if (address.in_range(0xFEA0, 0xFEFF)) {
@@ -71,7 +158,8 @@ auto MMU::read(const Address& address) const -> u8 {
         return gb.cpu.interrupt_enabled.value();
     }
 
-    fatal_error("Attempted to read from unmapped memory address 0x%X", address.value());
+    gb.fault("Attempted to read from unmapped memory address 0x%X", address.value());
+    return 0xFF;
 }
 
 auto MMU::read_io(const Address& address) const -> u8 {
@@ -113,51 +201,53 @@ auto MMU::read_io(const Address& address) const -> u8 {
         case 0xFF0F:
             return gb.cpu.interrupt_flag.value();
 
-        /* TODO: Audio - Channel 1: Tone & Sweep */
+        /* Audio - Channel 1: Tone & Sweep */
         case 0xFF10:
         case 0xFF11:
         case 0xFF12:
         case 0xFF13:
         case 0xFF14:
-            return 0xFF;
+            return gb.apu.read(address.value());
 
         case 0xFF15:
             return unmapped_io_read(address);
 
-        /* TODO: Audio - Channel 2: Tone */
+        /* Audio - Channel 2: Tone */
         case 0xFF16:
         case 0xFF17:
         case 0xFF18:
         case 0xFF19:
-            return 0xFF;
+            return gb.apu.read(address.value());
 
-        /* TODO: Audio - Channel 3: Wave Output */
+        /* Audio - Channel 3: Wave Output */
         case 0xFF1A:
         case 0xFF1B:
         case 0xFF1C:
         case 0xFF1D:
         case 0xFF1E:
+            return gb.apu.read(address.value());
+
         case 0xFF1F:
-            return 0xFF;
+            return unmapped_io_read(address);
 
-        /* TODO: Audio - Channel 4: Noise */
+        /* Audio - Channel 4: Noise */
         case 0xFF20:
         case 0xFF21:
         case 0xFF22:
         case 0xFF23:
-            return 0xFF;
+            return gb.apu.read(address.value());
 
-        /* TODO: Audio - Channel control/ON-OFF/Volume */
+        /* Audio - Channel control/ON-OFF/Volume */
         case 0xFF24:
-            return 0xFF;
+            return gb.apu.read(address.value());
 
-        /* TODO: Audio - Selection of sound output terminal */
+        /* Audio - Selection of sound output terminal */
         case 0xFF25:
-            return 0xFF;
+            return gb.apu.read(address.value());
 
-        /* TODO: Audio - Sound on/off */
+        /* Audio - Sound on/off */
         case 0xFF26:
-            return 0xFF;
+            return gb.apu.read(address.value());
 
         case 0xFF27:
         case 0xFF28:
@@ -170,7 +260,7 @@ auto MMU::read_io(const Address& address) const -> u8 {
         case 0xFF2F:
             return unmapped_io_read(address);
 
-        /* TODO: Audio - Wave pattern RAM */
+        /* Audio - Wave pattern RAM */
         case 0xFF30:
         case 0xFF31:
         case 0xFF32:
@@ -187,12 +277,13 @@ auto MMU::read_io(const Address& address) const -> u8 {
         case 0xFF3D:
         case 0xFF3E:
         case 0xFF3F:
-            return 0xFF;
+            return gb.apu.read(address.value());
 
         case 0xFF40:
             return gb.video.control_byte;
 
         case 0xFF41:
+            gb.video.catch_up();
             return gb.video.lcd_status.value();
 
         case 0xFF42:
@@ -202,6 +293,7 @@ auto MMU::read_io(const Address& address) const -> u8 {
             return gb.video.scroll_x.value();
 
         case 0xFF44:
+            gb.video.catch_up();
             return gb.video.line.value();
 
         case 0xFF45:
@@ -339,7 +431,8 @@ auto MMU::read_io(const Address& address) const -> u8 {
             return unmapped_io_read(address);
 
         default:
-            fatal_error("Unmapped IO address: 0x%x", address.value());
+            gb.fault("Unmapped IO address: 0x%x", address.value());
+            return 0xFF;
     }
 }
 
@@ -348,9 +441,10 @@ auto MMU::unmapped_io_read(const Address& address) const -> u8 {
     return 0xFF;
 }
 
-void MMU::write(const Address& address, const u8 byte) {
+void MMU::write_slow(const Address& address, const u8 byte) {
     if (address.in_range(0x0000, 0x7FFF)) {
         gb.cartridge->write(address, byte);
+        map_cartridge();
         return;
     }
 
@@ -369,19 +463,20 @@ void MMU::write(const Address& address, const u8 byte) {
     /* Internal work RAM */
     if (address.in_range(0xC000, 0xDFFF)) {
         work_ram.at(address.value() - 0xC000) = byte;
+        if (code_pages[address.value() >> 8]) { gb.cpu.block_cache.invalidate(address.value()); }
         return;
     }
 
     /* Mirrored RAM */
     if (address.in_range(0xE000, 0xFDFF)) {
         log_warn("Attempting to write to mirrored work RAM");
-        write(address.value() - 0x2000, byte);
+        write_slow(address.value() - 0x2000, byte);
         return;
     }
 
     /* OAM */
     if (address.in_range(0xFE00, 0xFE9F)) {
-        oam_ram.at(address.value() - 0xFE00) = byte;
+        gb.video.write_oam(address.value() - 0xFE00, byte);
         return;
     }
 
@@ -399,6 +494,7 @@ void MMU::write(const Address& address, const u8 byte) {
     /* Zero Page ram */
     if (address.in_range(0xFF80, 0xFFFE)) {
         high_ram.at(address.value() - 0xFF80) = byte;
+        if (code_pages[0xFF]) { gb.cpu.block_cache.invalidate(address.value()); }
         return;
     }
 
@@ -408,10 +504,13 @@ void MMU::write(const Address& address, const u8 byte) {
         return;
     }
 
-    fatal_error("Attempted to write to unmapped memory address 0x%X", address.value());
+    gb.fault("Attempted to write to unmapped memory address 0x%X", address.value());
 }
 
 void MMU::write_io(const Address& address, const u8 byte) {
+    /* Lines the PPU hasn't caught up with yet were drawn with the old values */
+    if (address.in_range(0xFF40, 0xFF4B)) { gb.video.catch_up(); }
+
     switch (address.value()) {
         case 0xFF00:
             gb.input.write(byte);
@@ -435,8 +534,7 @@ void MMU::write_io(const Address& address, const u8 byte) {
             return;
 
         case 0xFF05:
-            /* TODO: Time control */
-            log_unimplemented("Wrote to timer counter");
+            gb.timer.set_timer(byte);
             return;
 
         case 0xFF06:
@@ -460,53 +558,59 @@ void MMU::write_io(const Address& address, const u8 byte) {
             gb.cpu.interrupt_flag.set(byte);
             return;
 
-        /* TODO: Audio - Channel 1: Tone & Sweep */
+        /* Audio - Channel 1: Tone & Sweep */
         case 0xFF10:
         case 0xFF11:
         case 0xFF12:
         case 0xFF13:
         case 0xFF14:
+            gb.apu.write(address.value(), byte);
             return;
 
         case 0xFF15:
             return unmapped_io_write(address, byte);
 
-        /* TODO: Audio - Channel 2: Tone */
+        /* Audio - Channel 2: Tone */
         case 0xFF16:
         case 0xFF17:
         case 0xFF18:
         case 0xFF19:
+            gb.apu.write(address.value(), byte);
             return;
 
-        /* TODO: Audio - Channel 3: Wave Output */
+        /* Audio - Channel 3: Wave Output */
         case 0xFF1A:
         case 0xFF1B:
         case 0xFF1C:
         case 0xFF1D:
         case 0xFF1E:
+            gb.apu.write(address.value(), byte);
             return;
 
         case 0xFF1F:
             return unmapped_io_write(address, byte);
 
-        /* TODO: Audio - Channel 4: Noise */
+        /* Audio - Channel 4: Noise */
         case 0xFF20:
         case 0xFF21:
         case 0xFF22:
         case 0xFF23:
+            gb.apu.write(address.value(), byte);
             return;
 
-        /* TODO: Audio - Channel control/ON-OFF/Volume */
+        /* Audio - Channel control/ON-OFF/Volume */
         case 0xFF24:
+            gb.apu.write(address.value(), byte);
             return;
 
-        /* TODO: Audio - Selection of sound output terminal */
+        /* Audio - Selection of sound output terminal */
         case 0xFF25:
+            gb.apu.write(address.value(), byte);
             return;
 
-        /* TODO: Audio - Sound on/off */
+        /* Audio - Sound on/off */
         case 0xFF26:
-            log_unimplemented("Wrote to sound on/off address 0x%x - 0x%x", address.value(), byte);
+            gb.apu.write(address.value(), byte);
             return;
 
         case 0xFF27:
@@ -520,7 +624,7 @@ void MMU::write_io(const Address& address, const u8 byte) {
         case 0xFF2F:
             return unmapped_io_write(address, byte);
 
-        /* TODO: Audio - Wave pattern RAM */
+        /* Audio - Wave pattern RAM */
         case 0xFF30:
         case 0xFF31:
         case 0xFF32:
@@ -537,6 +641,7 @@ void MMU::write_io(const Address& address, const u8 byte) {
         case 0xFF3D:
         case 0xFF3E:
         case 0xFF3F:
+            gb.apu.write(address.value(), byte);
             return;
 
         /* Switch on LCD */
@@ -546,6 +651,7 @@ void MMU::write_io(const Address& address, const u8 byte) {
 
         case 0xFF41:
             gb.video.lcd_status.set(byte);
+            gb.video.reschedule();
             return;
 
         /* Vertical Scroll Register */
@@ -562,10 +668,12 @@ void MMU::write_io(const Address& address, const u8 byte) {
         case 0xFF44:
             /* "Writing will reset the counter */
             gb.video.line.set(0x0);
+            gb.video.reschedule();
             return;
 
         case 0xFF45:
             gb.video.ly_compare.set(byte);
+            gb.video.reschedule();
             return;
 
         case 0xFF46:
@@ -610,7 +718,7 @@ void MMU::write_io(const Address& address, const u8 byte) {
         /* Disable boot rom switch */
         case 0xFF50:
             disable_boot_rom_switch.set(byte);
-            global_logger.enable_tracing();
+            map_cartridge();
             log_debug("Boot rom was disabled");
             return;
 
@@ -711,7 +819,8 @@ void MMU::write_io(const Address& address, const u8 byte) {
             return unmapped_io_write(address, byte);
 
         default:
-            fatal_error("Unmapped IO address: 0x%x", address.value());
+            gb.fault("Unmapped IO address: 0x%x", address.value());
+            return;
     }
 }
 
@@ -719,7 +828,7 @@ void MMU::unmapped_io_write(const Address& address, const u8 byte) {
     log_warn("Attempting to write to unused IO address 0x%x - 0x%x", address.value(), byte);
 }
 
-auto MMU::boot_rom_active() const -> bool { return read(0xFF50) != 0x1; }
+auto MMU::boot_rom_active() const -> bool { return disable_boot_rom_switch.value() != 0x1; }
 
 void MMU::dma_transfer(const u8 byte) {
     Address start_address = byte * 0x100;
@@ -4,11 +4,19 @@
 #include "options.h"
 #include "cartridge/cartridge.h"
 
+#include <array>
 #include <vector>
 #include <memory>
 
 class Gameboy;
 
+/* The memory the MMU owns itself, for save states (see save_state.h) */
+struct MMUState {
+    std::array<u8, 0x2000> work_ram;
+    std::array<u8, 0x80> high_ram;
+    u8 disable_boot_rom_switch;
+};
+
 class MMU {
 public:
     MMU(Gameboy& inGb, Options& options);
@@ -16,9 +24,27 @@ public:
     auto read(const Address& address) const -> u8;
     void write(const Address& address, u8 byte);
 
+    /* Host memory backing code at the given address, or null if code there
+     * can't be cached (see BlockCache) */
+    auto code_pointer(u16 address) const -> const u8*;
+
+    void protect_code_page(u8 page);
+    void unprotect_code_page(u8 page);
+
+    void save_state(MMUState& state) const;
+    void load_state(const MMUState& state);
+
 private:
     auto boot_rom_active() const -> bool;
 
+    /* Rebuild the page tables. These only need to change when the boot ROM is
+     * unmapped or the cartridge switches banks */
+    void map_memory();
+    void map_cartridge();
+
+    auto read_slow(const Address& address) const -> u8;
+    void write_slow(const Address& address, u8 byte);
+
     auto read_io(const Address& address) const -> u8;
     void write_io(const Address& address, u8 byte);
 
@@ -31,10 +57,41 @@ private:
     Options& options;
 
     std::vector<u8> work_ram;
-    std::vector<u8> oam_ram;
     std::vector<u8> high_ram;
 
     ByteRegister disable_boot_rom_switch;
 
+    /* Each 256-byte page of the address space either points directly at the
+     * host memory backing it, or is null if accesses to it have side effects
+     * and need to go through the slow path */
+    std::array<const u8*, 0x100> read_pages = {};
+    std::array<u8*, 0x100> write_pages = {};
+
+    /* Pages of RAM containing cached code. Writes to these always use the slow
+     * path so that the block cache can be invalidated */
+    std::array<bool, 0x100> code_pages = {};
+
     friend class Debugger;
+    friend class JIT;
 };
+
+inline auto MMU::read(const Address& address) const -> u8 {
+    u16 addr = address.value();
+
+    if (const u8* page = read_pages[addr >> 8]) {
+        return page[addr & 0xFF];
+    }
+
+    return read_slow(address);
+}
+
+inline void MMU::write(const Address& address, const u8 byte) {
+    u16 addr = address.value();
+
+    if (u8* page = write_pages[addr >> 8]) {
+        page[addr & 0xFF] = byte;
+        return;
+    }
+
+    write_slow(address, byte);
+}
@@ -1,5 +1,15 @@
 #pragma once
 
+#include "definitions.h"
+
+#include <string>
+
+enum class CPUEngine {
+    Interpreter,
+    CachedInterpreter,
+    JIT,
+};
+
 struct Options {
     bool debugger = false;
     bool trace = false;
@@ -8,4 +18,42 @@ struct Options {
     bool show_full_framebuffer = false;
     bool exit_on_infinite_jr = false;
     bool print_serial = false;
+
+    /* Keep everything sent over the serial port, for
+     * Gameboy::get_serial_output() */
+    bool capture_serial = false;
+    CPUEngine cpu_engine = CPUEngine::Interpreter;
+    bool jit_validate = false;
+    bool skip_idle_loops = false;
+
+    /* Only draw one frame in every `frame_skip`. Skipped frames still run
+     * with exact timing, but produce no pixels and no vblank callback */
+    uint frame_skip = 1;
+
+    /* Skip every frame, keeping only the PPU's timing and interrupts */
+    bool disable_rendering = false;
+
+    /* Keep the APU's registers and timing, but don't synthesise any audio */
+    bool disable_audio = false;
+
+    /* Where gbemu-test writes the audio it would have played, as a WAV file */
+    std::string audio_dump_path;
+
+    /* Draw lines on a separate thread from emulation */
+    bool render_thread = false;
+
+    /* Memory to keep snapshots in for rewinding, in bytes. Zero disables
+     * rewinding */
+    size_t rewind_buffer_size = 0;
+
+    /* Frames between rewind snapshots */
+    uint rewind_interval = 2;
+
+    /* Show the frame this many frames ahead of the one which really
+     * happens, rolling back after each, so that the game responds to input
+     * sooner. Zero disables run-ahead */
+    uint run_ahead_frames = 0;
+
+    /* Where --trace writes instructions, in builds with GBEMU_TRACE */
+    std::string trace_path = "gbemu.trace";
 };
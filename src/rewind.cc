@@ -0,0 +1,218 @@
+#include "rewind.h"
+
+#include "util/log.h"
+
+#include <algorithm>
+#include <cstring>
+
+/* Zero runs shorter than this are cheaper to leave in a literal run */
+static const size_t MIN_ZERO_RUN = 3;
+
+/* What keyframes are encoded against */
+static const std::vector<u8> no_reference;
+
+static void write_length(std::vector<u8>& out, size_t length) {
+    while (length >= 0x80) {
+        out.push_back(static_cast<u8>(length | 0x80));
+        length >>= 7;
+    }
+
+    out.push_back(static_cast<u8>(length));
+}
+
+static auto read_length(const u8*& in) -> size_t {
+    size_t length = 0;
+    uint shift = 0;
+
+    while (*in & 0x80) {
+        length |= static_cast<size_t>(*in++ & 0x7F) << shift;
+        shift += 7;
+    }
+
+    return length | (static_cast<size_t>(*in++) << shift);
+}
+
+RewindBuffer::RewindBuffer(size_t capacity) :
+    storage(capacity)
+{
+}
+
+void RewindBuffer::push(const std::vector<u8>& state) {
+    bool is_keyframe = records.empty()
+        || keyframe.size() != state.size()
+        || deltas_since_keyframe + 1 >= REWIND_KEYFRAME_INTERVAL;
+
+    encode(state, is_keyframe ? no_reference : keyframe);
+
+    if (!store(is_keyframe)) { return; }
+
+    /* Making room dropped the keyframe this delta needs */
+    if (!is_keyframe && records.size() == 1) {
+        records.clear();
+        write_offset = 0;
+
+        encode(state, no_reference);
+        is_keyframe = true;
+        if (!store(is_keyframe)) { return; }
+    }
+
+    if (is_keyframe) {
+        keyframe = state;
+        deltas_since_keyframe = 0;
+    } else {
+        deltas_since_keyframe++;
+    }
+}
+
+auto RewindBuffer::pop(std::vector<u8>& state) -> bool {
+    if (records.empty()) { return false; }
+
+    const Record newest = records.back();
+    decode(newest, newest.keyframe ? no_reference : keyframe, state);
+
+    if (records.size() == 1) { return true; }
+
+    records.pop_back();
+    write_offset = newest.offset;
+
+    if (!newest.keyframe) {
+        deltas_since_keyframe--;
+        return true;
+    }
+
+    /* Later deltas are made against the previous keyframe again */
+    auto previous = std::find_if(records.rbegin(), records.rend(),
+                                 [](const Record& record) { return record.keyframe; });
+
+    deltas_since_keyframe = static_cast<uint>(previous - records.rbegin());
+    decode(*previous, no_reference, keyframe);
+
+    return true;
+}
+
+auto RewindBuffer::memory_used() const -> size_t {
+    size_t used = 0;
+    for (const Record& record : records) { used += record.size; }
+    return used;
+}
+
+void RewindBuffer::encode(const std::vector<u8>& state, const std::vector<u8>& reference) {
+    encoded.clear();
+
+    /* XORed in one pass first, which the compiler can vectorise given
+     * plain pointers (a u8 store could otherwise alias the vectors) */
+    const size_t size = state.size();
+    difference.resize(size);
+    if (reference.empty()) {
+        std::copy(state.begin(), state.end(), difference.begin());
+    } else {
+        const u8* in = state.data();
+        const u8* against = reference.data();
+        u8* out = difference.data();
+        for (size_t i = 0; i < size; i++) { out[i] = in[i] ^ against[i]; }
+    }
+
+    /* Alternating runs of unchanged bytes, which are only counted, and
+     * changed bytes, which are stored */
+    size_t i = 0;
+    while (i < size) {
+        size_t zeros_start = i;
+
+        /* Most of a delta is unchanged, so skip it a word at a time */
+        u64 word;
+        while (i + sizeof(word) <= size) {
+            std::memcpy(&word, &difference[i], sizeof(word));
+            if (word != 0) { break; }
+            i += sizeof(word);
+        }
+
+        while (i < size && difference[i] == 0) { i++; }
+        write_length(encoded, i - zeros_start);
+
+        size_t literal_start = i;
+        while (i < size) {
+            size_t run = 0;
+            while (i + run < size && run < MIN_ZERO_RUN && difference[i + run] == 0) { run++; }
+
+            if (run == MIN_ZERO_RUN || i + run == size) { break; }
+            i += run + 1;
+        }
+
+        write_length(encoded, i - literal_start);
+        encoded.insert(encoded.end(), difference.begin() + literal_start, difference.begin() + i);
+    }
+}
+
+void RewindBuffer::decode(const Record& record, const std::vector<u8>& reference, std::vector<u8>& state) const {
+    const u8* in = storage.data() + record.offset;
+    const u8* end = in + record.size;
+
+    state.clear();
+
+    while (in < end) {
+        size_t zeros = read_length(in);
+        if (reference.empty()) {
+            state.insert(state.end(), zeros, 0);
+        } else {
+            state.insert(state.end(), reference.begin() + state.size(), reference.begin() + state.size() + zeros);
+        }
+
+        size_t literals = read_length(in);
+        for (size_t j = 0; j < literals; j++) {
+            u8 value = *in++;
+            state.push_back(reference.empty() ? value : static_cast<u8>(value ^ reference[state.size()]));
+        }
+    }
+}
+
+auto RewindBuffer::store(bool is_keyframe) -> bool {
+    if (encoded.size() > storage.size()) {
+        log_warn("Rewind buffer is too small to hold a snapshot of %zu bytes", encoded.size());
+        return false;
+    }
+
+    size_t offset;
+    while (!free_offset(encoded.size(), offset)) {
+        drop_oldest_keyframe();
+    }
+
+    std::memcpy(storage.data() + offset, encoded.data(), encoded.size());
+    records.push_back({offset, encoded.size(), is_keyframe});
+    write_offset = offset + encoded.size();
+
+    return true;
+}
+
+auto RewindBuffer::free_offset(size_t size, size_t& offset) const -> bool {
+    if (records.empty()) {
+        offset = 0;
+        return true;
+    }
+
+    /* Records are in the order they were written, so the oldest is the first
+     * thing after the newest. If the newest has wrapped around behind it,
+     * the free space is between them */
+    size_t oldest = records.front().offset;
+
+    if (oldest >= write_offset) {
+        offset = write_offset;
+        return oldest - write_offset >= size;
+    }
+
+    /* Otherwise it's after the newest, or before the oldest */
+    if (storage.size() - write_offset >= size) {
+        offset = write_offset;
+        return true;
+    }
+
+    offset = 0;
+    return oldest >= size;
+}
+
+void RewindBuffer::drop_oldest_keyframe() {
+    records.pop_front();
+
+    while (!records.empty() && !records.front().keyframe) {
+        records.pop_front();
+    }
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "definitions.h"
+
+#include <deque>
+#include <vector>
+
+/* Every this many snapshots is stored whole rather than as a delta */
+const uint REWIND_KEYFRAME_INTERVAL = 60;
+
+/*
+ * Recent save states (see save_state.h), kept in a fixed amount of memory so
+ * that the game can be played backwards.
+ *
+ * Consecutive states differ in very few bytes, so most snapshots are stored
+ * as the XOR of the state with the last keyframe, which is almost all zeros,
+ * and run-length encoded. Keyframes are encoded the same way against nothing.
+ * Snapshots are packed one after another into a ring of bytes, and when it is
+ * full the oldest keyframe is dropped along with the deltas which need it.
+ */
+class RewindBuffer {
+public:
+    RewindBuffer(size_t capacity);
+
+    void push(const std::vector<u8>& state);
+
+    /* Takes the most recent snapshot. The oldest is left in place, so that
+     * rewinding stops there rather than running out. Returns false if there
+     * is nothing to rewind to */
+    auto pop(std::vector<u8>& state) -> bool;
+
+    auto snapshot_count() const -> size_t { return records.size(); }
+
+    /* Bytes used by the encoded snapshots */
+    auto memory_used() const -> size_t;
+
+private:
+    struct Record {
+        size_t offset;
+        size_t size;
+        bool keyframe;
+    };
+
+    /* Writes `state` XOR `reference` (or `state` alone if `reference` is
+     * empty) into `encoded` */
+    void encode(const std::vector<u8>& state, const std::vector<u8>& reference);
+    void decode(const Record& record, const std::vector<u8>& reference, std::vector<u8>& state) const;
+
+    /* Stores `encoded`, making room for it if needed. Returns false if it
+     * can never fit */
+    auto store(bool keyframe) -> bool;
+
+    /* Where a record of `size` bytes can go without overwriting anything */
+    auto free_offset(size_t size, size_t& offset) const -> bool;
+
+    void drop_oldest_keyframe();
+
+    std::vector<u8> storage;
+    std::deque<Record> records;
+    size_t write_offset = 0;
+
+    /* The keyframe which new deltas are made against, decoded */
+    std::vector<u8> keyframe;
+    uint deltas_since_keyframe = 0;
+
+    /* Scratch space for encoding */
+    std::vector<u8> difference;
+    std::vector<u8> encoded;
+};
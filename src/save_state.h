@@ -0,0 +1,56 @@
+#pragma once
+
+#include "audio/apu.h"
+#include "cartridge/cartridge.h"
+#include "cpu/cpu.h"
+#include "video/video.h"
+#include "input.h"
+#include "mmu.h"
+#include "scheduler.h"
+#include "serial.h"
+#include "timer.h"
+#include "definitions.h"
+
+#include <type_traits>
+
+/*
+ * A save state is a SaveStateHeader, a SaveState, and then the cartridge's
+ * RAM, which is a different size for each game.
+ *
+ * Each component fills in a plain struct of its own, and the SaveState is
+ * copied out as it is laid out in memory, so that saving and loading are
+ * little more than a memcpy and can be done every frame (e.g. for rewinding).
+ * This means states are only portable between builds with the same layout,
+ * which the header's version and size are there to check.
+ */
+
+/* "GBST" */
+const u32 SAVE_STATE_MAGIC = 0x54534247;
+
+/* Bump this whenever any of the state structs change */
+const u32 SAVE_STATE_VERSION = 2;
+
+struct SaveStateHeader {
+    u32 magic;
+    u32 version;
+    u32 state_size;
+    u32 cartridge_ram_size;
+
+    /* Which game the state belongs to */
+    u16 rom_checksum;
+};
+
+struct SaveState {
+    SchedulerState scheduler;
+    CPUState cpu;
+    MMUState mmu;
+    CartridgeState cartridge;
+    VideoState video;
+    APUState apu;
+    TimerState timer;
+    InputState input;
+    SerialState serial;
+};
+
+static_assert(std::is_trivially_copyable<SaveState>::value,
+              "Save states are copied as bytes, so their contents must be too");
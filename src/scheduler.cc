@@ -0,0 +1,74 @@
+#include "scheduler.h"
+
+#include <algorithm>
+
+Scheduler::Scheduler() {
+    deadlines.fill(never());
+}
+
+void Scheduler::schedule(const Event event, const u64 when) {
+    deadlines[static_cast<uint>(event)] = when;
+
+    queue.push_back({when, event});
+    std::push_heap(queue.begin(), queue.end(), later);
+
+    discard_stale_entries();
+}
+
+void Scheduler::cancel(const Event event) {
+    deadlines[static_cast<uint>(event)] = never();
+    discard_stale_entries();
+}
+
+auto Scheduler::is_scheduled(const Event event) const -> bool {
+    return deadlines[static_cast<uint>(event)] != never();
+}
+
+auto Scheduler::pop_due(Event& event, u64& deadline) -> bool {
+    if (next_deadline > clock) { return false; }
+
+    event = queue.front().event;
+    deadline = queue.front().when;
+
+    std::pop_heap(queue.begin(), queue.end(), later);
+    queue.pop_back();
+    deadlines[static_cast<uint>(event)] = never();
+    events_handled++;
+
+    discard_stale_entries();
+    return true;
+}
+
+void Scheduler::discard_stale_entries() {
+    while (!queue.empty()) {
+        const Entry& front = queue.front();
+        if (deadlines[static_cast<uint>(front.event)] == front.when) { break; }
+
+        std::pop_heap(queue.begin(), queue.end(), later);
+        queue.pop_back();
+    }
+
+    next_deadline = queue.empty() ? never() : queue.front().when;
+}
+
+void Scheduler::save_state(SchedulerState& state) const {
+    state.clock = clock;
+    state.events_handled = events_handled;
+    state.deadlines = deadlines;
+}
+
+void Scheduler::load_state(const SchedulerState& state) {
+    clock = state.clock;
+    events_handled = state.events_handled;
+    deadlines = state.deadlines;
+
+    /* Each pending event has exactly one entry in a rebuilt queue */
+    queue.clear();
+    for (uint event = 0; event < event_type_count; event++) {
+        if (deadlines[event] == never()) { continue; }
+        queue.push_back({deadlines[event], static_cast<Event>(event)});
+    }
+    std::make_heap(queue.begin(), queue.end(), later);
+
+    discard_stale_entries();
+}
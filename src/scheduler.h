@@ -0,0 +1,79 @@
+#pragma once
+
+#include "definitions.h"
+
+#include <array>
+#include <vector>
+
+/* Things which happen at a point in time, rather than in response to the CPU */
+enum class Event : u8 {
+    VideoMode, /* The PPU moves on to its next mode */
+    Timer, /* TIMA is reloaded after overflowing */
+    FrameSequencer, /* The APU clocks its channels' lengths, envelopes and sweep */
+};
+
+const uint event_type_count = 3;
+
+/* Everything needed to restore the scheduler (see save_state.h) */
+struct SchedulerState {
+    u64 clock;
+    u64 events_handled;
+    std::array<u64, event_type_count> deadlines;
+};
+
+/*
+ * Keeps the master clock, and a queue of the events which are due to happen.
+ *
+ * The CPU runs until the earliest event is due, without any other component
+ * being ticked, and the event is then handed to whichever component it
+ * belongs to. Each kind of event is pending at most once: scheduling it again
+ * moves it, rather than adding a second one.
+ */
+class Scheduler {
+public:
+    Scheduler();
+
+    /* Master clocks (i.e. T-cycles, at CLOCK_RATE) elapsed since power on.
+     * The CPU's machine cycles are converted with CLOCKS_PER_CYCLE */
+    auto now() const -> u64 { return clock; }
+    void advance(uint cycles) { clock += cycles; }
+    void advance_to(u64 time) { clock = time; }
+
+    void schedule(Event event, u64 when);
+    void cancel(Event event);
+    auto is_scheduled(Event event) const -> bool;
+
+    /* When the earliest pending event is due; never() if there is none */
+    auto next_event_time() const -> u64 { return next_deadline; }
+
+    /* Take the earliest pending event off the queue, if it is due */
+    auto pop_due(Event& event, u64& deadline) -> bool;
+
+    /* Number of events taken off the queue so far */
+    auto event_count() const -> u64 { return events_handled; }
+
+    static constexpr auto never() -> u64 { return UINT64_MAX; }
+
+    void save_state(SchedulerState& state) const;
+    void load_state(const SchedulerState& state);
+
+private:
+    struct Entry {
+        u64 when;
+        Event event;
+    };
+
+    /* Orders the heap so that the earliest entry is at the front */
+    static auto later(const Entry& a, const Entry& b) -> bool { return a.when > b.when; }
+
+    void discard_stale_entries();
+
+    u64 clock = 0;
+    u64 next_deadline = never();
+    u64 events_handled = 0;
+
+    /* Entries whose deadline no longer matches `deadlines` were cancelled or
+     * moved, and are skipped when they reach the top of the heap */
+    std::vector<Entry> queue;
+    std::array<u64, event_type_count> deadlines;
+};
@@ -11,9 +11,15 @@ void Serial::write(const u8 byte) {
     data = byte;
 }
 
-void Serial::write_control(const u8 byte) const {
-    if (bitwise::check_bit(byte, 7) && options.print_serial) {
+void Serial::write_control(const u8 byte) {
+    if (!bitwise::check_bit(byte, 7) || !output_enabled) { return; }
+
+    if (options.print_serial) {
         printf("%c", data);
         fflush(stdout);
     }
+
+    if (options.capture_serial) {
+        output.push_back(static_cast<char>(data));
+    }
 }
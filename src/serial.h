@@ -3,16 +3,36 @@
 #include "definitions.h"
 #include "options.h"
 
+#include <string>
+
+/* Everything needed to restore the serial port (see save_state.h) */
+struct SerialState {
+    u8 data;
+};
+
 class Serial {
 public:
     Serial(Options& inOptions) : options(inOptions) {}
 
     auto read() const -> u8;
     void write(u8 byte);
-    void write_control(u8 byte) const;
+    void write_control(u8 byte);
+
+    /* Whether transfers are printed or captured, so that frames which will
+     * be thrown away don't output anything */
+    void set_output_enabled(bool enabled) { output_enabled = enabled; }
+
+    auto get_output() const -> const std::string& { return output; }
+
+    void save_state(SerialState& state) const { state.data = data; }
+    void load_state(const SerialState& state) { data = state.data; }
 
 private:
     Options& options;
 
-    u8 data;
+    u8 data = 0;
+    bool output_enabled = true;
+
+    /* With Options::capture_serial */
+    std::string output;
 };
@@ -1,24 +1,169 @@
 #include "timer.h"
 
-void Timer::tick(uint cycles) {
-    u8 new_divider = static_cast<u8>(divider.value() + cycles);
-    divider.set(new_divider);
-}
+#include "gameboy.h"
+#include "util/bitwise.h"
+
+#include <algorithm>
+
+/* Clocks between increments of TIMA, by TAC's clock select bits
+ * (4096Hz, 262144Hz, 65536Hz and 16384Hz) */
+static const uint timer_periods[4] = {1024, 16, 64, 256};
 
-auto Timer::get_divider() const -> u8 { return divider.value(); }
+/* DIV counts at 16384Hz */
+static const uint divider_shift = 8;
 
-auto Timer::get_timer() const -> u8 { return timer_counter.value(); }
+/* Clocks from TIMA overflowing to it being reloaded from TMA: one machine
+ * cycle */
+static const uint reload_delay = CLOCKS_PER_CYCLE;
+
+Timer::Timer(Gameboy& inGb) : gb(inGb) {}
+
+auto Timer::get_divider() const -> u8 {
+    return static_cast<u8>(system_counter(gb.scheduler.now()) >> divider_shift);
+}
+
+auto Timer::get_timer() -> u8 {
+    catch_up();
+    return timer_counter;
+}
 
 auto Timer::get_timer_modulo() const -> u8 { return timer_modulo.value(); }
 
-auto Timer::get_timer_control() const -> u8 { return timer_control.value(); }
+auto Timer::get_timer_control() const -> u8 { return timer_control.value() | 0xF8; }
 
 void Timer::reset_divider() {
-    divider.set(0x0);
+    catch_up();
+
+    /* The bit TIMA watches goes low along with the rest of the counter */
+    if (timer_bit_set()) { increment_timer(); }
+
+    divider_reset_time = gb.scheduler.now();
+    reschedule();
+}
+
+void Timer::set_timer(u8 value) {
+    catch_up();
+
+    /* Writing during the cycle before the reload cancels it */
+    reload_pending = false;
+    timer_counter = value;
+    reschedule();
 }
 
 void Timer::set_timer_modulo(u8 value) {
+    catch_up();
+    timer_modulo.set(value);
 }
 
 void Timer::set_timer_control(u8 value) {
+    catch_up();
+
+    /* Switching to another bit, or disabling the timer, while the old bit
+     * is set is a falling edge too */
+    bool was_set = timer_bit_set();
+    timer_control.set(value & 0x07);
+    if (was_set && !timer_bit_set()) { increment_timer(); }
+
+    reschedule();
+}
+
+void Timer::handle_overflow_event() {
+    catch_up();
+    reschedule();
+}
+
+void Timer::save_state(TimerState& state) const {
+    state.divider_reset_time = divider_reset_time;
+    state.timer_sync_time = timer_sync_time;
+    state.reload_time = reload_time;
+    state.timer_counter = timer_counter;
+    state.timer_modulo = timer_modulo.value();
+    state.timer_control = timer_control.value();
+    state.reload_pending = reload_pending;
+}
+
+void Timer::load_state(const TimerState& state) {
+    divider_reset_time = state.divider_reset_time;
+    timer_sync_time = state.timer_sync_time;
+    reload_time = state.reload_time;
+    timer_counter = state.timer_counter;
+    timer_modulo.set(state.timer_modulo);
+    timer_control.set(state.timer_control);
+    reload_pending = state.reload_pending;
+}
+
+auto Timer::enabled() const -> bool {
+    return bitwise::check_bit(timer_control.value(), 2);
+}
+
+auto Timer::period() const -> uint {
+    return timer_periods[timer_control.value() & 0x3];
+}
+
+auto Timer::timer_bit_set() const -> bool {
+    if (!enabled()) { return false; }
+
+    return system_counter(gb.scheduler.now()) % period() >= period() / 2;
+}
+
+void Timer::catch_up() {
+    u64 now = gb.scheduler.now();
+
+    while (true) {
+        if (reload_pending) {
+            if (reload_time > now) { break; }
+
+            reload_pending = false;
+            timer_counter = timer_modulo.value();
+            timer_sync_time = reload_time;
+            gb.cpu.interrupt_flag.set_bit_to(2, true);
+            continue;
+        }
+
+        if (!enabled()) { break; }
+
+        u64 first_edge = system_counter(timer_sync_time) / period();
+        u64 edges = system_counter(now) / period() - first_edge;
+        u64 until_overflow = 0x100 - timer_counter;
+
+        if (edges < until_overflow) {
+            timer_counter = static_cast<u8>(timer_counter + edges);
+            break;
+        }
+
+        u64 overflow_time = divider_reset_time + (first_edge + until_overflow) * period();
+        timer_counter = 0;
+        reload_pending = true;
+        reload_time = overflow_time + reload_delay;
+        timer_sync_time = overflow_time;
+    }
+
+    timer_sync_time = std::max(timer_sync_time, now);
+}
+
+void Timer::increment_timer() {
+    if (timer_counter == 0xFF) {
+        timer_counter = 0;
+        reload_pending = true;
+        reload_time = gb.scheduler.now() + reload_delay;
+    } else {
+        timer_counter++;
+    }
+}
+
+void Timer::reschedule() {
+    if (reload_pending) {
+        gb.scheduler.schedule(Event::Timer, reload_time);
+        return;
+    }
+
+    if (!enabled()) {
+        gb.scheduler.cancel(Event::Timer);
+        return;
+    }
+
+    u64 first_edge = system_counter(timer_sync_time) / period();
+    u64 until_overflow = 0x100 - timer_counter;
+    u64 overflow_time = divider_reset_time + (first_edge + until_overflow) * period();
+    gb.scheduler.schedule(Event::Timer, overflow_time + reload_delay);
 }
@@ -2,23 +2,80 @@
 
 #include "definitions.h"
 #include "register.h"
+#include "scheduler.h"
 
+class Gameboy;
+
+/* Everything needed to restore the timer (see save_state.h) */
+struct TimerState {
+    u64 divider_reset_time;
+    u64 timer_sync_time;
+    u64 reload_time;
+    u8 timer_counter;
+    u8 timer_modulo;
+    u8 timer_control;
+    bool reload_pending;
+};
+
+/*
+ * DIV, TIMA, TMA and TAC.
+ *
+ * Both counters are driven by the master clock (Scheduler::now(), in
+ * T-cycles at CLOCK_RATE), so neither is ticked: DIV is worked out from the
+ * time since it was last reset, and TIMA from its value when it was last
+ * brought up to date. The only thing the timer has to do on
+ * time is overflow, as that raises an interrupt, so the overflow is an event.
+ */
 class Timer {
 public:
-    void tick(uint cycles);
+    Timer(Gameboy& inGb);
 
     auto get_divider() const -> u8;
-    auto get_timer() const -> u8;
+    auto get_timer() -> u8;
     auto get_timer_modulo() const -> u8;
     auto get_timer_control() const -> u8;
 
     void reset_divider();
+    void set_timer(u8 value);
     void set_timer_modulo(u8 value);
     void set_timer_control(u8 value);
 
+    /* TIMA overflowed a machine cycle ago, and is reloaded from TMA */
+    void handle_overflow_event();
+
+    void save_state(TimerState& state) const;
+    void load_state(const TimerState& state);
+
 private:
-    ByteRegister divider;
-    ByteRegister timer_counter;
+    /* The internal counter which DIV is the top of, and whose falling edges
+     * at the bit selected by TAC increment TIMA */
+    auto system_counter(u64 time) const -> u64 { return time - divider_reset_time; }
+
+    auto enabled() const -> bool;
+
+    /* Clocks between increments of TIMA */
+    auto period() const -> uint;
+
+    /* Whether the bit of the system counter which TIMA watches is set, i.e.
+     * whether clearing it now would count as a falling edge */
+    auto timer_bit_set() const -> bool;
+
+    /* Brings TIMA up to the current time, including any overflows */
+    void catch_up();
+    void increment_timer();
+    void reschedule();
+
+    Gameboy& gb;
+
+    u64 divider_reset_time = 0;
+
+    /* TIMA as of `timer_sync_time` */
+    u8 timer_counter = 0;
+    u64 timer_sync_time = 0;
+
+    /* After overflowing, TIMA reads 0 for a cycle before it is reloaded */
+    bool reload_pending = false;
+    u64 reload_time = 0;
 
     ByteRegister timer_modulo;
     ByteRegister timer_control;
@@ -1,16 +1,16 @@
 #include "files.h"
 
-#include "log.h"
 #include <fstream>
 
-auto read_bytes(const std::string& filename) -> std::vector<u8> {
+auto read_bytes(const std::string& filename, std::string& error) -> std::vector<u8> {
     using std::ifstream;
     using std::ios;
 
     ifstream stream(filename.c_str(), ios::binary|ios::ate);
 
     if (!stream.good()) {
-        fatal_error("Cannot read from file: %s", filename.c_str());
+        error = "Cannot read from file: " + filename;
+        return {};
     }
 
     ifstream::pos_type position = stream.tellg();
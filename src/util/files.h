@@ -5,4 +5,5 @@
 
 #include "../definitions.h"
 
-auto read_bytes(const std::string& filename) -> std::vector<u8>;
+/* The whole of a file, or nothing with `error` set if it can't be read */
+auto read_bytes(const std::string& filename, std::string& error) -> std::vector<u8>;
@@ -20,7 +20,9 @@
 
 #include <cstdarg>
 
-Logger global_logger;
+static thread_local Logger thread_logger;
+static thread_local Logger* scoped_logger = nullptr;
+
 const char* COLOR_TRACE = "\033[1;30m";
 const char* COLOR_DEBUG = "\033[1;37m";
 const char* COLOR_UNIMPLEMENTED = "\033[1;35m";
@@ -75,6 +77,27 @@ inline auto Logger::level_color(LogLevel level) -> const char* {
     }
 }
 
+auto current_logger() -> Logger& {
+    return scoped_logger != nullptr ? *scoped_logger : thread_logger;
+}
+
+LogScope::LogScope(Logger& logger) :
+    previous(scoped_logger)
+{
+    scoped_logger = &logger;
+}
+
+LogScope::~LogScope() {
+    end();
+}
+
+void LogScope::end() {
+    if (ended) { return; }
+
+    scoped_logger = previous;
+    ended = true;
+}
+
 void log_set_level(LogLevel level) {
-    global_logger.set_level(level);
+    current_logger().set_level(level);
 }
@@ -30,6 +30,7 @@ enum class LogLevel {
 class Logger {
 public:
     Logger() = default;
+    Logger(LogLevel level) : current_level(level) {}
 
     void log(LogLevel level, const char* fmt, ...);
     void set_level(LogLevel level);
@@ -45,7 +46,31 @@ private:
     bool tracing_enabled = false;
 };
 
-extern Logger global_logger;
+/* Where log_* calls on this thread go: the logger of the innermost LogScope,
+ * or else one belonging to the thread */
+extern auto current_logger() -> Logger&;
+
+/*
+ * Sends everything logged on this thread to `logger` until the scope ends.
+ * Each Gameboy has a logger of its own and opens a scope whenever it runs, so
+ * that instances in one process don't share log settings.
+ */
+class LogScope {
+public:
+    LogScope(Logger& logger);
+    ~LogScope();
+
+    LogScope(const LogScope&) = delete;
+    auto operator=(const LogScope&) -> LogScope& = delete;
+
+    /* Goes back to the previous logger before the scope is destroyed */
+    void end();
+
+private:
+    Logger* previous;
+    bool ended = false;
+};
+
 extern const char* COLOR_TRACE;
 extern const char* COLOR_DEBUG;
 extern const char* COLOR_UNIMPLEMENTED;
@@ -57,12 +82,12 @@ extern const char* COLOR_RESET;
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wgnu-zero-variadic-macro-arguments"
 
-#define log_trace(...) global_logger.log(LogLevel::Trace, ##__VA_ARGS__);
-#define log_debug(...) global_logger.log(LogLevel::Debug, ##__VA_ARGS__);
-#define log_unimplemented(...) global_logger.log(LogLevel::Unimplemented, ##__VA_ARGS__);
-#define log_info(...) global_logger.log(LogLevel::Info, ##__VA_ARGS__);
-#define log_warn(...) global_logger.log(LogLevel::Warning, ##__VA_ARGS__);
-#define log_error(...) global_logger.log(LogLevel::Error, ##__VA_ARGS__);
+#define log_trace(...) current_logger().log(LogLevel::Trace, ##__VA_ARGS__);
+#define log_debug(...) current_logger().log(LogLevel::Debug, ##__VA_ARGS__);
+#define log_unimplemented(...) current_logger().log(LogLevel::Unimplemented, ##__VA_ARGS__);
+#define log_info(...) current_logger().log(LogLevel::Info, ##__VA_ARGS__);
+#define log_warn(...) current_logger().log(LogLevel::Warning, ##__VA_ARGS__);
+#define log_error(...) current_logger().log(LogLevel::Error, ##__VA_ARGS__);
 
 #pragma clang diagnostic pop
 
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+/*
+ * A fixed-size queue for handing items from one thread to another without
+ * locking. Only one thread may push, and only one thread may consume.
+ *
+ * The consumer reads items in place, as runs which are contiguous in memory,
+ * so that e.g. they can be written out with a single call.
+ */
+template <typename T, size_t Capacity>
+class RingBuffer {
+    static_assert((Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+public:
+    /* Returns false (and drops the item) if the buffer is full */
+    auto push(const T& item) -> bool {
+        size_t write = write_index.load(std::memory_order_relaxed);
+        if (write - read_index.load(std::memory_order_acquire) == Capacity) { return false; }
+
+        items[write & mask] = item;
+        write_index.store(write + 1, std::memory_order_release);
+        return true;
+    }
+
+    /* The oldest items which haven't been consumed, up to the end of the
+     * underlying storage. Returns how many there are */
+    auto peek(const T*& first) const -> size_t {
+        size_t read = read_index.load(std::memory_order_relaxed);
+        size_t available = write_index.load(std::memory_order_acquire) - read;
+        size_t until_wrap = Capacity - (read & mask);
+
+        first = &items[read & mask];
+        return available < until_wrap ? available : until_wrap;
+    }
+
+    /* Release items returned by peek() */
+    void consume(size_t count) {
+        read_index.store(read_index.load(std::memory_order_relaxed) + count, std::memory_order_release);
+    }
+
+private:
+    static const size_t mask = Capacity - 1;
+
+    std::array<T, Capacity> items;
+
+    /* Kept apart so that the two threads don't keep invalidating each other's cache line */
+    alignas(64) std::atomic<size_t> write_index = {0};
+    alignas(64) std::atomic<size_t> read_index = {0};
+};
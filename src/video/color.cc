@@ -12,6 +12,7 @@ auto get_color(u8 pixel_value) -> GBColor {
         case 3:
             return GBColor::Color3;
         default:
-            fatal_error("Invalid color value: %d", pixel_value);
+            log_error("Invalid color value: %d", pixel_value);
+            return GBColor::Color0;
     }
 }
@@ -1,5 +1,7 @@
 #include "framebuffer.h"
 
+#include <algorithm>
+
 FrameBuffer::FrameBuffer(uint _width, uint _height) :
     width(_width),
     height(_height),
@@ -11,12 +13,13 @@ void FrameBuffer::set_pixel(uint x, uint y, Color color) {
     buffer[pixel_index(x, y)] = color;
 }
 
-auto FrameBuffer::get_pixel(uint x, uint y) const -> Color { return buffer.at(pixel_index(x, y)); }
+auto FrameBuffer::get_pixel(uint x, uint y) const -> Color { return buffer[pixel_index(x, y)]; }
+
+auto FrameBuffer::line(uint y) -> Color* { return &buffer[pixel_index(0, y)]; }
+auto FrameBuffer::line(uint y) const -> const Color* { return &buffer[pixel_index(0, y)]; }
 
 inline auto FrameBuffer::pixel_index(uint x, uint y) const -> uint { return (y * width) + x; }
 
 void FrameBuffer::reset() {
-    for (uint i = 0; i < width * height; i++) {
-        buffer[i] = Color::White;
-    }
+    std::fill(buffer.begin(), buffer.end(), Color::White);
 }
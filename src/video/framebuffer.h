@@ -11,6 +11,10 @@ public:
     void set_pixel(uint x, uint y, Color color);
     auto get_pixel(uint x, uint y) const -> Color;
 
+    /* The pixels of row `y`, for accessing a whole line at once */
+    auto line(uint y) -> Color*;
+    auto line(uint y) const -> const Color*;
+
     void reset();
 
 private:
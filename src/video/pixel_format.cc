@@ -0,0 +1,91 @@
+#include "pixel_format.h"
+#include "simd.h"
+
+static_assert(GAMEBOY_WIDTH % 16 == 0, "Lines are converted 16 pixels at a time");
+
+#if defined(GBEMU_SIMD_SSE2)
+
+/* Picks the colour for each of four shades */
+static auto select_32(__m128i shades, const std::array<u32, 4>& colors) -> __m128i {
+    __m128i selected = _mm_setzero_si128();
+
+    for (int i = 0; i < 4; i++) {
+        __m128i matches = _mm_cmpeq_epi32(shades, _mm_set1_epi32(i));
+        selected = _mm_or_si128(selected, _mm_and_si128(matches, _mm_set1_epi32(static_cast<int>(colors[i]))));
+    }
+
+    return selected;
+}
+
+static auto select_16(__m128i shades, const std::array<u16, 4>& colors) -> __m128i {
+    __m128i selected = _mm_setzero_si128();
+
+    for (int i = 0; i < 4; i++) {
+        __m128i matches = _mm_cmpeq_epi16(shades, _mm_set1_epi16(static_cast<short>(i)));
+        selected = _mm_or_si128(selected, _mm_and_si128(matches, _mm_set1_epi16(static_cast<short>(colors[i]))));
+    }
+
+    return selected;
+}
+
+static void convert_line_argb8888(const Color* line, const std::array<u32, 4>& colors, u32* out) {
+    __m128i zero = _mm_setzero_si128();
+
+    for (uint x = 0; x < GAMEBOY_WIDTH; x += 16) {
+        __m128i shades = _mm_loadu_si128(reinterpret_cast<const __m128i*>(line + x));
+        __m128i low = _mm_unpacklo_epi8(shades, zero);
+        __m128i high = _mm_unpackhi_epi8(shades, zero);
+
+        __m128i* dest = reinterpret_cast<__m128i*>(out + x);
+        _mm_storeu_si128(dest + 0, select_32(_mm_unpacklo_epi16(low, zero), colors));
+        _mm_storeu_si128(dest + 1, select_32(_mm_unpackhi_epi16(low, zero), colors));
+        _mm_storeu_si128(dest + 2, select_32(_mm_unpacklo_epi16(high, zero), colors));
+        _mm_storeu_si128(dest + 3, select_32(_mm_unpackhi_epi16(high, zero), colors));
+    }
+}
+
+static void convert_line_rgb565(const Color* line, const std::array<u16, 4>& colors, u16* out) {
+    __m128i zero = _mm_setzero_si128();
+
+    for (uint x = 0; x < GAMEBOY_WIDTH; x += 16) {
+        __m128i shades = _mm_loadu_si128(reinterpret_cast<const __m128i*>(line + x));
+
+        __m128i* dest = reinterpret_cast<__m128i*>(out + x);
+        _mm_storeu_si128(dest + 0, select_16(_mm_unpacklo_epi8(shades, zero), colors));
+        _mm_storeu_si128(dest + 1, select_16(_mm_unpackhi_epi8(shades, zero), colors));
+    }
+}
+
+#else
+
+static void convert_line_argb8888(const Color* line, const std::array<u32, 4>& colors, u32* out) {
+    for (uint x = 0; x < GAMEBOY_WIDTH; x++) {
+        out[x] = colors[static_cast<u8>(line[x]) & 0x3];
+    }
+}
+
+static void convert_line_rgb565(const Color* line, const std::array<u16, 4>& colors, u16* out) {
+    for (uint x = 0; x < GAMEBOY_WIDTH; x++) {
+        out[x] = colors[static_cast<u8>(line[x]) & 0x3];
+    }
+}
+
+#endif
+
+void convert_to_argb8888(const FrameBuffer& buffer, const std::array<u32, 4>& colors, void* out, uint pitch) {
+    u8* row = static_cast<u8*>(out);
+
+    for (uint y = 0; y < GAMEBOY_HEIGHT; y++) {
+        convert_line_argb8888(buffer.line(y), colors, reinterpret_cast<u32*>(row));
+        row += pitch;
+    }
+}
+
+void convert_to_rgb565(const FrameBuffer& buffer, const std::array<u16, 4>& colors, void* out, uint pitch) {
+    u8* row = static_cast<u8*>(out);
+
+    for (uint y = 0; y < GAMEBOY_HEIGHT; y++) {
+        convert_line_rgb565(buffer.line(y), colors, reinterpret_cast<u16*>(row));
+        row += pitch;
+    }
+}
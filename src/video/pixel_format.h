@@ -0,0 +1,22 @@
+#pragma once
+
+#include "framebuffer.h"
+#include "../definitions.h"
+
+#include <array>
+
+/*
+ * Converting the screen's framebuffer from shades into pixels which a
+ * frontend can display. The pixels are written straight into memory the
+ * frontend owns (a locked texture, say), `pitch` bytes apart from one row to
+ * the next, so no intermediate copy of the frame is needed. Scaling is left
+ * to the frontend.
+ *
+ * `colors` gives the pixel value for each shade, from White to Black.
+ */
+void convert_to_argb8888(const FrameBuffer& buffer, const std::array<u32, 4>& colors, void* out, uint pitch);
+void convert_to_rgb565(const FrameBuffer& buffer, const std::array<u16, 4>& colors, void* out, uint pitch);
+
+/* Plain greys, as on a DMG */
+const std::array<u32, 4> DMG_COLORS_ARGB8888 = { 0xFFFFFFFF, 0xFFAAAAAA, 0xFF555555, 0xFF000000 };
+const std::array<u16, 4> DMG_COLORS_RGB565 = { 0xFFFF, 0xAD55, 0x52AA, 0x0000 };
@@ -0,0 +1,94 @@
+#include "render_thread.h"
+
+#include <chrono>
+
+RenderThread::RenderThread() :
+    commands(std::make_unique<RingBuffer<RenderCommand, 1 << 15>>()),
+    ready(GAMEBOY_WIDTH, GAMEBOY_HEIGHT),
+    presented(GAMEBOY_WIDTH, GAMEBOY_HEIGHT)
+{
+    thread = std::thread(&RenderThread::render_loop, this);
+}
+
+RenderThread::~RenderThread() {
+    stopping = true;
+    thread.join();
+}
+
+void RenderThread::write_vram(const uint offset, const u8 value) {
+    send({ RenderCommand::Type::WriteVram, value, static_cast<u16>(offset), {} });
+}
+
+void RenderThread::write_oam(const uint offset, const u8 value) {
+    send({ RenderCommand::Type::WriteOam, value, static_cast<u16>(offset), {} });
+}
+
+void RenderThread::draw_line(const uint line, const LineRegisters& registers) {
+    send({ RenderCommand::Type::DrawLine, 0, static_cast<u16>(line), registers });
+}
+
+void RenderThread::end_frame() {
+    send({ RenderCommand::Type::EndFrame, 0, 0, {} });
+}
+
+auto RenderThread::latest_frame(bool& changed) -> const FrameBuffer& {
+    std::lock_guard<std::mutex> lock(frames_mutex);
+
+    changed = ready_is_new;
+    if (ready_is_new) {
+        std::swap(ready, presented);
+        ready_is_new = false;
+    }
+
+    return presented;
+}
+
+void RenderThread::send(const RenderCommand& command) {
+    while (!commands->push(command)) {
+        std::this_thread::yield();
+    }
+}
+
+void RenderThread::render_loop() {
+    while (!stopping) {
+        if (render_pending() == 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+}
+
+auto RenderThread::render_pending() -> size_t {
+    const RenderCommand* pending = nullptr;
+    size_t count = commands->peek(pending);
+
+    for (size_t i = 0; i < count; i++) {
+        const RenderCommand& command = pending[i];
+
+        switch (command.type) {
+            case RenderCommand::Type::WriteVram:
+                renderer.write_vram(command.offset, command.value);
+                break;
+            case RenderCommand::Type::WriteOam:
+                renderer.write_oam(command.offset, command.value);
+                break;
+            case RenderCommand::Type::DrawLine:
+                renderer.draw_line(command.offset, command.registers);
+                break;
+            case RenderCommand::Type::EndFrame:
+                publish_frame();
+                break;
+        }
+    }
+
+    commands->consume(count);
+    return count;
+}
+
+void RenderThread::publish_frame() {
+    /* Otherwise the frontend already has (or is about to get) the same frame */
+    if (!renderer.take_changed()) { return; }
+
+    std::lock_guard<std::mutex> lock(frames_mutex);
+    ready = renderer.frame();
+    ready_is_new = true;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "framebuffer.h"
+#include "renderer.h"
+
+#include "../definitions.h"
+#include "../util/ring_buffer.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+/* Work for the render thread, in the order the PPU produced it. VRAM and OAM
+ * writes are queued alongside the lines so that each line is drawn from the
+ * memory the PPU would have seen at the time */
+struct RenderCommand {
+    enum class Type : u8 {
+        WriteVram,
+        WriteOam,
+        DrawLine,
+        EndFrame,
+    };
+
+    Type type;
+    u8 value;
+
+    /* The VRAM or OAM offset written, or the line to draw */
+    u16 offset;
+
+    LineRegisters registers;
+};
+
+/*
+ * Draws lines on a separate thread, so that emulation doesn't wait on
+ * rendering (--render-thread).
+ *
+ * Finished frames are triple buffered: the renderer draws into its own
+ * framebuffer, copies each finished frame into `ready`, and the emulator
+ * thread swaps `ready` with the frame it hands to the frontend. Neither
+ * thread waits for the other to finish with a frame, at the cost of the
+ * frontend seeing frames up to one frame late.
+ */
+class RenderThread {
+public:
+    RenderThread();
+    ~RenderThread();
+
+    void write_vram(uint offset, u8 value);
+    void write_oam(uint offset, u8 value);
+    void draw_line(uint line, const LineRegisters& registers);
+    void end_frame();
+
+    /* The most recently finished frame, and whether it differs from the one
+     * returned last time */
+    auto latest_frame(bool& changed) -> const FrameBuffer&;
+
+private:
+    void send(const RenderCommand& command);
+
+    void render_loop();
+    auto render_pending() -> size_t;
+    void publish_frame();
+
+    /* Only used by the render thread */
+    Renderer renderer;
+
+    /* Large, so allocated separately */
+    std::unique_ptr<RingBuffer<RenderCommand, 1 << 15>> commands;
+
+    std::mutex frames_mutex;
+    FrameBuffer ready;
+    FrameBuffer presented;
+    bool ready_is_new = false;
+
+    std::atomic<bool> stopping = {false};
+    std::thread thread;
+};
@@ -0,0 +1,369 @@
+#include "renderer.h"
+
+#include "color.h"
+#include "scanline.h"
+
+#include "../util/bitwise.h"
+#include "../util/log.h"
+
+#include <algorithm>
+#include <cstring>
+
+using bitwise::check_bit;
+
+auto LineRegisters::operator==(const LineRegisters& other) const -> bool {
+    return control == other.control
+        && scroll_x == other.scroll_x
+        && scroll_y == other.scroll_y
+        && window_x == other.window_x
+        && window_y == other.window_y
+        && bg_palette == other.bg_palette
+        && sprite_palette_0 == other.sprite_palette_0
+        && sprite_palette_1 == other.sprite_palette_1
+        && disable_background == other.disable_background
+        && disable_sprites == other.disable_sprites
+        && disable_window == other.disable_window;
+}
+
+auto LineSignature::operator==(const LineSignature& other) const -> bool {
+    return drawn == other.drawn
+        && registers == other.registers
+        && bg_map_version == other.bg_map_version
+        && window_map_version == other.window_map_version
+        && oam_version == other.oam_version
+        && tile_row_versions == other.tile_row_versions;
+}
+
+Renderer::Renderer() :
+    buffer(GAMEBOY_WIDTH, GAMEBOY_HEIGHT),
+    video_ram(0x2000),
+    tiles(video_ram.data()),
+    oam_ram(0xA0)
+{
+}
+
+void Renderer::write_vram(uint offset, u8 value) {
+    video_ram.at(offset) = value;
+    tiles.invalidate(offset);
+
+    /* VRAM is indexed from 0x8000 */
+    uint tile_maps_offset = TILE_MAP_ZERO_ADDRESS.value() - 0x8000;
+    if (offset >= tile_maps_offset) {
+        map_row_versions[(offset - tile_maps_offset) / TILES_PER_LINE]++;
+    }
+}
+
+void Renderer::write_oam(uint offset, u8 value) {
+    oam_ram.at(offset) = value;
+    oam_dirty = true;
+    oam_version++;
+}
+
+auto Renderer::take_changed() -> bool {
+    bool was_changed = changed;
+    changed = false;
+    return was_changed;
+}
+
+auto Renderer::display_enabled() const -> bool { return check_bit(registers.control, 7); }
+auto Renderer::window_tile_map() const -> bool { return check_bit(registers.control, 6); }
+auto Renderer::window_enabled() const -> bool { return check_bit(registers.control, 5); }
+auto Renderer::bg_window_tile_data() const -> bool { return check_bit(registers.control, 4); }
+auto Renderer::bg_tile_map_display() const -> bool { return check_bit(registers.control, 3); }
+auto Renderer::sprite_size() const -> bool { return check_bit(registers.control, 2); }
+auto Renderer::sprites_enabled() const -> bool { return check_bit(registers.control, 1); }
+auto Renderer::bg_enabled() const -> bool { return check_bit(registers.control, 0); }
+
+auto Renderer::line_signature(uint current_line) -> LineSignature {
+    LineSignature signature;
+    signature.drawn = true;
+
+    /* A disabled display is blank, whatever else is set */
+    if (!display_enabled()) {
+        signature.registers.control = registers.control;
+        return signature;
+    }
+
+    signature.registers = registers;
+
+    /* Which row of their tiles the layers use on this line */
+    u8 tile_rows_used = 0;
+
+    if (bg_enabled() && !registers.disable_background) {
+        uint bg_map_y = (current_line + registers.scroll_y) % BG_MAP_SIZE;
+        uint map_row = bg_tile_map_display() ? TILES_PER_LINE : 0;
+
+        signature.bg_map_version = map_row_versions[map_row + bg_map_y / TILE_HEIGHT_PX];
+        tile_rows_used |= 1 << (bg_map_y % TILE_HEIGHT_PX);
+    }
+
+    uint window_line = current_line - registers.window_y;
+    if (window_enabled() && !registers.disable_window && window_line < GAMEBOY_HEIGHT) {
+        uint map_row = window_tile_map() ? TILES_PER_LINE : 0;
+
+        signature.window_map_version = map_row_versions[map_row + window_line / TILE_HEIGHT_PX];
+        tile_rows_used |= 1 << (window_line % TILE_HEIGHT_PX);
+    }
+
+    if (sprites_enabled() && !registers.disable_sprites) {
+        signature.oam_version = oam_version;
+
+        uint height = sprite_size() ? 2 * TILE_HEIGHT_PX : TILE_HEIGHT_PX;
+        u64 on_line = select_sprites(current_line);
+
+        for (const Sprite& sprite : sprites) {
+            if (((on_line >> sprite.index) & 1) == 0) { continue; }
+
+            uint y = current_line + 16 - sprite.y;
+            uint maybe_flipped_y = !check_bit(sprite.attributes, 6) ? y : height - y - 1;
+            tile_rows_used |= 1 << (maybe_flipped_y % TILE_HEIGHT_PX);
+        }
+    }
+
+    for (uint row = 0; row < TILE_HEIGHT_PX; row++) {
+        if (check_bit(tile_rows_used, static_cast<u8>(row))) {
+            signature.tile_row_versions[row] = tiles.row_version(row);
+        }
+    }
+
+    return signature;
+}
+
+void Renderer::draw_line(uint current_line, const LineRegisters& line_registers) {
+    registers = line_registers;
+
+    /* Whatever is left of this line from the last frame drawn may still be
+     * right, in which case there's no need to draw it again */
+    LineSignature signature = line_signature(current_line);
+    if (signature == line_signatures[current_line]) { return; }
+
+    line_signatures[current_line] = signature;
+    changed = true;
+
+    Color* line_pixels = buffer.line(current_line);
+    std::fill(line_pixels, line_pixels + GAMEBOY_WIDTH, Color::White);
+
+    if (!display_enabled()) { return; }
+
+    bg_line.fill(0);
+
+    if (bg_enabled() && !registers.disable_background) {
+        draw_bg_line(current_line);
+    }
+
+    if (window_enabled() && !registers.disable_window) {
+        draw_window_line(current_line);
+    }
+
+    if (sprites_enabled() && !registers.disable_sprites) {
+        draw_sprites_line(current_line);
+    }
+}
+
+void Renderer::draw_bg_line(uint current_line) {
+    bool use_tile_map_zero = !bg_tile_map_display();
+
+    Palette palette = load_palette(registers.bg_palette);
+
+    Address tile_map_address = use_tile_map_zero
+        ? TILE_MAP_ZERO_ADDRESS
+        : TILE_MAP_ONE_ADDRESS;
+
+    /* The row of the full background map which ends up on this line */
+    uint bg_map_y = (current_line + registers.scroll_y) % BG_MAP_SIZE;
+
+    /* Unless the scroll is a multiple of 8, the line starts part way into a
+     * tile and so straddles one more tile than fits on the screen */
+    uint fine_x = registers.scroll_x % TILE_WIDTH_PX;
+    std::array<u8, GAMEBOY_WIDTH + TILE_WIDTH_PX> pixels;
+
+    fetch_tile_row(tile_map_address, bg_map_y, registers.scroll_x / TILE_WIDTH_PX,
+        pixels.size() / TILE_WIDTH_PX, pixels.data());
+
+    std::memcpy(bg_line.data(), pixels.data() + fine_x, GAMEBOY_WIDTH);
+    apply_palette(bg_line.data(), palette, buffer.line(current_line), GAMEBOY_WIDTH);
+}
+
+void Renderer::draw_window_line(uint current_line) {
+    bool use_tile_map_zero = !window_tile_map();
+
+    Palette palette = load_palette(registers.bg_palette);
+
+    Address tile_map_address = use_tile_map_zero
+        ? TILE_MAP_ZERO_ADDRESS
+        : TILE_MAP_ONE_ADDRESS;
+
+    uint window_line = current_line - registers.window_y;
+    if (window_line >= GAMEBOY_HEIGHT) { return; }
+
+    /* The window covers the screen from WX - 7 to the right edge. A WX below
+     * 7 moves the window's first columns off the left edge */
+    int window_start = registers.window_x - 7;
+    uint screen_x = window_start > 0 ? static_cast<uint>(window_start) : 0;
+    if (screen_x >= GAMEBOY_WIDTH) { return; }
+
+    uint window_column = static_cast<uint>(static_cast<int>(screen_x) - window_start);
+    uint fine_x = window_column % TILE_WIDTH_PX;
+    uint width = GAMEBOY_WIDTH - screen_x;
+    std::array<u8, GAMEBOY_WIDTH + TILE_WIDTH_PX> pixels;
+
+    uint tile_count = (fine_x + width + TILE_WIDTH_PX - 1) / TILE_WIDTH_PX;
+    fetch_tile_row(tile_map_address, window_line, window_column / TILE_WIDTH_PX, tile_count, pixels.data());
+
+    std::memcpy(bg_line.data() + screen_x, pixels.data() + fine_x, width);
+    apply_palette(bg_line.data() + screen_x, palette, buffer.line(current_line) + screen_x, width);
+}
+
+void Renderer::fetch_tile_row(const Address& tile_map_address, uint map_y, uint first_tile, uint count, u8* out) {
+    /* Note: tileset two uses signed numbering to share half the tiles with tileset 1 */
+    bool use_tile_set_zero = bg_window_tile_data();
+
+    uint tile_y = map_y / TILE_HEIGHT_PX;
+    uint tile_pixel_y = map_y % TILE_HEIGHT_PX;
+
+    /* VRAM is indexed from 0x8000 */
+    uint map_row_offset = tile_map_address.value() - 0x8000 + tile_y * TILES_PER_LINE;
+    const u8* map_row = &video_ram[map_row_offset];
+
+    for (uint i = 0; i < count; i++) {
+        u8 tile_id = map_row[(first_tile + i) % TILES_PER_LINE];
+
+        /* The second tile set uses signed IDs, relative to the tile at 0x9000 */
+        uint tile_number = use_tile_set_zero
+            ? tile_id
+            : static_cast<uint>(256 + static_cast<s8>(tile_id));
+
+        std::memcpy(out + i * TILE_WIDTH_PX, tiles.row(tile_number, tile_pixel_y), TILE_WIDTH_PX);
+    }
+}
+
+void Renderer::scan_oam() {
+    for (uint i = 0; i < SPRITE_COUNT; i++) {
+        const u8* entry = &oam_ram[i * SPRITE_BYTES];
+        sprites[i] = { entry[0], entry[1], entry[2], entry[3], static_cast<u8>(i) };
+    }
+
+    sprites_by_priority = sprites;
+    std::stable_sort(sprites_by_priority.begin(), sprites_by_priority.end(),
+        [](const Sprite& a, const Sprite& b) { return a.x < b.x; });
+
+    oam_dirty = false;
+}
+
+auto Renderer::select_sprites(uint current_line) -> u64 {
+    if (oam_dirty) { scan_oam(); }
+
+    uint height = sprite_size() ? 2 * TILE_HEIGHT_PX : TILE_HEIGHT_PX;
+
+    /* The PPU picks the first sprites in OAM which cover the line, whether or
+     * not they end up on screen horizontally */
+    u64 on_line = 0;
+    uint count = 0;
+    for (const Sprite& sprite : sprites) {
+        uint top = current_line + 16 - sprite.y;
+        if (top >= height) { continue; }
+
+        on_line |= u64(1) << sprite.index;
+        if (++count == MAX_SPRITES_PER_LINE) { break; }
+    }
+
+    return on_line;
+}
+
+void Renderer::draw_sprites_line(uint current_line) {
+    uint height = sprite_size() ? 2 * TILE_HEIGHT_PX : TILE_HEIGHT_PX;
+
+    u64 on_line = select_sprites(current_line);
+    if (on_line == 0) { return; }
+
+    /* Each pixel belongs to the highest priority sprite which isn't
+     * transparent there, even if that sprite is then hidden by the background */
+    std::array<bool, GAMEBOY_WIDTH> covered = {};
+
+    for (const Sprite& sprite : sprites_by_priority) {
+        if ((on_line >> sprite.index) & 1) { draw_sprite_line(sprite, current_line, height, covered); }
+    }
+}
+
+void Renderer::draw_sprite_line(const Sprite& sprite, const uint current_line, const uint height,
+                                std::array<bool, GAMEBOY_WIDTH>& covered) {
+    /* Bits 0-3 are used only for CGB */
+    bool use_palette_1 = check_bit(sprite.attributes, 4);
+    bool flip_x = check_bit(sprite.attributes, 5);
+    bool flip_y = check_bit(sprite.attributes, 6);
+    bool obj_behind_bg = check_bit(sprite.attributes, 7);
+
+    Palette palette = use_palette_1
+        ? load_palette(registers.sprite_palette_1)
+        : load_palette(registers.sprite_palette_0);
+
+    uint y = current_line + 16 - sprite.y;
+    uint maybe_flipped_y = !flip_y ? y : height - y - 1;
+
+    /* Sprites are always taken from the first tileset, so pattern numbers are
+     * tile numbers. In 8x16 mode, the top half is the even tile and the bottom
+     * half is the next one */
+    uint pattern_n = height > TILE_HEIGHT_PX ? sprite.tile & 0xFE : sprite.tile;
+    uint tile_number = pattern_n + maybe_flipped_y / TILE_HEIGHT_PX;
+    const u8* tile_row = tiles.row(tile_number, maybe_flipped_y % TILE_HEIGHT_PX);
+
+    Color* line_pixels = buffer.line(current_line);
+
+    for (uint x = 0; x < TILE_WIDTH_PX; x++) {
+        uint screen_x = sprite.x + x - 8;
+        if (screen_x >= GAMEBOY_WIDTH) { continue; }
+
+        uint maybe_flipped_x = !flip_x ? x : TILE_WIDTH_PX - x - 1;
+        GBColor gb_color = get_color(tile_row[maybe_flipped_x]);
+
+        /* Color 0 is transparent */
+        if (gb_color == GBColor::Color0) { continue; }
+
+        if (covered[screen_x]) { continue; }
+        covered[screen_x] = true;
+
+        if (obj_behind_bg && bg_line[screen_x] != 0) { continue; }
+
+        line_pixels[screen_x] = get_color_from_palette(gb_color, palette);
+    }
+}
+
+auto Renderer::load_palette(u8 palette_register) -> Palette {
+    using bitwise::compose_bits;
+    using bitwise::bit_value;
+
+    /* TODO: Reduce duplication */
+    u8 color0 = compose_bits(bit_value(palette_register, 1), bit_value(palette_register, 0));
+    u8 color1 = compose_bits(bit_value(palette_register, 3), bit_value(palette_register, 2));
+    u8 color2 = compose_bits(bit_value(palette_register, 5), bit_value(palette_register, 4));
+    u8 color3 = compose_bits(bit_value(palette_register, 7), bit_value(palette_register, 6));
+
+    Color real_color_0 = get_real_color(color0);
+    Color real_color_1 = get_real_color(color1);
+    Color real_color_2 = get_real_color(color2);
+    Color real_color_3 = get_real_color(color3);
+
+    return { real_color_0, real_color_1, real_color_2, real_color_3 };
+}
+
+auto Renderer::get_color_from_palette(GBColor color, const Palette& palette) -> Color {
+    switch (color) {
+        case GBColor::Color0: return palette.color0;
+        case GBColor::Color1: return palette.color1;
+        case GBColor::Color2: return palette.color2;
+        case GBColor::Color3: return palette.color3;
+    }
+}
+
+
+auto Renderer::get_real_color(u8 pixel_value) -> Color {
+    switch (pixel_value) {
+        case 0: return Color::White;
+        case 1: return Color::LightGray;
+        case 2: return Color::DarkGray;
+        case 3: return Color::Black;
+        default:
+            log_error("Invalid color value: %d", pixel_value);
+            return Color::White;
+    }
+}
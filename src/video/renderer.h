@@ -0,0 +1,146 @@
+#pragma once
+
+#include "framebuffer.h"
+#include "tile.h"
+
+#include "../definitions.h"
+
+#include <array>
+#include <vector>
+
+/* The registers which decide how a line is drawn, as they were when the PPU
+ * reached it */
+struct LineRegisters {
+    u8 control = 0; /* LCDC */
+    u8 scroll_x = 0;
+    u8 scroll_y = 0;
+    u8 window_x = 0;
+    u8 window_y = 0;
+    u8 bg_palette = 0;
+    u8 sprite_palette_0 = 0;
+    u8 sprite_palette_1 = 0;
+
+    bool disable_background = false;
+    bool disable_sprites = false;
+    bool disable_window = false;
+
+    auto operator==(const LineRegisters& other) const -> bool;
+};
+
+/* A sprite's entry in OAM. Positions are as stored, offset by (8, 16) from
+ * the screen so that sprites can be partly off the top and left edges */
+struct Sprite {
+    u8 y;
+    u8 x;
+    u8 tile;
+    u8 attributes;
+
+    /* Position in OAM, which breaks ties between sprites at the same x */
+    u8 index;
+};
+
+/*
+ * Everything which decides what a line of the screen looks like. If a line's
+ * signature is the same as when it was last drawn, the pixels it left in the
+ * framebuffer are still right.
+ *
+ * Rather than the tiles themselves, this records how many times the tile
+ * map rows and tile rows the line uses have been written.
+ */
+struct LineSignature {
+    bool drawn = false;
+
+    LineRegisters registers;
+
+    u32 bg_map_version = 0;
+    u32 window_map_version = 0;
+    u32 oam_version = 0;
+    std::array<u32, TILE_HEIGHT_PX> tile_row_versions = {};
+
+    auto operator==(const LineSignature& other) const -> bool;
+};
+
+/*
+ * Draws lines of the screen into a framebuffer, from its own copy of VRAM and
+ * OAM. Keeping the copies separate from the PPU's lets drawing happen on
+ * another thread (see RenderThread), as long as writes reach the renderer in
+ * the same order relative to the lines drawn.
+ */
+class Renderer {
+public:
+    Renderer();
+
+    /* VRAM at `offset` (from 0x8000), or OAM at `offset`, changed */
+    void write_vram(uint offset, u8 value);
+    void write_oam(uint offset, u8 value);
+
+    /* Draws a line, unless it would look the same as it did last time */
+    void draw_line(uint line, const LineRegisters& line_registers);
+
+    auto frame() const -> const FrameBuffer& { return buffer; }
+
+    /* Whether any line has been drawn differently since the last call */
+    auto take_changed() -> bool;
+
+private:
+    auto line_signature(uint current_line) -> LineSignature;
+
+    void draw_bg_line(uint current_line);
+    void draw_window_line(uint current_line);
+    void draw_sprites_line(uint current_line);
+    void draw_sprite_line(const Sprite& sprite, uint current_line, uint height,
+                          std::array<bool, GAMEBOY_WIDTH>& covered);
+
+    /* Copies the decoded pixels of `count` tiles from the line `map_y` of a
+     * tile map into `out`, starting at column `first_tile` and wrapping
+     * around the map */
+    void fetch_tile_row(const Address& tile_map_address, uint map_y, uint first_tile, uint count, u8* out);
+
+    /* The sprites drawn on a line, as a mask of their positions in OAM */
+    auto select_sprites(uint current_line) -> u64;
+
+    /* Re-reads the sprites from OAM after it has been written */
+    void scan_oam();
+
+    auto display_enabled() const -> bool;
+    auto window_tile_map() const -> bool;
+    auto window_enabled() const -> bool;
+    auto bg_window_tile_data() const -> bool;
+    auto bg_tile_map_display() const -> bool;
+    auto sprite_size() const -> bool;
+    auto sprites_enabled() const -> bool;
+    auto bg_enabled() const -> bool;
+
+    static auto get_real_color(u8 pixel_value) -> Color;
+    static auto load_palette(u8 palette_register) -> Palette;
+    static auto get_color_from_palette(GBColor color, const Palette& palette) -> Color;
+
+    FrameBuffer buffer;
+
+    /* The registers for the line being drawn */
+    LineRegisters registers;
+
+    std::vector<u8> video_ram;
+    TileCache tiles;
+
+    /* Writes to each line of the two tile maps */
+    std::array<u32, 2 * TILES_PER_LINE> map_row_versions = {};
+
+    std::vector<u8> oam_ram;
+    bool oam_dirty = true;
+    u32 oam_version = 0;
+
+    /* The sprites in OAM order, which decides which are drawn on a crowded
+     * line, and in drawing priority order: by x, then by position in OAM */
+    std::array<Sprite, SPRITE_COUNT> sprites;
+    std::array<Sprite, SPRITE_COUNT> sprites_by_priority;
+
+    /* The colour index (before the palette is applied) of each pixel of the
+     * background and window on the current line, as a sprite which is
+     * behind the background only shows through colour 0 */
+    std::array<u8, GAMEBOY_WIDTH> bg_line;
+
+    /* What each line looked like when it was last drawn */
+    std::array<LineSignature, GAMEBOY_HEIGHT> line_signatures;
+    bool changed = false;
+};
@@ -0,0 +1,40 @@
+#include "scanline.h"
+#include "simd.h"
+
+#if defined(GBEMU_SIMD_SSE2)
+
+/* Selects the palette entry for each of 16 indices */
+static void apply_palette_16(const u8* indices, const u8* lut, Color* out) {
+    __m128i index = _mm_loadu_si128(reinterpret_cast<const __m128i*>(indices));
+    __m128i mapped = _mm_setzero_si128();
+
+    for (int i = 0; i < 4; i++) {
+        __m128i matches = _mm_cmpeq_epi8(index, _mm_set1_epi8(static_cast<char>(i)));
+        mapped = _mm_or_si128(mapped, _mm_and_si128(matches, _mm_set1_epi8(static_cast<char>(lut[i]))));
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), mapped);
+}
+
+#endif
+
+void apply_palette(const u8* indices, const Palette& palette, Color* out, uint count) {
+    const u8 lut[4] = {
+        static_cast<u8>(palette.color0),
+        static_cast<u8>(palette.color1),
+        static_cast<u8>(palette.color2),
+        static_cast<u8>(palette.color3),
+    };
+
+    uint i = 0;
+
+#if defined(GBEMU_SIMD_SSE2)
+    for (; i + 16 <= count; i += 16) {
+        apply_palette_16(indices + i, lut, out + i);
+    }
+#endif
+
+    for (; i < count; i++) {
+        out[i] = static_cast<Color>(lut[indices[i] & 0x3]);
+    }
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "../definitions.h"
+
+/*
+ * The last step of drawing a line: mapping the colour indices of a whole line
+ * of pixels through a palette into the framebuffer.
+ *
+ * With GBEMU_SIMD on an SSE2 host, 16 pixels are mapped at a time; otherwise
+ * (or for any leftover pixels) each pixel goes through a lookup table.
+ */
+void apply_palette(const u8* indices, const Palette& palette, Color* out, uint count);
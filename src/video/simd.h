@@ -0,0 +1,18 @@
+#pragma once
+
+#include "../definitions.h"
+
+/*
+ * Drawing scanlines and converting frames have vector paths, built when
+ * GBEMU_SIMD is on and the host has SSE2. Both look something up by a 2-bit
+ * index (a palette entry, or a colour), and as SSE2 has no shuffle to do
+ * that with, they compare against each of the four possible indices and
+ * combine the matches instead.
+ */
+#if defined(GBEMU_SIMD) && defined(__SSE2__)
+#define GBEMU_SIMD_SSE2 1
+#include <emmintrin.h>
+#endif
+
+/* The vector paths store 16 pixels as 16 bytes */
+static_assert(sizeof(Color) == 1, "Color is expected to be a byte");
@@ -1,46 +1,53 @@
 #include "tile.h"
 
-#include "color.h"
-#include "../util/bitwise.h"
+#include <cstring>
 
-using bitwise::bit_value;
+/* Each byte of a row's two bitplanes spread out into one byte per pixel, the
+ * leftmost pixel (bit 7) first. A row is then its low plane's entry ORed with
+ * its high plane's entry shifted up a bit, which works on all 8 pixels at once
+ * as no pixel's value can carry into the next */
+static auto make_bitplane_table() -> std::array<u64, 256> {
+    std::array<u64, 256> table;
 
-Tile::Tile(Address& tile_address, MMU& mmu, uint size_multiplier) {
-    /* Set the whole framebuffer to be black */
-    for (uint x = 0; x < TILE_WIDTH_PX; x++) {
-        for (uint y = 0; y < TILE_HEIGHT_PX * size_multiplier; y++) {
-            buffer[pixel_index(x, y)] = GBColor::Color0;
+    for (uint byte = 0; byte < 256; byte++) {
+        u8 pixels[TILE_WIDTH_PX];
+        for (uint x = 0; x < TILE_WIDTH_PX; x++) {
+            pixels[x] = (byte >> (7 - x)) & 1;
         }
+        std::memcpy(&table[byte], pixels, sizeof(pixels));
     }
 
-    for (uint tile_line = 0; tile_line < TILE_HEIGHT_PX * size_multiplier; tile_line++) {
-        /* 2 (bytes per line of pixels) * y (lines) */
-        uint index_into_tile = 2 * tile_line;
-        Address line_start = tile_address + index_into_tile;
-
-        u8 pixels_1 = mmu.read(line_start);
-        u8 pixels_2 = mmu.read(line_start + 1);
+    return table;
+}
 
-        std::vector<u8> pixel_line = get_pixel_line(pixels_1, pixels_2);
+static const std::array<u64, 256> bitplane_table = make_bitplane_table();
 
-        for (uint x = 0; x < TILE_WIDTH_PX; x++) {
-            buffer[pixel_index(x, tile_line)] = get_color(pixel_line[x]);
-        }
-    }
+TileCache::TileCache(const u8* inVideoRam) : video_ram(inVideoRam) {
+    stale.fill(true);
 }
 
-auto Tile::get_pixel(uint x, uint y) const -> GBColor { return buffer[pixel_index(x, y)]; }
+auto TileCache::row(uint tile, uint y) -> const u8* {
+    uint row_index = tile * TILE_HEIGHT_PX + y;
+    if (stale[row_index]) { decode(row_index); }
 
-auto Tile::get_pixel_line(u8 byte1, u8 byte2) -> std::vector<u8> {
-    using bitwise::bit_value;
+    return rows[row_index].data();
+}
 
-    std::vector<u8> pixel_line;
-    for (u8 i = 0; i < 8; i++) {
-        u8 color_value = static_cast<u8>((bit_value(byte2, 7-i) << 1) | bit_value(byte1, 7-i));
-        pixel_line.push_back(color_value);
-    }
+void TileCache::invalidate(uint offset) {
+    /* Each row is two bytes */
+    uint row_index = offset / 2;
+    if (row_index >= stale.size()) { return; }
 
-    return pixel_line;
+    stale[row_index] = true;
+    row_versions[row_index % TILE_HEIGHT_PX]++;
 }
 
-inline auto Tile::pixel_index(uint x, uint y) -> uint { return (y * TILE_HEIGHT_PX) + x; }
+void TileCache::decode(uint row_index) {
+    u8 pixels_1 = video_ram[row_index * 2];
+    u8 pixels_2 = video_ram[row_index * 2 + 1];
+
+    u64 pixels = bitplane_table[pixels_1] | (bitplane_table[pixels_2] << 1);
+    std::memcpy(rows[row_index].data(), &pixels, sizeof(pixels));
+
+    stale[row_index] = false;
+}
@@ -2,7 +2,6 @@
 
 #include "../address.h"
 #include "../definitions.h"
-#include "../mmu.h"
 
 #include <array>
 
@@ -20,16 +19,40 @@ const Address TILE_MAP_ONE_ADDRESS = 0x9C00;
 const uint TILE_BYTES = 2 * 8;
 
 const uint SPRITE_BYTES = 4;
+const uint SPRITE_COUNT = 40;
 
-class Tile {
+/* Sprites beyond the first 10 (in OAM order) on a line aren't drawn */
+const uint MAX_SPRITES_PER_LINE = 10;
+
+/* Tiles at 0x8000-0x97FF, counting from 0x8000. The second tile set's
+ * signed IDs map onto 128-383 */
+const uint TILE_COUNT = 384;
+
+/*
+ * Every tile in VRAM, decoded from bitplanes into one colour index (0-3) per
+ * pixel. Rows are decoded when first needed after VRAM was written, so the
+ * renderer can read them directly however often a tile is drawn.
+ */
+class TileCache {
 public:
-    Tile(Address& address, MMU& mmu, uint size_multiplier = 1);
+    TileCache(const u8* inVideoRam);
+
+    /* The 8 colour indices of row `y` of `tile` */
+    auto row(uint tile, uint y) -> const u8*;
 
-    auto get_pixel(uint x, uint y) const -> GBColor;
+    /* VRAM at `offset` (from 0x8000) was written */
+    void invalidate(uint offset);
+
+    /* Counts writes to row `y` of any tile, so that the renderer can tell
+     * whether a line it drew before could look any different */
+    auto row_version(uint y) const -> u32 { return row_versions[y]; }
 
 private:
-    static auto pixel_index(uint x, uint y) -> uint;
-    static auto get_pixel_line(u8 byte1, u8 byte2) -> std::vector<u8>;
+    void decode(uint row_index);
+
+    const u8* video_ram;
 
-    std::array<GBColor, TILE_HEIGHT_PX * 2 * TILE_WIDTH_PX> buffer;
+    std::array<std::array<u8, TILE_WIDTH_PX>, TILE_COUNT * TILE_HEIGHT_PX> rows;
+    std::array<bool, TILE_COUNT * TILE_HEIGHT_PX> stale;
+    std::array<u32, TILE_HEIGHT_PX> row_versions = {};
 };
@@ -1,20 +1,30 @@
 #include "video.h"
 
-#include "color.h"
 #include "../gameboy.h"
 #include "../cpu/cpu.h"
 
 #include "../util/bitwise.h"
 #include "../util/log.h"
 
-using bitwise::check_bit;
+#include <algorithm>
 
 Video::Video(Gameboy& inGb, Options& inOptions) :
     gb(inGb),
-    buffer(GAMEBOY_WIDTH, GAMEBOY_HEIGHT),
-    background_map(BG_MAP_SIZE, BG_MAP_SIZE)
+    options(inOptions),
+    background_map(BG_MAP_SIZE, BG_MAP_SIZE),
+    video_ram(0x4000),
+    oam_ram(0xA0)
 {
-    video_ram = std::vector<u8>(0x4000);
+    if (options.render_thread) {
+        render_thread = std::make_unique<RenderThread>();
+    } else {
+        renderer = std::make_unique<Renderer>();
+    }
+
+    rendering_frame = should_render_frame();
+
+    next_mode_time = CLOCKS_PER_SCANLINE_OAM;
+    reschedule();
 }
 
 u8 Video::read(const Address& address) {
@@ -22,370 +32,284 @@ u8 Video::read(const Address& address) {
 }
 
 void Video::write(const Address& address, u8 value) {
-    video_ram.at(address.value()) = value;
-}
-
-void Video::tick(Cycles cycles) {
-    cycle_counter += cycles.cycles;
-
-    switch (current_mode) {
-        case VideoMode::ACCESS_OAM:
-            if (cycle_counter >= CLOCKS_PER_SCANLINE_OAM) {
-                cycle_counter = cycle_counter % CLOCKS_PER_SCANLINE_OAM;
-                lcd_status.set_bit_to(1, true);
-                lcd_status.set_bit_to(0, true);
-                current_mode = VideoMode::ACCESS_VRAM;
-            }
-            break;
-        case VideoMode::ACCESS_VRAM:
-            if (cycle_counter >= CLOCKS_PER_SCANLINE_VRAM) {
-                cycle_counter = cycle_counter % CLOCKS_PER_SCANLINE_VRAM;
-                current_mode = VideoMode::HBLANK;
-
-                bool hblank_interrupt = bitwise::check_bit(lcd_status.value(), 3);
+    catch_up();
 
-                if (hblank_interrupt) {
-                    gb.cpu.interrupt_flag.set_bit_to(1, true);
-                }
+    u8& byte = video_ram.at(address.value());
+    if (byte == value) { return; }
 
-                bool ly_coincidence_interrupt = bitwise::check_bit(lcd_status.value(), 6);
-                bool ly_coincidence = ly_compare.value() == line.value();
-                if (ly_coincidence_interrupt && ly_coincidence) {
-                    gb.cpu.interrupt_flag.set_bit_to(1, true);
-                }
-                lcd_status.set_bit_to(2, ly_coincidence);
+    byte = value;
 
-                lcd_status.set_bit_to(1, false);
-                lcd_status.set_bit_to(0, false);
-            }
-            break;
-        case VideoMode::HBLANK:
-            if (cycle_counter >= CLOCKS_PER_HBLANK) {
-
-                write_scanline(line.value());
-                line.increment();
-
-                cycle_counter = cycle_counter % CLOCKS_PER_HBLANK;
-
-                /* Line 145 (index 144) is the first line of VBLANK */
-                if (line == 144) {
-                    current_mode = VideoMode::VBLANK;
-                    lcd_status.set_bit_to(1, false);
-                    lcd_status.set_bit_to(0, true);
-                    gb.cpu.interrupt_flag.set_bit_to(0, true);
-                } else {
-                    lcd_status.set_bit_to(1, true);
-                    lcd_status.set_bit_to(0, false);
-                    current_mode = VideoMode::ACCESS_OAM;
-                }
-            }
-            break;
-        case VideoMode::VBLANK:
-            if (cycle_counter >= CLOCKS_PER_SCANLINE) {
-                line.increment();
-
-                cycle_counter = cycle_counter % CLOCKS_PER_SCANLINE;
-
-                /* Line 155 (index 154) is the last line */
-                if (line == 154) {
-                    write_sprites();
-                    draw();
-                    buffer.reset();
-                    line.reset();
-                    current_mode = VideoMode::ACCESS_OAM;
-                    lcd_status.set_bit_to(1, true);
-                    lcd_status.set_bit_to(0, false);
-                };
-            }
-            break;
+    if (render_thread) {
+        render_thread->write_vram(address.value(), value);
+    } else {
+        renderer->write_vram(address.value(), value);
     }
 }
 
-auto Video::display_enabled() const -> bool { return check_bit(control_byte, 7); }
-auto Video::window_tile_map() const -> bool { return check_bit(control_byte, 6); }
-auto Video::window_enabled() const -> bool { return check_bit(control_byte, 5); }
-auto Video::bg_window_tile_data() const -> bool { return check_bit(control_byte, 4); }
-auto Video::bg_tile_map_display() const -> bool { return check_bit(control_byte, 3); }
-auto Video::sprite_size() const -> bool { return check_bit(control_byte, 2); }
-auto Video::sprites_enabled() const -> bool { return check_bit(control_byte, 1); }
-auto Video::bg_enabled() const -> bool { return check_bit(control_byte, 0); }
+auto Video::video_ram_data() const -> const u8* { return video_ram.data(); }
 
-void Video::write_scanline(u8 current_line) {
-    if (!display_enabled()) { return; }
+u8 Video::read_oam(const Address& address) const {
+    return oam_ram.at(address.value());
+}
 
-    if (bg_enabled() && !debug_disable_background) {
-        draw_bg_line(current_line);
-    }
+void Video::write_oam(const Address& address, u8 value) {
+    catch_up();
 
-    if (window_enabled() && !debug_disable_window) {
-        draw_window_line(current_line);
-    }
-}
+    /* Games usually copy all of OAM every frame, whether or not it changed */
+    u8& byte = oam_ram.at(address.value());
+    if (byte == value) { return; }
 
-void Video::write_sprites() {
-    if (!sprites_enabled() || debug_disable_sprites) { return; }
+    byte = value;
 
-    for (uint sprite_n = 0; sprite_n < 40; sprite_n++) {
-        draw_sprite(sprite_n);
+    if (render_thread) {
+        render_thread->write_oam(address.value(), value);
+    } else {
+        renderer->write_oam(address.value(), value);
     }
 }
 
-void Video::draw_bg_line(uint current_line) {
-    /* Note: tileset two uses signed numbering to share half the tiles with tileset 1 */
-    bool use_tile_set_zero = bg_window_tile_data();
-    bool use_tile_map_zero = !bg_tile_map_display();
-
-    Palette palette = load_palette(bg_palette);
-
-    Address tile_set_address = use_tile_set_zero
-        ? TILE_SET_ZERO_ADDRESS
-        : TILE_SET_ONE_ADDRESS;
-
-    Address tile_map_address = use_tile_map_zero
-        ? TILE_MAP_ZERO_ADDRESS
-        : TILE_MAP_ONE_ADDRESS;
-
-    /* The pixel row we're drawing on the screen is constant since we're only
-     * drawing a single line */
-    uint screen_y = current_line;
-
-    for (uint screen_x = 0; screen_x < GAMEBOY_WIDTH; screen_x++) {
-        /* Work out the position of the pixel in the framebuffer */
-        uint scrolled_x = screen_x + scroll_x.value();
-        uint scrolled_y = screen_y + scroll_y.value();
-
-        /* Work out the index of the pixel in the full background map */
-        uint bg_map_x = scrolled_x % BG_MAP_SIZE;
-        uint by_map_y = scrolled_y % BG_MAP_SIZE;
-
-        /* Work out which tile of the bg_map this pixel is in, and the index of that tile
-         * in the array of all tiles */
-        uint tile_x = bg_map_x / TILE_WIDTH_PX;
-        uint tile_y = by_map_y / TILE_HEIGHT_PX;
-
-        /* Work out which specific (x,y) inside that tile we're going to render */
-        uint tile_pixel_x = bg_map_x % TILE_WIDTH_PX;
-        uint tile_pixel_y = by_map_y % TILE_HEIGHT_PX;
-
-        /* Work out the address of the tile ID from the tile map */
-        uint tile_index = tile_y * TILES_PER_LINE + tile_x;
-        Address tile_id_address = tile_map_address + tile_index;
-
-        /* Grab the ID of the tile we'll get data from in the tile map */
-        u8 tile_id = gb.mmu.read(tile_id_address);
-
-        /* Calculate the offset from the start of the tile data memory where
-         * the data for our tile lives */
-        uint tile_data_mem_offset = use_tile_set_zero
-            ? tile_id * TILE_BYTES
-            : (static_cast<s8>(tile_id) + 128) * TILE_BYTES;
-
-        /* Calculate the extra offset to the data for the line of pixels we
-         * are rendering from.
-         * 2 (bytes per line of pixels) * y (lines) */
-        uint tile_data_line_offset = tile_pixel_y * 2;
-
-        Address tile_line_data_start_address = tile_set_address + tile_data_mem_offset + tile_data_line_offset;
+void Video::save_state(VideoState& state) const {
+    state.control_byte = control_byte;
+
+    state.lcd_control = lcd_control.value();
+    state.lcd_status = lcd_status.value();
+    state.scroll_y = scroll_y.value();
+    state.scroll_x = scroll_x.value();
+    state.line = line.value();
+    state.ly_compare = ly_compare.value();
+    state.window_y = window_y.value();
+    state.window_x = window_x.value();
+    state.bg_palette = bg_palette.value();
+    state.sprite_palette_0 = sprite_palette_0.value();
+    state.sprite_palette_1 = sprite_palette_1.value();
+    state.dma_transfer = dma_transfer.value();
+
+    state.current_mode = current_mode;
+    state.next_mode_time = next_mode_time;
+    state.mode_change_count = mode_change_count;
+    state.frame_count = frame_count;
+    state.rendering_frame = rendering_frame;
+
+    std::copy(video_ram.begin(), video_ram.begin() + state.video_ram.size(), state.video_ram.begin());
+    std::copy(oam_ram.begin(), oam_ram.end(), state.oam.begin());
+}
 
-        /* FIXME: We fetch the full line of pixels for each pixel in the tile
-         * we render. This could be altered to work in a way that avoids re-fetching
-         * for a more performant renderer */
-        u8 pixels_1 = gb.mmu.read(tile_line_data_start_address);
-        u8 pixels_2 = gb.mmu.read(tile_line_data_start_address + 1);
+void Video::load_state(const VideoState& state) {
+    control_byte = state.control_byte;
+
+    lcd_control.set(state.lcd_control);
+    lcd_status.set(state.lcd_status);
+    scroll_y.set(state.scroll_y);
+    scroll_x.set(state.scroll_x);
+    line.set(state.line);
+    ly_compare.set(state.ly_compare);
+    window_y.set(state.window_y);
+    window_x.set(state.window_x);
+    bg_palette.set(state.bg_palette);
+    sprite_palette_0.set(state.sprite_palette_0);
+    sprite_palette_1.set(state.sprite_palette_1);
+    dma_transfer.set(state.dma_transfer);
+
+    current_mode = state.current_mode;
+    next_mode_time = state.next_mode_time;
+    mode_change_count = state.mode_change_count;
+    frame_count = state.frame_count;
+    rendering_frame = state.rendering_frame;
+
+    /* The renderer keeps its own copies of VRAM and OAM, so pass on whatever
+     * differs as if it had been written */
+    for (uint offset = 0; offset < state.video_ram.size(); offset++) {
+        u8 value = state.video_ram[offset];
+        if (video_ram[offset] == value) { continue; }
+
+        video_ram[offset] = value;
+        if (render_thread) {
+            render_thread->write_vram(offset, value);
+        } else {
+            renderer->write_vram(offset, value);
+        }
+    }
 
-        GBColor pixel_color = get_pixel_from_line(pixels_1, pixels_2, tile_pixel_x);
-        Color screen_color = get_color_from_palette(pixel_color, palette);
+    for (uint offset = 0; offset < state.oam.size(); offset++) {
+        u8 value = state.oam[offset];
+        if (oam_ram[offset] == value) { continue; }
 
-        buffer.set_pixel(screen_x, screen_y, screen_color);
+        oam_ram[offset] = value;
+        if (render_thread) {
+            render_thread->write_oam(offset, value);
+        } else {
+            renderer->write_oam(offset, value);
+        }
     }
 }
 
-void Video::draw_window_line(uint current_line) {
-    /* Note: tileset two uses signed numbering to share half the tiles with tileset 1 */
-    bool use_tile_set_zero = bg_window_tile_data();
-    bool use_tile_map_zero = !window_tile_map();
-
-    Palette palette = load_palette(bg_palette);
-
-    Address tile_set_address = use_tile_set_zero
-        ? TILE_SET_ZERO_ADDRESS
-        : TILE_SET_ONE_ADDRESS;
-
-    Address tile_map_address = use_tile_map_zero
-        ? TILE_MAP_ZERO_ADDRESS
-        : TILE_MAP_ONE_ADDRESS;
-
-    uint screen_y = current_line;
-    uint scrolled_y = screen_y - window_y.value();
-
-    if (scrolled_y >= GAMEBOY_HEIGHT) { return; }
-    // if (!is_on_screen_y(scrolled_y)) { return; }
-
-    for (uint screen_x = 0; screen_x < GAMEBOY_WIDTH; screen_x++) {
-        /* Work out the position of the pixel in the framebuffer */
-        uint scrolled_x = screen_x + window_x.value() - 7;
-
-        /* Work out which tile of the bg_map this pixel is in, and the index of that tile
-         * in the array of all tiles */
-        uint tile_x = scrolled_x / TILE_WIDTH_PX;
-        uint tile_y = scrolled_y / TILE_HEIGHT_PX;
-
-        /* Work out which specific (x,y) inside that tile we're going to render */
-        uint tile_pixel_x = scrolled_x % TILE_WIDTH_PX;
-        uint tile_pixel_y = scrolled_y % TILE_HEIGHT_PX;
-
-        /* Work out the address of the tile ID from the tile map */
-        uint tile_index = tile_y * TILES_PER_LINE + tile_x;
-        Address tile_id_address = tile_map_address + tile_index;
-
-        /* Grab the ID of the tile we'll get data from in the tile map */
-        u8 tile_id = gb.mmu.read(tile_id_address);
-
-        /* Calculate the offset from the start of the tile data memory where
-         * the data for our tile lives */
-        uint tile_data_mem_offset = use_tile_set_zero
-            ? tile_id * TILE_BYTES
-            : (static_cast<s8>(tile_id) + 128) * TILE_BYTES;
-
-        /* Calculate the extra offset to the data for the line of pixels we
-         * are rendering from.
-         * 2 (bytes per line of pixels) * y (lines) */
-        uint tile_data_line_offset = tile_pixel_y * 2;
-
-        Address tile_line_data_start_address = tile_set_address + tile_data_mem_offset + tile_data_line_offset;
-
-        /* FIXME: We fetch the full line of pixels for each pixel in the tile
-         * we render. This could be altered to work in a way that avoids re-fetching
-         * for a more performant renderer */
-        u8 pixels_1 = gb.mmu.read(tile_line_data_start_address);
-        u8 pixels_2 = gb.mmu.read(tile_line_data_start_address + 1);
+void Video::handle_mode_event() {
+    catch_up();
+    reschedule();
+}
 
-        GBColor pixel_color = get_pixel_from_line(pixels_1, pixels_2, tile_pixel_x);
-        Color screen_color = get_color_from_palette(pixel_color, palette);
+void Video::catch_up() {
+    u64 now = gb.scheduler.now();
 
-        buffer.set_pixel(screen_x, screen_y, screen_color);
+    /* Each mode is timed from when the last one was due rather than from
+     * now, as the PPU is usually caught up some time after it changed mode */
+    while (next_mode_time <= now) {
+        next_mode_time += advance_mode();
+        mode_change_count++;
     }
 }
 
-void Video::draw_sprite(const uint sprite_n) {
-    using bitwise::check_bit;
-
-    /* Each sprite is represented by 4 bytes, or 8 bytes in 8x16 mode */
-    Address offset_in_oam = sprite_n * SPRITE_BYTES;
-
-    Address oam_start = 0xFE00 + offset_in_oam.value();
-    u8 sprite_y = gb.mmu.read(oam_start);
-    u8 sprite_x = gb.mmu.read(oam_start + 1);
-
-    /* If the sprite would be drawn offscreen, don't draw it */
-    if (sprite_y == 0 || sprite_y >= 160) { return; }
-    if (sprite_x == 0 || sprite_x >= 168) { return; }
-
-    uint sprite_size_multiplier = sprite_size()
-        ? 2 : 1;
+void Video::reschedule() {
+    gb.scheduler.schedule(Event::VideoMode, next_event_time());
+}
 
-    /* Sprites are always taken from the first tileset */
-    Address tile_set_location = TILE_SET_ZERO_ADDRESS;
+auto Video::mode_end_offset() const -> u64 {
+    u64 line_start = line.value() * CLOCKS_PER_SCANLINE;
 
-    u8 pattern_n = gb.mmu.read(oam_start + 2);
-    u8 sprite_attrs = gb.mmu.read(oam_start + 3);
+    switch (current_mode) {
+        case VideoMode::ACCESS_OAM: return line_start + CLOCKS_PER_SCANLINE_OAM;
+        case VideoMode::ACCESS_VRAM: return line_start + CLOCKS_PER_SCANLINE_OAM + CLOCKS_PER_SCANLINE_VRAM;
+        case VideoMode::HBLANK: return line_start + CLOCKS_PER_SCANLINE;
+        case VideoMode::VBLANK: return line_start + CLOCKS_PER_SCANLINE;
+    }
 
-    /* Bits 0-3 are used only for CGB */
-    bool use_palette_1 = check_bit(sprite_attrs, 4);
-    bool flip_x = check_bit(sprite_attrs, 5);
-    bool flip_y = check_bit(sprite_attrs, 6);
-    bool obj_behind_bg = check_bit(sprite_attrs, 7);
+    return line_start;
+}
 
-    Palette palette = use_palette_1
-        ? load_palette(sprite_palette_1)
-        : load_palette(sprite_palette_0);
+auto Video::next_event_time() const -> u64 {
+    /* Mode changes happen at fixed points in the frame, so work out where the
+     * next one falls and look for the first point after it which matters */
+    const u64 frame_length = FRAME_END_LINE * CLOCKS_PER_SCANLINE;
+    const u64 hblank_offset = CLOCKS_PER_SCANLINE_OAM + CLOCKS_PER_SCANLINE_VRAM;
+    const u64 current = mode_end_offset();
 
-    uint tile_offset = pattern_n * TILE_BYTES;
+    /* The end of the frame, which delivers it to the frontend */
+    u64 next = frame_length;
 
-    Address pattern_address = tile_set_location + tile_offset;
+    /* VBLANK starts at the end of the last visible line */
+    u64 vblank_start = SCANLINES_PER_FRAME * CLOCKS_PER_SCANLINE;
+    if (vblank_start >= current) { next = std::min(next, vblank_start); }
 
-    Tile tile(pattern_address, gb.mmu, sprite_size_multiplier);
-    int start_y = sprite_y - 16;
-    int start_x = sprite_x - 8;
+    bool hblank_interrupt = bitwise::check_bit(lcd_status.value(), 3);
+    if (hblank_interrupt) {
+        u64 next_line = current <= hblank_offset
+            ? 0
+            : (current - hblank_offset + CLOCKS_PER_SCANLINE - 1) / CLOCKS_PER_SCANLINE;
 
-    for (uint y = 0; y < TILE_HEIGHT_PX * sprite_size_multiplier; y++) {
-        for (uint x = 0; x < TILE_WIDTH_PX; x++) {
-            uint maybe_flipped_y = !flip_y ? y : (TILE_HEIGHT_PX * sprite_size_multiplier) - y - 1;
-            uint maybe_flipped_x = !flip_x ? x : TILE_WIDTH_PX - x - 1;
+        if (next_line < SCANLINES_PER_FRAME) {
+            next = std::min(next, next_line * CLOCKS_PER_SCANLINE + hblank_offset);
+        }
+    }
 
-            GBColor gb_color = tile.get_pixel(maybe_flipped_x, maybe_flipped_y);
+    bool ly_coincidence_interrupt = bitwise::check_bit(lcd_status.value(), 6);
+    if (ly_coincidence_interrupt && ly_compare.value() < SCANLINES_PER_FRAME) {
+        u64 coincidence = ly_compare.value() * CLOCKS_PER_SCANLINE + hblank_offset;
+        if (coincidence >= current) { next = std::min(next, coincidence); }
+    }
 
-            // Color 0 is transparent
-            if (gb_color == GBColor::Color0) { continue; }
+    return next_mode_time + (next - current);
+}
 
-            int screen_x = start_x + x;
-            int screen_y = start_y + y;
+auto Video::advance_mode() -> uint {
+    switch (current_mode) {
+        case VideoMode::ACCESS_OAM:
+            lcd_status.set_bit_to(1, true);
+            lcd_status.set_bit_to(0, true);
+            current_mode = VideoMode::ACCESS_VRAM;
+            return CLOCKS_PER_SCANLINE_VRAM;
 
-            if (!is_on_screen(screen_x, screen_y)) { continue; }
+        case VideoMode::ACCESS_VRAM: {
+            current_mode = VideoMode::HBLANK;
 
-            auto existing_pixel = buffer.get_pixel(screen_x, screen_y);
+            bool hblank_interrupt = bitwise::check_bit(lcd_status.value(), 3);
 
-            // FIXME: We need to see if the color we're writing over is
-            // logically Color0, rather than looking at the color after
-            // the current palette has been applied
-            if (obj_behind_bg && existing_pixel != Color::White) { continue; }
+            if (hblank_interrupt) {
+                gb.cpu.interrupt_flag.set_bit_to(1, true);
+            }
 
-            Color screen_color = get_color_from_palette(gb_color, palette);
+            bool ly_coincidence_interrupt = bitwise::check_bit(lcd_status.value(), 6);
+            bool ly_coincidence = ly_compare.value() == line.value();
+            if (ly_coincidence_interrupt && ly_coincidence) {
+                gb.cpu.interrupt_flag.set_bit_to(1, true);
+            }
+            lcd_status.set_bit_to(2, ly_coincidence);
 
-            buffer.set_pixel(screen_x, screen_y, screen_color);
+            lcd_status.set_bit_to(1, false);
+            lcd_status.set_bit_to(0, false);
+            return CLOCKS_PER_HBLANK;
         }
-    }
-}
 
-auto Video::get_pixel_from_line(u8 byte1, u8 byte2, u8 pixel_index) -> GBColor {
-    using bitwise::bit_value;
-
-    u8 color_u8 = static_cast<u8>((bit_value(byte2, 7-pixel_index) << 1) | bit_value(byte1, 7-pixel_index));
-    return get_color(color_u8);
-}
+        case VideoMode::HBLANK:
+            write_scanline(line.value());
+            line.increment();
 
-auto Video::is_on_screen_x(u8 x) -> bool { return x < GAMEBOY_WIDTH; }
+            /* Line 145 (index 144) is the first line of VBLANK */
+            if (line == 144) {
+                current_mode = VideoMode::VBLANK;
+                lcd_status.set_bit_to(1, false);
+                lcd_status.set_bit_to(0, true);
+                gb.cpu.interrupt_flag.set_bit_to(0, true);
+                return CLOCKS_PER_SCANLINE;
+            }
 
-auto Video::is_on_screen_y(u8 y) -> bool { return y < GAMEBOY_HEIGHT; }
+            lcd_status.set_bit_to(1, true);
+            lcd_status.set_bit_to(0, false);
+            current_mode = VideoMode::ACCESS_OAM;
+            return CLOCKS_PER_SCANLINE_OAM;
 
-auto Video::is_on_screen(u8 x, u8 y) -> bool { return is_on_screen_x(x) && is_on_screen_y(y); }
+        case VideoMode::VBLANK:
+            line.increment();
 
-auto Video::load_palette(ByteRegister& palette_register) -> Palette {
-    using bitwise::compose_bits;
-    using bitwise::bit_value;
+            /* Line 155 (index 154) is the last line */
+            if (line == FRAME_END_LINE) {
+                if (rendering_frame) { draw(); }
 
-    /* TODO: Reduce duplication */
-    u8 color0 = compose_bits(bit_value(palette_register.value(), 1), bit_value(palette_register.value(), 0));
-    u8 color1 = compose_bits(bit_value(palette_register.value(), 3), bit_value(palette_register.value(), 2));
-    u8 color2 = compose_bits(bit_value(palette_register.value(), 5), bit_value(palette_register.value(), 4));
-    u8 color3 = compose_bits(bit_value(palette_register.value(), 7), bit_value(palette_register.value(), 6));
+                frame_count++;
+                rendering_frame = should_render_frame();
 
-    Color real_color_0 = get_real_color(color0);
-    Color real_color_1 = get_real_color(color1);
-    Color real_color_2 = get_real_color(color2);
-    Color real_color_3 = get_real_color(color3);
+                line.reset();
+                current_mode = VideoMode::ACCESS_OAM;
+                lcd_status.set_bit_to(1, true);
+                lcd_status.set_bit_to(0, false);
+                return CLOCKS_PER_SCANLINE_OAM;
+            }
+            return CLOCKS_PER_SCANLINE;
+    }
 
-    return { real_color_0, real_color_1, real_color_2, real_color_3 };
+    return CLOCKS_PER_SCANLINE;
 }
 
-auto Video::get_color_from_palette(GBColor color, const Palette& palette) -> Color {
-    switch (color) {
-        case GBColor::Color0: return palette.color0;
-        case GBColor::Color1: return palette.color1;
-        case GBColor::Color2: return palette.color2;
-        case GBColor::Color3: return palette.color3;
-    }
+void Video::set_output_enabled(bool enabled) {
+    output_enabled = enabled;
+    rendering_frame = should_render_frame();
 }
 
+auto Video::should_render_frame() const -> bool {
+    if (options.disable_rendering || !output_enabled) { return false; }
+
+    return options.frame_skip <= 1 || frame_count % options.frame_skip == 0;
+}
 
-auto Video::get_real_color(u8 pixel_value) -> Color {
-    switch (pixel_value) {
-        case 0: return Color::White;
-        case 1: return Color::LightGray;
-        case 2: return Color::DarkGray;
-        case 3: return Color::Black;
-        default:
-            fatal_error("Invalid color value");
+void Video::write_scanline(u8 current_line) {
+    if (!rendering_frame) { return; }
+
+    LineRegisters registers;
+    registers.control = control_byte;
+    registers.scroll_x = scroll_x.value();
+    registers.scroll_y = scroll_y.value();
+    registers.window_x = window_x.value();
+    registers.window_y = window_y.value();
+    registers.bg_palette = bg_palette.value();
+    registers.sprite_palette_0 = sprite_palette_0.value();
+    registers.sprite_palette_1 = sprite_palette_1.value();
+    registers.disable_background = debug_disable_background;
+    registers.disable_sprites = debug_disable_sprites;
+    registers.disable_window = debug_disable_window;
+
+    if (render_thread) {
+        render_thread->draw_line(current_line, registers);
+    } else {
+        renderer->draw_line(current_line, registers);
     }
 }
 
@@ -394,5 +318,13 @@ void Video::register_vblank_callback(const vblank_callback_t& _vblank_callback)
 }
 
 void Video::draw() {
-    vblank_callback(buffer);
+    if (render_thread) {
+        render_thread->end_frame();
+
+        bool changed;
+        const FrameBuffer& frame = render_thread->latest_frame(changed);
+        vblank_callback(frame, changed);
+    } else {
+        vblank_callback(renderer->frame(), renderer->take_changed());
+    }
 }
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "framebuffer.h"
+#include "renderer.h"
+#include "render_thread.h"
 #include "tile.h"
 
 #include "../mmu.h"
@@ -8,13 +10,15 @@
 #include "../definitions.h"
 #include "../options.h"
 
+#include <array>
 #include <vector>
 #include <memory>
 #include <functional>
 
 class Gameboy;
 
-using vblank_callback_t = std::function<void(const FrameBuffer&)>;
+/* Called with each finished frame, and whether it differs from the last one */
+using vblank_callback_t = std::function<void(const FrameBuffer&, bool changed)>;
 
 enum class VideoMode {
     ACCESS_OAM,
@@ -23,21 +27,75 @@ enum class VideoMode {
     VBLANK,
 };
 
-struct TileInfo {
+/* Everything needed to restore the PPU (see save_state.h). The framebuffer
+ * isn't included, so the first frame after loading a state may be torn */
+struct VideoState {
+    u8 control_byte;
+
+    u8 lcd_control;
+    u8 lcd_status;
+    u8 scroll_y;
+    u8 scroll_x;
     u8 line;
-    std::vector<u8> pixels;
+    u8 ly_compare;
+    u8 window_y;
+    u8 window_x;
+    u8 bg_palette;
+    u8 sprite_palette_0;
+    u8 sprite_palette_1;
+    u8 dma_transfer;
+
+    VideoMode current_mode;
+    u64 next_mode_time;
+    u64 mode_change_count;
+    u64 frame_count;
+    bool rendering_frame;
+
+    std::array<u8, 0x2000> video_ram;
+    std::array<u8, 0xA0> oam;
 };
 
 class Video {
 public:
     Video(Gameboy& inGb, Options& inOptions);
 
-    void tick(Cycles cycles);
+    /* The PPU is run lazily: it only changes mode when it has to raise an
+     * interrupt or finish a frame, which is when its events are scheduled,
+     * or when something is about to look at or change its state */
+    void handle_mode_event();
+    void catch_up();
+
+    /* The STAT interrupt sources, LYC or LY changed, so the next mode change
+     * which matters may be at a different time */
+    void reschedule();
+
+    /* Until then, nothing the PPU shows the CPU changes */
+    auto next_mode_change() const -> u64 { return next_mode_time; }
+
+    /* How many mode changes have happened, whether or not they were events */
+    auto mode_changes() const -> u64 { return mode_change_count; }
+
+    /* Frames finished since power on */
+    auto frames() const -> u64 { return frame_count; }
+
+    /* Whether frames are drawn and handed to the vblank callback, as with
+     * Options::disable_rendering. Takes effect immediately, so should be
+     * changed between frames */
+    void set_output_enabled(bool enabled);
+
     void register_vblank_callback(const vblank_callback_t& _vblank_callback);
 
     u8 read(const Address& address);
     void write(const Address& address, u8 byte);
 
+    auto video_ram_data() const -> const u8*;
+
+    u8 read_oam(const Address& address) const;
+    void write_oam(const Address& address, u8 byte);
+
+    void save_state(VideoState& state) const;
+    void load_state(const VideoState& state);
+
     u8 control_byte;
 
     ByteRegister lcd_control;
@@ -67,42 +125,41 @@ public:
     bool debug_disable_window = false;
 
 private:
+    /* Moves on to the next mode, returning how long it lasts */
+    auto advance_mode() -> uint;
+
+    /* When the next mode change is due, counting from the start of the frame */
+    auto mode_end_offset() const -> u64;
+
+    /* The next mode change which must happen on time */
+    auto next_event_time() const -> u64;
+
+    /* Whether the frame which is starting should produce pixels, or only
+     * keep time (see Options::frame_skip) */
+    auto should_render_frame() const -> bool;
+
     void write_scanline(u8 current_line);
-    void write_sprites();
     void draw();
-    void draw_bg_line(uint current_line);
-    void draw_window_line(uint current_line);
-    void draw_sprite(uint sprite_n);
-    static auto get_pixel_from_line(u8 byte1, u8 byte2, u8 pixel_index) -> GBColor;
-
-    static auto is_on_screen(u8 x, u8 y) -> bool;
-    static auto is_on_screen_x(u8 x) -> bool;
-    static auto is_on_screen_y(u8 y) -> bool;
-
-    auto display_enabled() const -> bool;
-    auto window_tile_map() const -> bool;
-    auto window_enabled() const -> bool;
-    auto bg_window_tile_data() const -> bool;
-    auto bg_tile_map_display() const -> bool;
-    auto sprite_size() const -> bool;
-    auto sprites_enabled() const -> bool;
-    auto bg_enabled() const -> bool;
-
-    auto get_tile_info(Address tile_set_location, u8 tile_id, u8 tile_line) const -> TileInfo;
-
-    static auto get_real_color(u8 pixel_value) -> Color;
-    static auto load_palette(ByteRegister& palette_register) -> Palette;
-    static auto get_color_from_palette(GBColor color, const Palette& palette) -> Color;
 
     Gameboy& gb;
+    Options& options;
 
-    FrameBuffer buffer;
     FrameBuffer background_map;
 
     std::vector<u8> video_ram;
+    std::vector<u8> oam_ram;
+
+    /* Lines are drawn by one of these: directly, or on another thread */
+    std::unique_ptr<Renderer> renderer;
+    std::unique_ptr<RenderThread> render_thread;
 
     VideoMode current_mode = VideoMode::ACCESS_OAM;
-    uint cycle_counter = 0;
+    u64 next_mode_time = 0;
+    u64 mode_change_count = 0;
+
+    u64 frame_count = 0;
+    bool rendering_frame = true;
+    bool output_enabled = true;
 
     vblank_callback_t vblank_callback;
 };
@@ -115,4 +172,5 @@ const uint CLOCKS_PER_SCANLINE =
 
 const uint CLOCKS_PER_VBLANK = 4560; /* Mode 1 */
 const uint SCANLINES_PER_FRAME = 144;
+const uint FRAME_END_LINE = 154;
 const uint CLOCKS_PER_FRAME = (CLOCKS_PER_SCANLINE * SCANLINES_PER_FRAME) + CLOCKS_PER_VBLANK;